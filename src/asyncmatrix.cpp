@@ -0,0 +1,151 @@
+#include<mutex>
+#include<atomic>
+#include<string>
+#include<vector>
+#include<memory>
+#include<exception>
+#include"asyncmatrix.hpp"
+#include"parallel.hpp"
+
+/**
+ * @brief A node of the dependency graph. pending counts the inputs still being
+ * computed plus one held while the node is being linked, so the node is queued
+ * exactly once by whichever input finishes last
+ */
+struct AsyncNode {
+    /** Operation computing the result from the input results */
+    std::function<Matrix(std::vector<Matrix>&)> operation;
+    /** Nodes whose results are passed to the operation */
+    std::vector<std::shared_ptr<AsyncNode>> inputs;
+    /** Guards dependents against the node finishing while one is being linked */
+    std::mutex lock;
+    /** Nodes waiting on this one */
+    std::vector<std::shared_ptr<AsyncNode>> dependents;
+    /** Inputs not yet finished */
+    std::atomic<int> pending;
+    /** Whether result or error has been set */
+    std::atomic<bool> done;
+    /** Result of the operation once done */
+    std::shared_ptr<Matrix> result;
+    /** Error raised by the operation or one of its inputs */
+    std::exception_ptr error;
+};
+
+static void schedule(std::shared_ptr<AsyncNode> node);
+
+/**
+ * @brief Marks a node as done and queues every dependent that was only waiting on it
+ */
+static void finish(std::shared_ptr<AsyncNode> node) {
+    std::vector<std::shared_ptr<AsyncNode>> dependents;
+    {
+        std::lock_guard<std::mutex> guard(node->lock);
+        node->done = true;
+        dependents.swap(node->dependents);
+    }
+    for(int i = 0; i < dependents.size(); i++)
+        if(--dependents[i]->pending == 0) schedule(dependents[i]);
+}
+
+/**
+ * @brief Runs a node whose inputs are all done, passing on the first input error
+ */
+static void run(std::shared_ptr<AsyncNode> node) {
+    try {
+        std::vector<Matrix> values;
+        for(int i = 0; i < node->inputs.size(); i++) {
+            if(node->inputs[i]->error) std::rethrow_exception(node->inputs[i]->error);
+            values.push_back(*node->inputs[i]->result);
+        }
+        node->result = std::make_shared<Matrix>(node->operation(values));
+    } catch(...) {
+        node->error = std::current_exception();
+    }
+    // Let go of the inputs so intermediate results can be freed
+    node->operation = nullptr;
+    node->inputs.clear();
+    finish(node);
+}
+
+static void schedule(std::shared_ptr<AsyncNode> node) {
+    spawn([node]() { run(node); });
+}
+
+//////////////////////////////////////////
+//  Building the graph
+//////////////////////////////////////////
+
+AsyncMatrix::AsyncMatrix(std::shared_ptr<AsyncNode> existing) {
+    node = existing;
+}
+
+AsyncMatrix::AsyncMatrix(Matrix &matrix) {
+    // The node starts out done with a copy of the matrix
+    node = std::make_shared<AsyncNode>();
+    node->pending = 0;
+    node->done = true;
+    node->result = std::make_shared<Matrix>(matrix);
+}
+
+AsyncMatrix::AsyncMatrix(std::string filepath) {
+    // Loading is an operation without inputs
+    node = apply({}, [filepath](std::vector<Matrix> &) { return Matrix(filepath); }).node;
+}
+
+AsyncMatrix AsyncMatrix::apply(std::vector<AsyncMatrix> inputs, std::function<Matrix(std::vector<Matrix>&)> operation) {
+    std::shared_ptr<AsyncNode> created = std::make_shared<AsyncNode>();
+    created->operation = operation;
+    created->done = false;
+    created->pending = inputs.size() + 1;
+    // Link to every input that is still running, counting off those already done
+    for(int i = 0; i < inputs.size(); i++) {
+        std::shared_ptr<AsyncNode> input = inputs[i].node;
+        created->inputs.push_back(input);
+        std::lock_guard<std::mutex> guard(input->lock);
+        if(input->done) created->pending--;
+        else input->dependents.push_back(created);
+    }
+    // Drop the linking reference, queueing the node if nothing is left to wait on
+    if(--created->pending == 0) schedule(created);
+    return AsyncMatrix(created);
+}
+
+//////////////////////////////////////////
+//  Waiting on results
+//////////////////////////////////////////
+
+bool AsyncMatrix::ready() {
+    return node->done;
+}
+
+Matrix AsyncMatrix::get() {
+    // Keep the calling thread busy with queued work until the node finishes
+    std::shared_ptr<AsyncNode> waiting = node;
+    helpWhile([waiting]() { return !waiting->done; });
+    if(node->error) std::rethrow_exception(node->error);
+    return *node->result;
+}
+
+//////////////////////////////////////////
+//  Asynchronous operations
+//////////////////////////////////////////
+
+AsyncMatrix AsyncMatrix::operator*(AsyncMatrix other) {
+    return apply({*this, other}, [](std::vector<Matrix> &inputs) { return inputs[0] * inputs[1]; });
+}
+
+AsyncMatrix AsyncMatrix::operator*(double val) {
+    return apply({*this}, [val](std::vector<Matrix> &inputs) { return inputs[0] * val; });
+}
+
+AsyncMatrix AsyncMatrix::operator+(AsyncMatrix other) {
+    return apply({*this, other}, [](std::vector<Matrix> &inputs) { return inputs[0] + inputs[1]; });
+}
+
+AsyncMatrix AsyncMatrix::operator-(AsyncMatrix other) {
+    return apply({*this, other}, [](std::vector<Matrix> &inputs) { return inputs[0] - inputs[1]; });
+}
+
+AsyncMatrix AsyncMatrix::inverse() {
+    return apply({*this}, [](std::vector<Matrix> &inputs) { return inputs[0].inverse(); });
+}
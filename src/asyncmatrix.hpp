@@ -0,0 +1,112 @@
+#include<string>
+#include<vector>
+#include<memory>
+#include<functional>
+#include"matrix.hpp"
+#ifndef ASYNCMATRIX_HPP
+#define ASYNCMATRIX_HPP
+
+struct AsyncNode;
+
+/**
+ * @brief A handle to a Matrix that may still be being computed. Every operation
+ * on handles returns immediately with a new handle and records the operation as
+ * a node of a dependency graph; a node is queued on the shared work-stealing pool
+ * as soon as its inputs are ready, so independent subterms of an expression run
+ * concurrently. Kernels called by the operations use the same pool, so nested
+ * parallelism does not oversubscribe the machine. Errors are rethrown by get(),
+ * including by the handles of every operation depending on a failed one
+ *
+ */
+class AsyncMatrix {
+    private:
+    /** Node of the dependency graph holding the operation and its result */
+    std::shared_ptr<AsyncNode> node;
+
+    /**
+     * @brief Wraps an existing node of the graph
+     *
+     * @param existing node to wrap
+     */
+    AsyncMatrix(std::shared_ptr<AsyncNode> existing);
+
+    public:
+    /**
+     * @brief Constructs a handle that is already ready with a copy of a Matrix
+     *
+     * @param matrix matrix to copy
+     */
+    AsyncMatrix(Matrix &matrix);
+
+    /**
+     * @brief Constructs a handle that loads an mtx file in the background
+     *
+     * @param filepath filepath to the mtx file
+     */
+    AsyncMatrix(std::string filepath);
+
+    /**
+     * @brief Schedules an arbitrary operation once all of its inputs are ready
+     *
+     * @param inputs handles whose results are passed to the operation, in order
+     * @param operation function computing the result from the input matrices
+     * @return AsyncMatrix handle to the result
+     */
+    static AsyncMatrix apply(std::vector<AsyncMatrix> inputs, std::function<Matrix(std::vector<Matrix>&)> operation);
+
+    /**
+     * @brief Returns whether the result is available without waiting
+     *
+     * @return true if the operation and its inputs have finished
+     */
+    bool ready();
+
+    /**
+     * @brief Waits for the result, running other queued tasks on the calling thread
+     * in the meantime, and rethrows the error of the operation if it failed
+     *
+     * @return Matrix the computed matrix
+     */
+    Matrix get();
+
+    /**
+     * @brief Schedules a matrix product
+     *
+     * @param other right operand
+     * @return AsyncMatrix handle to the product
+     */
+    AsyncMatrix operator*(AsyncMatrix other);
+
+    /**
+     * @brief Schedules scaling by a constant
+     *
+     * @param val scalar value to multiply by
+     * @return AsyncMatrix handle to the scaled matrix
+     */
+    AsyncMatrix operator*(double val);
+
+    /**
+     * @brief Schedules a matrix sum
+     *
+     * @param other matrix being added with
+     * @return AsyncMatrix handle to the sum
+     */
+    AsyncMatrix operator+(AsyncMatrix other);
+
+    /**
+     * @brief Schedules a matrix difference
+     *
+     * @param other matrix being subtracted
+     * @return AsyncMatrix handle to the difference
+     */
+    AsyncMatrix operator-(AsyncMatrix other);
+
+    /**
+     * @brief Schedules a matrix inverse
+     *
+     * @return AsyncMatrix handle to the inverse
+     */
+    AsyncMatrix inverse();
+};
+
+#endif
@@ -0,0 +1,309 @@
+#include<mutex>
+#include<deque>
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<thread>
+#include<string>
+#include<vector>
+#include<fstream>
+#include<sstream>
+#include<exception>
+#include<condition_variable>
+#include"batchexecutor.hpp"
+#include"logger.hpp"
+#include"util.hpp"
+#include"parallel.hpp"
+
+// Threads per stage and queue capacity used unless set otherwise
+static const int DEFAULT_READERS = 2;
+static const int DEFAULT_WRITERS = 2;
+static const int DEFAULT_CAPACITY = 8;
+
+namespace {
+
+/**
+ * @brief A first in first out queue of fixed capacity whose push blocks while it
+ * is full and whose pop blocks while it is empty, until it is closed
+ */
+template<typename T>
+class BoundedQueue {
+    public:
+    BoundedQueue(int size) : capacity(size), open(true), maxDepth(0), depthSum(0), samples(0) {}
+
+    /**
+     * @brief Appends an item, returning the seconds spent waiting for room
+     */
+    double push(T item) {
+        std::unique_lock<std::mutex> guard(lock);
+        auto start = std::chrono::steady_clock::now();
+        notFull.wait(guard, [this]() { return items.size() < capacity; });
+        double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        items.push_back(std::move(item));
+        sample();
+        notEmpty.notify_one();
+        return waited;
+    }
+
+    /**
+     * @brief Removes the oldest item, returning false once the queue is closed and drained
+     */
+    bool pop(T &item, double &waited) {
+        std::unique_lock<std::mutex> guard(lock);
+        auto start = std::chrono::steady_clock::now();
+        notEmpty.wait(guard, [this]() { return !items.empty() || !open; });
+        waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        sample();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Wakes every consumer once the producers are done
+     */
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        open = false;
+        notEmpty.notify_all();
+    }
+
+    QueueStats stats() {
+        std::lock_guard<std::mutex> guard(lock);
+        QueueStats result;
+        result.capacity = capacity;
+        result.maxDepth = maxDepth;
+        result.averageDepth = samples > 0 ? depthSum / samples : 0;
+        return result;
+    }
+
+    private:
+    int capacity;
+    bool open;
+    std::deque<T> items;
+    std::mutex lock;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    int maxDepth;
+    double depthSum;
+    long long samples;
+
+    void sample() {
+        int depth = items.size();
+        if(depth > maxDepth) maxDepth = depth;
+        depthSum += depth;
+        samples++;
+    }
+};
+
+/**
+ * @brief A job travelling through the pipeline, carrying its inputs and then its result
+ */
+struct BatchItem {
+    int job;
+    std::vector<Matrix> values;
+};
+
+/**
+ * @brief Per thread counters merged into the stage totals when the thread exits
+ */
+struct StageClock {
+    int items = 0;
+    double busy = 0, starved = 0, blocked = 0;
+
+    void merge(StageStats &stage, std::mutex &lock) {
+        std::lock_guard<std::mutex> guard(lock);
+        stage.items += items;
+        stage.busySeconds += busy;
+        stage.starvedSeconds += starved;
+        stage.blockedSeconds += blocked;
+    }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+//////////////////////////////////////////
+//  Reading manifests
+//////////////////////////////////////////
+
+BatchExecutor::BatchExecutor(std::string manifest) {
+    // Log the creation of the executor with its manifest identifier
+    Logger::getInstance()->log("Creating a BatchExecutor from the manifest: " + manifest);
+    fp = manifest;
+    readers = DEFAULT_READERS;
+    workers = getThreadCount();
+    writers = DEFAULT_WRITERS;
+    capacity = DEFAULT_CAPACITY;
+    // Built in operations
+    registerOperation("copy", 1, [](std::vector<Matrix> &in) { return in[0]; });
+    registerOperation("negate", 1, [](std::vector<Matrix> &in) { return -in[0]; });
+    registerOperation("inverse", 1, [](std::vector<Matrix> &in) { return in[0].inverse(); });
+    registerOperation("multiply", 2, [](std::vector<Matrix> &in) { return in[0] * in[1]; });
+    registerOperation("add", 2, [](std::vector<Matrix> &in) { return in[0] + in[1]; });
+    registerOperation("subtract", 2, [](std::vector<Matrix> &in) { return in[0] - in[1]; });
+    registerOperation("leastsquares", 2, [](std::vector<Matrix> &in) { return in[0].leastSquares(in[1]); });
+    // Split each non empty line on the delimiter, which needs an operation, an input and an output
+    std::ifstream file(fp);
+    if(!file) Logger::logInvalidManifest(fp, 0);
+    std::string line;
+    for(int number = 1; std::getline(file, line); number++) {
+        if(line.empty()) continue;
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while(std::getline(stream, field, ':')) fields.push_back(field);
+        if(fields.size() < 3) Logger::logInvalidManifest(fp, number);
+        lines.push_back(number);
+        operations.push_back(fields[0]);
+        inputs.push_back(std::vector<std::string>(fields.begin() + 1, fields.end() - 1));
+        // Outputs are written like save(), which adds the extension itself
+        std::string output = fields.back();
+        if(endsWith(output, ".mtx")) output = output.substr(0, output.size() - 4);
+        outputs.push_back(output);
+    }
+}
+
+void BatchExecutor::registerOperation(std::string name, int arity, std::function<Matrix(std::vector<Matrix>&)> operation) {
+    arities[name] = arity;
+    functions[name] = operation;
+}
+
+void BatchExecutor::setThreads(int readerThreads, int workerThreads, int writerThreads) {
+    readers = std::max(1, readerThreads);
+    workers = std::max(1, workerThreads);
+    writers = std::max(1, writerThreads);
+}
+
+void BatchExecutor::setQueueCapacity(int jobs) {
+    capacity = std::max(1, jobs);
+}
+
+int BatchExecutor::size() {
+    return lines.size();
+}
+
+//////////////////////////////////////////
+//  Running the pipeline
+//////////////////////////////////////////
+
+BatchReport BatchExecutor::run() {
+    // Every job must name a known operation with the right number of inputs
+    for(int i = 0; i < lines.size(); i++)
+        if(!arities.count(operations[i]) || arities[operations[i]] != inputs[i].size()) Logger::logInvalidManifest(fp, lines[i]);
+    BatchReport report;
+    report.completed = 0;
+    int counts[3] = {readers, workers, writers};
+    for(int s = 0; s < 3; s++) {
+        report.stages[s].threads = counts[s];
+        report.stages[s].items = 0;
+        report.stages[s].busySeconds = report.stages[s].starvedSeconds = report.stages[s].blockedSeconds = 0;
+    }
+    BoundedQueue<BatchItem> loaded(capacity), computed(capacity);
+    std::mutex lock;
+    std::atomic<int> next(0), activeReaders(readers), activeWorkers(workers);
+    auto fail = [&](int job, std::string message) {
+        std::lock_guard<std::mutex> guard(lock);
+        report.failures.push_back(std::make_pair(lines[job], message));
+    };
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    // Readers claim jobs in manifest order and load their inputs
+    for(int t = 0; t < readers; t++)
+        threads.push_back(std::thread([&]() {
+            StageClock clock;
+            for(int job = next++; job < lines.size(); job = next++) {
+                auto begin = std::chrono::steady_clock::now();
+                BatchItem item;
+                item.job = job;
+                try {
+                    for(int i = 0; i < inputs[job].size(); i++) item.values.push_back(Matrix(inputs[job][i]));
+                } catch(std::exception &error) {
+                    fail(job, error.what());
+                    continue;
+                }
+                clock.busy += secondsSince(begin);
+                clock.blocked += loaded.push(std::move(item));
+                clock.items++;
+            }
+            clock.merge(report.stages[0], lock);
+            if(--activeReaders == 0) loaded.close();
+        }));
+    // Workers compute each job from its inputs
+    for(int t = 0; t < workers; t++)
+        threads.push_back(std::thread([&]() {
+            StageClock clock;
+            BatchItem item;
+            double waited;
+            while(loaded.pop(item, waited)) {
+                clock.starved += waited;
+                auto begin = std::chrono::steady_clock::now();
+                try {
+                    Matrix result = functions.at(operations[item.job])(item.values);
+                    item.values.clear();
+                    item.values.push_back(result);
+                } catch(std::exception &error) {
+                    fail(item.job, error.what());
+                    continue;
+                }
+                clock.busy += secondsSince(begin);
+                clock.blocked += computed.push(std::move(item));
+                clock.items++;
+            }
+            clock.starved += waited;
+            clock.merge(report.stages[1], lock);
+            if(--activeWorkers == 0) computed.close();
+        }));
+    // Writers save each result
+    for(int t = 0; t < writers; t++)
+        threads.push_back(std::thread([&]() {
+            StageClock clock;
+            BatchItem item;
+            double waited;
+            while(computed.pop(item, waited)) {
+                clock.starved += waited;
+                auto begin = std::chrono::steady_clock::now();
+                try {
+                    item.values[0].save(outputs[item.job]);
+                } catch(std::exception &error) {
+                    fail(item.job, error.what());
+                    continue;
+                }
+                clock.busy += secondsSince(begin);
+                clock.items++;
+            }
+            clock.starved += waited;
+            clock.merge(report.stages[2], lock);
+        }));
+    for(int t = 0; t < threads.size(); t++) threads[t].join();
+    report.seconds = secondsSince(start);
+    report.completed = report.stages[2].items;
+    for(int s = 0; s < 3; s++) report.stages[s].throughput = report.seconds > 0 ? report.stages[s].items / report.seconds : 0;
+    report.queues[0] = loaded.stats();
+    report.queues[1] = computed.stats();
+    Logger::getInstance()->log("Finished the batch manifest: " + fp + "\n" + report.display());
+    return report;
+}
+
+std::string BatchReport::display() {
+    // One row per stage followed by one row per queue
+    const char *names[3] = {"read", "compute", "write"};
+    std::string result = "stage   threads   items  jobs/s  busy(s)  starved(s)  blocked(s)\n";
+    for(int s = 0; s < 3; s++) {
+        result.append(std::string(names[s]) + std::string(8 - std::string(names[s]).size(), ' '));
+        result.append(formatDouble(stages[s].threads, 7) + formatDouble(stages[s].items, 8) + formatDouble(stages[s].throughput, 8));
+        result.append(formatDouble(stages[s].busySeconds, 9) + formatDouble(stages[s].starvedSeconds, 12) + formatDouble(stages[s].blockedSeconds, 12) + "\n");
+    }
+    result.append("queue     capacity  max depth  mean depth\n");
+    for(int q = 0; q < 2; q++) {
+        result.append(q == 0 ? "loaded  " : "computed");
+        result.append(formatDouble(queues[q].capacity, 10) + formatDouble(queues[q].maxDepth, 11) + formatDouble(queues[q].averageDepth, 12) + "\n");
+    }
+    result.append(std::to_string(completed) + " jobs completed and " + std::to_string(failures.size()) + " failed in " + std::to_string(seconds) + " seconds\n");
+    return result;
+}
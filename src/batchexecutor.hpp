@@ -0,0 +1,145 @@
+#include<map>
+#include<string>
+#include<vector>
+#include<functional>
+#include"matrix.hpp"
+#ifndef BATCHEXECUTOR_HPP
+#define BATCHEXECUTOR_HPP
+
+/**
+ * @brief Counters for one stage of the batch pipeline
+ *
+ */
+struct StageStats {
+    /** Number of threads running the stage */
+    int threads;
+    /** Jobs that made it through the stage */
+    int items;
+    /** Seconds spent doing the stage's own work, summed over its threads */
+    double busySeconds;
+    /** Seconds spent waiting for the previous stage, summed over its threads */
+    double starvedSeconds;
+    /** Seconds spent waiting for room in the next queue, summed over its threads */
+    double blockedSeconds;
+    /** Jobs per second of wall time */
+    double throughput;
+};
+
+/**
+ * @brief Occupancy of one queue between stages of the batch pipeline
+ *
+ */
+struct QueueStats {
+    /** Most jobs the queue may hold before producers block */
+    int capacity;
+    /** Deepest the queue got */
+    int maxDepth;
+    /** Depth averaged over every push and pop */
+    double averageDepth;
+};
+
+/**
+ * @brief Outcome of running a batch manifest
+ *
+ */
+struct BatchReport {
+    /** Wall time of the whole run */
+    double seconds;
+    /** Jobs whose output was written */
+    int completed;
+    /** Reading, computing and writing stages in pipeline order */
+    StageStats stages[3];
+    /** Queues feeding the computing and writing stages */
+    QueueStats queues[2];
+    /** Manifest line number and error message of every job that failed */
+    std::vector<std::pair<int, std::string>> failures;
+
+    /**
+     * @brief Formats the report as a table of per stage throughput and queue depths
+     *
+     * @return std::string the formatted report
+     */
+    std::string display();
+};
+
+/**
+ * @brief Runs load, compute and save over every job of a manifest as a pipeline.
+ * Reader threads load the inputs of jobs, worker threads compute them and writer
+ * threads save the results, connected by bounded queues so a fast stage blocks
+ * instead of piling up matrices in memory while disks and cores stay busy at once.
+ * Each line of the manifest is operation:input[:input...]:output, with the output
+ * written like save(). Jobs that fail are reported without stopping the run
+ *
+ */
+class BatchExecutor {
+    private:
+    /** Filepath of the manifest, used for logging */
+    std::string fp;
+    /** Manifest line numbers of the jobs */
+    std::vector<int> lines;
+    /** Operation name of each job */
+    std::vector<std::string> operations;
+    /** Input filepaths of each job */
+    std::vector<std::vector<std::string>> inputs;
+    /** Output filepath of each job */
+    std::vector<std::string> outputs;
+    /** Number of inputs each known operation takes */
+    std::map<std::string, int> arities;
+    /** Function computing each known operation */
+    std::map<std::string, std::function<Matrix(std::vector<Matrix>&)>> functions;
+    /** Threads per stage */
+    int readers, workers, writers;
+    /** Capacity of the queues between stages */
+    int capacity;
+
+    public:
+    /**
+     * @brief Reads a manifest, registering the built in operations copy, negate,
+     * inverse, multiply, add, subtract and leastsquares
+     *
+     * @param manifest filepath to the manifest
+     */
+    BatchExecutor(std::string manifest);
+
+    /**
+     * @brief Registers an operation the manifest may name, replacing any with the same name
+     *
+     * @param name name used in the manifest
+     * @param arity number of inputs the operation takes
+     * @param operation function computing the result from the loaded inputs
+     */
+    void registerOperation(std::string name, int arity, std::function<Matrix(std::vector<Matrix>&)> operation);
+
+    /**
+     * @brief Sets the number of threads of each stage, values below 1 become 1
+     *
+     * @param readerThreads threads loading inputs
+     * @param workerThreads threads computing results, whose kernels also use the shared pool
+     * @param writerThreads threads saving results
+     */
+    void setThreads(int readerThreads, int workerThreads, int writerThreads);
+
+    /**
+     * @brief Sets how many jobs each queue between stages holds before the stage
+     * feeding it blocks
+     *
+     * @param jobs capacity of each queue, values below 1 become 1
+     */
+    void setQueueCapacity(int jobs);
+
+    /**
+     * @brief Returns the number of jobs in the manifest
+     *
+     * @return int number of jobs
+     */
+    int size();
+
+    /**
+     * @brief Runs every job through the pipeline and waits for it to drain
+     *
+     * @return BatchReport timings, queue depths and failures of the run
+     */
+    BatchReport run();
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include<map>
+#include<list>
+#include<mutex>
+#include<string>
+#include<vector>
+#include"derivedcache.hpp"
+
+// Memory cached results may take unless set otherwise
+static const long long DEFAULT_BUDGET = 256LL << 20;
+
+// Reference to cache flag
+bool DerivedCache::flag;
+
+// Reference to cache pointer
+DerivedCache* DerivedCache::cache;
+
+// Reference to the lock guarding the cache
+std::mutex DerivedCache::lock;
+
+DerivedCache::DerivedCache() {
+    budget = DEFAULT_BUDGET;
+    used = 0;
+    hitCount = 0;
+    missCount = 0;
+}
+
+DerivedCache* DerivedCache::getInstance() {
+    std::lock_guard<std::mutex> guard(lock);
+    // If the cache has been initialized return it
+    if(flag) return cache;
+    // Otherwise initialize and return its pointer
+    cache = new DerivedCache();
+    flag = true;
+    return cache;
+}
+
+/**
+ * @brief Returns the approximate memory taken by a list of matrices
+ */
+static long long footprint(std::vector<Matrix> &values) {
+    long long bytes = 0;
+    for(int i = 0; i < values.size(); i++)
+        bytes += (long long) values[i].rows() * values[i].columns() * sizeof(double) + values[i].rows() * sizeof(std::vector<double>);
+    return bytes;
+}
+
+void DerivedCache::remove(std::map<Key, Entry>::iterator position) {
+    used -= position->second.bytes;
+    recency.erase(position->second.position);
+    entries.erase(position);
+}
+
+bool DerivedCache::lookup(unsigned long long version, std::string kind, std::vector<Matrix> &values) {
+    std::lock_guard<std::mutex> guard(lock);
+    std::map<Key, Entry>::iterator found = entries.find(Key(version, kind));
+    if(found == entries.end()) {
+        missCount++;
+        return false;
+    }
+    // Move the entry to the front of the recency list
+    recency.splice(recency.begin(), recency, found->second.position);
+    values = found->second.values;
+    hitCount++;
+    return true;
+}
+
+void DerivedCache::store(unsigned long long version, std::string kind, std::vector<Matrix> values) {
+    long long bytes = footprint(values);
+    std::lock_guard<std::mutex> guard(lock);
+    if(bytes > budget) return;
+    // Replace any result computed concurrently for the same key
+    Key key(version, kind);
+    std::map<Key, Entry>::iterator found = entries.find(key);
+    if(found != entries.end()) remove(found);
+    // Evict from the back of the recency list until the result fits
+    while(used + bytes > budget) remove(entries.find(recency.back()));
+    recency.push_front(key);
+    Entry entry;
+    entry.values = values;
+    entry.bytes = bytes;
+    entry.position = recency.begin();
+    entries.insert(std::make_pair(key, entry));
+    used += bytes;
+}
+
+void DerivedCache::erase(unsigned long long version) {
+    std::lock_guard<std::mutex> guard(lock);
+    // Entries of one version are adjacent in key order
+    std::map<Key, Entry>::iterator position = entries.lower_bound(Key(version, ""));
+    while(position != entries.end() && position->first.first == version) remove(position++);
+}
+
+void DerivedCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    recency.clear();
+    used = 0;
+}
+
+void DerivedCache::setBudget(long long bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    budget = bytes < 0 ? 0 : bytes;
+    while(used > budget) remove(entries.find(recency.back()));
+}
+
+long long DerivedCache::getBudget() {
+    std::lock_guard<std::mutex> guard(lock);
+    return budget;
+}
+
+long long DerivedCache::getUsed() {
+    std::lock_guard<std::mutex> guard(lock);
+    return used;
+}
+
+long long DerivedCache::hits() {
+    std::lock_guard<std::mutex> guard(lock);
+    return hitCount;
+}
+
+long long DerivedCache::misses() {
+    std::lock_guard<std::mutex> guard(lock);
+    return missCount;
+}
@@ -0,0 +1,145 @@
+#include<map>
+#include<list>
+#include<mutex>
+#include<string>
+#include<vector>
+#include"matrix.hpp"
+#ifndef DERIVEDCACHE_HPP
+#define DERIVEDCACHE_HPP
+
+/**
+ * @brief Singleton holding results derived from matrices, such as factorizations,
+ * inverses and norms, keyed on the version of the matrix they were computed from.
+ * Every mutation gives a matrix a new version, so stale results are never found
+ * again and simply age out. Results are evicted least recently used first once
+ * they exceed a memory budget
+ *
+ */
+class DerivedCache {
+    private:
+    /** Flag for whether the cache has been initialized */
+    static bool flag;
+
+    /** Pointer to the cache */
+    static DerivedCache* cache;
+
+    /** Guards every member, since matrices may be used from several threads */
+    static std::mutex lock;
+
+    /** Key of an entry, the matrix version and the name of the derived result */
+    typedef std::pair<unsigned long long, std::string> Key;
+
+    /**
+     * @brief A cached result with its size and its place in the recency list
+     *
+     */
+    struct Entry {
+        std::vector<Matrix> values;
+        long long bytes;
+        std::list<Key>::iterator position;
+    };
+
+    /** Entries ordered by version so all results of one version are adjacent */
+    std::map<Key, Entry> entries;
+    /** Keys from most to least recently used */
+    std::list<Key> recency;
+    /** Most bytes the entries may take */
+    long long budget;
+    /** Bytes the entries take */
+    long long used;
+    /** Lookups that found a result */
+    long long hitCount;
+    /** Lookups that did not */
+    long long missCount;
+
+    /**
+     * @brief Construct the cache with the default budget
+     *
+     */
+    DerivedCache();
+
+    /**
+     * @brief Removes one entry, the lock must be held
+     *
+     * @param position entry to remove
+     */
+    void remove(std::map<Key, Entry>::iterator position);
+
+    public:
+    /**
+     * @brief Get the instance of the cache
+     *
+     * @return DerivedCache* pointer to the cache
+     */
+    static DerivedCache* getInstance();
+
+    /**
+     * @brief Looks up a derived result and marks it as recently used
+     *
+     * @param version version of the matrix it was derived from
+     * @param kind name of the derived result
+     * @param values receives a copy of the result if found
+     * @return true if the result was cached
+     */
+    bool lookup(unsigned long long version, std::string kind, std::vector<Matrix> &values);
+
+    /**
+     * @brief Stores a derived result, evicting the least recently used ones beyond
+     * the budget. Results larger than the whole budget are not stored
+     *
+     * @param version version of the matrix it was derived from
+     * @param kind name of the derived result
+     * @param values the result
+     */
+    void store(unsigned long long version, std::string kind, std::vector<Matrix> values);
+
+    /**
+     * @brief Drops every result derived from one version of a matrix
+     *
+     * @param version version whose results are dropped
+     */
+    void erase(unsigned long long version);
+
+    /**
+     * @brief Drops every cached result
+     *
+     */
+    void clear();
+
+    /**
+     * @brief Sets the memory budget, evicting results beyond it. A budget of 0 disables caching
+     *
+     * @param bytes most bytes cached results may take
+     */
+    void setBudget(long long bytes);
+
+    /**
+     * @brief Returns the memory budget
+     *
+     * @return long long most bytes cached results may take
+     */
+    long long getBudget();
+
+    /**
+     * @brief Returns the memory taken by cached results
+     *
+     * @return long long bytes taken
+     */
+    long long getUsed();
+
+    /**
+     * @brief Returns how many lookups found a result
+     *
+     * @return long long number of hits
+     */
+    long long hits();
+
+    /**
+     * @brief Returns how many lookups did not find a result
+     *
+     * @return long long number of misses
+     */
+    long long misses();
+};
+
+#endif
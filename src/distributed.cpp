@@ -0,0 +1,359 @@
+#include<cmath>
+#include<string>
+#include<vector>
+#include<algorithm>
+#include"distributed.hpp"
+#include"kernels.hpp"
+#include"logger.hpp"
+
+/**
+ * @brief Returns how many of n indices dealt out in blocks land on one process
+ */
+static int localCount(int n, int block, int process, int processes) {
+    int blocks = n / block;
+    int count = (blocks / processes) * block;
+    int extra = blocks % processes;
+    if(process < extra) count += block;
+    else if(process == extra) count += n % block;
+    return count;
+}
+
+/**
+ * @brief Returns the global index of a local index on one process
+ */
+static int globalIndex(int index, int block, int process, int processes) {
+    return ((index / block) * processes + process) * block + index % block;
+}
+
+/**
+ * @brief Returns how many of the global indices before index land on one process
+ */
+static int countBefore(int index, int block, int process, int processes) {
+    int cycle = block * processes;
+    int rest = index % cycle - process * block;
+    return (index / cycle) * block + std::min(std::max(rest, 0), block);
+}
+
+//////////////////////////////////////////
+//  Laying out DistributedMatrix objects
+//////////////////////////////////////////
+
+DistributedMatrix::DistributedMatrix(Transport &group, std::string filepath, int rows, int columns, int blockSize, int processRows, int processColumns) {
+    // The grid must cover the group exactly
+    if(blockSize < 1 || processRows < 1 || processColumns < 1 || processRows * processColumns != group.size()) Logger::logInvalidDistribution(filepath);
+    transport = &group;
+    fp = filepath;
+    m = rows;
+    n = columns;
+    block = blockSize;
+    gridRows = processRows;
+    gridColumns = processColumns;
+    myRow = group.rank() / gridColumns;
+    myColumn = group.rank() % gridColumns;
+    localRows = localCount(m, block, myRow, gridRows);
+    localColumns = localCount(n, block, myColumn, gridColumns);
+    local.assign((long long) localRows * localColumns, 0);
+}
+
+DistributedMatrix::DistributedMatrix(Transport &group, Matrix &matrix, int blockSize, int processRows, int processColumns)
+    : DistributedMatrix(group, matrix.getFilePath(), matrix.rows(), matrix.columns(), blockSize, processRows, processColumns) {
+    // Keep only the blocks of this process
+    for(int i = 0; i < localRows; i++) {
+        const std::vector<double> &row = matrix.matrix[globalIndex(i, block, myRow, gridRows)];
+        for(int j = 0; j < localColumns; j++) local[(long long) i * localColumns + j] = row[globalIndex(j, block, myColumn, gridColumns)];
+    }
+}
+
+int DistributedMatrix::rows() {
+    return m;
+}
+
+int DistributedMatrix::columns() {
+    return n;
+}
+
+int DistributedMatrix::rowsBefore(int row) {
+    return countBefore(row, block, myRow, gridRows);
+}
+
+int DistributedMatrix::columnsBefore(int column) {
+    return countBefore(column, block, myColumn, gridColumns);
+}
+
+void DistributedMatrix::gridShape(int processes, int &processRows, int &processColumns) {
+    // The largest divisor no greater than the square root gives the squarest grid
+    processRows = std::max(1, (int) std::sqrt((double) processes));
+    while(processes % processRows != 0) processRows--;
+    processColumns = processes / processRows;
+}
+
+//////////////////////////////////////////
+//  Communicating within the grid
+//////////////////////////////////////////
+
+void DistributedMatrix::broadcastRow(std::vector<double> &values, int root) {
+    if(myColumn == root) {
+        for(int c = 0; c < gridColumns; c++)
+            if(c != root) transport->send(myRow * gridColumns + c, values);
+    } else transport->receive(myRow * gridColumns + root, values);
+}
+
+void DistributedMatrix::broadcastColumn(std::vector<double> &values, int root) {
+    if(myRow == root) {
+        for(int r = 0; r < gridRows; r++)
+            if(r != root) transport->send(r * gridColumns + myColumn, values);
+    } else transport->receive(root * gridColumns + myColumn, values);
+}
+
+void DistributedMatrix::exchange(std::vector<double> &values, int row) {
+    // The lower grid row sends first so the pair never waits on each other
+    std::vector<double> incoming;
+    int partner = row * gridColumns + myColumn;
+    if(myRow < row) {
+        transport->send(partner, values);
+        transport->receive(partner, incoming);
+    } else {
+        transport->receive(partner, incoming);
+        transport->send(partner, values);
+    }
+    values.swap(incoming);
+}
+
+Matrix DistributedMatrix::gather() {
+    std::vector<double> whole((long long) m * n);
+    if(transport->rank() == 0) {
+        // Rank 0 places the blocks of every process, then sends the whole matrix back out
+        for(int r = 0; r < transport->size(); r++) {
+            std::vector<double> part;
+            if(r == 0) part = local;
+            else transport->receive(r, part);
+            int row = r / gridColumns, column = r % gridColumns;
+            int partRows = localCount(m, block, row, gridRows), partColumns = localCount(n, block, column, gridColumns);
+            for(int i = 0; i < partRows; i++) {
+                long long offset = (long long) globalIndex(i, block, row, gridRows) * n;
+                for(int j = 0; j < partColumns; j++) whole[offset + globalIndex(j, block, column, gridColumns)] = part[(long long) i * partColumns + j];
+            }
+        }
+        for(int r = 1; r < transport->size(); r++) transport->send(r, whole);
+    } else {
+        transport->send(0, local);
+        transport->receive(0, whole);
+    }
+    return Matrix(fp, m, n, whole);
+}
+
+//////////////////////////////////////////
+//  Distributed operations
+//////////////////////////////////////////
+
+DistributedMatrix DistributedMatrix::operator*(DistributedMatrix &other) {
+    // The operands must share a layout and agree in their inner dimension
+    if(n != other.m || transport != other.transport || block != other.block || gridRows != other.gridRows || gridColumns != other.gridColumns) Logger::logInvalidDistribution(fp);
+    DistributedMatrix result(*transport, fp, m, other.n, block, gridRows, gridColumns);
+    std::vector<double> left, right;
+    for(int k = 0; k < n; k += block) {
+        int width = std::min(block, n - k);
+        // The owners of block column k of A and block row k of B share them
+        int owner = (k / block) % gridColumns;
+        if(myColumn == owner) {
+            int first = columnsBefore(k);
+            left.resize((long long) localRows * width);
+            for(int i = 0; i < localRows; i++)
+                std::copy(local.begin() + (long long) i * localColumns + first, local.begin() + (long long) i * localColumns + first + width, left.begin() + (long long) i * width);
+        }
+        broadcastRow(left, owner);
+        owner = (k / block) % gridRows;
+        if(myRow == owner) {
+            int first = other.rowsBefore(k);
+            right.assign(other.local.begin() + (long long) first * other.localColumns, other.local.begin() + (long long) (first + width) * other.localColumns);
+        }
+        broadcastColumn(right, owner);
+        // Fold the step into the local blocks of the product
+        gemm(localRows, result.localColumns, width, left.data(), width, right.data(), result.localColumns, result.local.data(), result.localColumns, false);
+    }
+    return result;
+}
+
+std::vector<int> DistributedMatrix::decomposeLU() {
+    if(m != n) Logger::logInvalidLUDecomposition(fp);
+    std::vector<int> pivots(n);
+    std::vector<double> message;
+    for(int k = 0; k < n; k += block) {
+        int width = std::min(block, n - k);
+        int panel = (k / block) % gridColumns;
+        int firstColumn = columnsBefore(k);
+        // Factor the block column one column at a time
+        for(int j = k; j < k + width; j++) {
+            int diagonal = (j / block) % gridRows;
+            int column = firstColumn + j - k;
+            // Each process of the panel column offers its largest entry on or below the diagonal
+            if(myColumn == panel) {
+                message.assign(3, -1);
+                for(int i = rowsBefore(j); i < localRows; i++) {
+                    double entry = local[(long long) i * localColumns + column];
+                    if(std::fabs(entry) > message[0]) message = {std::fabs(entry), entry, (double) globalIndex(i, block, myRow, gridRows)};
+                }
+                if(myRow == diagonal) {
+                    for(int r = 0; r < gridRows; r++) {
+                        if(r == diagonal) continue;
+                        std::vector<double> offer;
+                        transport->receive(r * gridColumns + myColumn, offer);
+                        if(offer[0] > message[0] || (offer[0] == message[0] && offer[2] < message[2])) message = offer;
+                    }
+                } else transport->send(diagonal * gridColumns + myColumn, message);
+                broadcastColumn(message, diagonal);
+            }
+            // Every process learns the pivot, and a zero pivot fails everywhere at once
+            broadcastRow(message, panel);
+            if(message[1] == 0) Logger::logInvalidLUDecomposition(fp);
+            int pivot = message[2];
+            pivots[j] = pivot;
+            // Swap rows j and pivot across every column
+            int pivotRow = (pivot / block) % gridRows;
+            if(pivot != j && diagonal == pivotRow && myRow == diagonal) {
+                std::swap_ranges(local.begin() + (long long) rowsBefore(j) * localColumns, local.begin() + (long long) (rowsBefore(j) + 1) * localColumns, local.begin() + (long long) rowsBefore(pivot) * localColumns);
+            } else if(pivot != j && diagonal != pivotRow && (myRow == diagonal || myRow == pivotRow)) {
+                int mine = rowsBefore(myRow == diagonal ? j : pivot);
+                std::vector<double> row(local.begin() + (long long) mine * localColumns, local.begin() + (long long) (mine + 1) * localColumns);
+                exchange(row, myRow == diagonal ? pivotRow : diagonal);
+                std::copy(row.begin(), row.end(), local.begin() + (long long) mine * localColumns);
+            }
+            // Scale the column below the diagonal and update the rest of the block column
+            if(myColumn == panel) {
+                int remaining = k + width - j;
+                if(myRow == diagonal) {
+                    long long start = (long long) rowsBefore(j) * localColumns + column;
+                    message.assign(local.begin() + start, local.begin() + start + remaining);
+                }
+                broadcastColumn(message, diagonal);
+                for(int i = rowsBefore(j + 1); i < localRows; i++) {
+                    double *row = local.data() + (long long) i * localColumns + column;
+                    row[0] /= message[0];
+                    for(int c = 1; c < remaining; c++) row[c] -= row[0] * message[c];
+                }
+            }
+        }
+        // Share the factored block column along each grid row
+        int top = rowsBefore(k), below = rowsBefore(k + width), trailing = columnsBefore(k + width);
+        int right = localColumns - trailing;
+        std::vector<double> lower;
+        if(myColumn == panel) {
+            lower.resize((long long) (localRows - top) * width);
+            for(int i = top; i < localRows; i++)
+                std::copy(local.begin() + (long long) i * localColumns + firstColumn, local.begin() + (long long) i * localColumns + firstColumn + width, lower.begin() + (long long) (i - top) * width);
+        }
+        broadcastRow(lower, panel);
+        // The grid row holding block row k solves L11 * U12 = A12 and shares U12 down each grid column
+        int owner = (k / block) % gridRows;
+        std::vector<double> upper;
+        if(myRow == owner) {
+            for(int c = 0; c < width; c++)
+                for(int r = c + 1; r < width; r++) {
+                    double factor = lower[(long long) r * width + c];
+                    double *target = local.data() + (long long) (top + r) * localColumns + trailing;
+                    const double *source = local.data() + (long long) (top + c) * localColumns + trailing;
+                    for(int t = 0; t < right; t++) target[t] -= factor * source[t];
+                }
+            upper.resize((long long) width * right);
+            for(int r = 0; r < width; r++)
+                std::copy(local.begin() + (long long) (top + r) * localColumns + trailing, local.begin() + (long long) (top + r + 1) * localColumns, upper.begin() + (long long) r * right);
+        }
+        broadcastColumn(upper, owner);
+        // Update the trailing matrix, A22 -= L21 * U12
+        for(int i = 0; i < upper.size(); i++) upper[i] = -upper[i];
+        gemm(localRows - below, right, width, lower.data() + (long long) (below - top) * width, width, upper.data(), right, local.data() + (long long) below * localColumns + trailing, localColumns, false);
+    }
+    return pivots;
+}
+
+//////////////////////////////////////////
+//  Running on worker processes
+//////////////////////////////////////////
+
+DistributedMatrix DistributedMatrix::scatter(Transport &group, Matrix *matrix, int blockSize, int processRows, int processColumns) {
+    // Rank 0 tells the others the dimensions, then hands each its blocks
+    std::vector<double> shape(2);
+    if(group.rank() == 0) {
+        shape[0] = matrix->rows();
+        shape[1] = matrix->columns();
+        for(int r = 1; r < group.size(); r++) group.send(r, shape);
+    } else group.receive(0, shape);
+    std::string filepath = group.rank() == 0 ? matrix->getFilePath() : "process " + std::to_string(group.rank());
+    DistributedMatrix result(group, filepath, shape[0], shape[1], blockSize, processRows, processColumns);
+    if(group.rank() != 0) {
+        group.receive(0, result.local);
+        return result;
+    }
+    for(int r = 0; r < group.size(); r++) {
+        int row = r / processColumns, column = r % processColumns;
+        int partRows = localCount(result.m, blockSize, row, processRows), partColumns = localCount(result.n, blockSize, column, processColumns);
+        std::vector<double> part((long long) partRows * partColumns);
+        for(int i = 0; i < partRows; i++) {
+            const std::vector<double> &values = matrix->matrix[globalIndex(i, blockSize, row, processRows)];
+            for(int j = 0; j < partColumns; j++) part[(long long) i * partColumns + j] = values[globalIndex(j, blockSize, column, processColumns)];
+        }
+        if(r == 0) result.local.swap(part);
+        else group.send(r, part);
+    }
+    return result;
+}
+
+Matrix DistributedMatrix::multiplyOn(Transport &group, Matrix *a, Matrix *b, int blockSize) {
+    int processRows, processColumns;
+    gridShape(group.size(), processRows, processColumns);
+    DistributedMatrix left = scatter(group, a, blockSize, processRows, processColumns);
+    DistributedMatrix right = scatter(group, b, blockSize, processRows, processColumns);
+    return (left * right).gather();
+}
+
+Matrix DistributedMatrix::decomposeOn(Transport &group, Matrix *a, int blockSize, std::vector<int> &pivots) {
+    int processRows, processColumns;
+    gridShape(group.size(), processRows, processColumns);
+    DistributedMatrix factor = scatter(group, a, blockSize, processRows, processColumns);
+    pivots = factor.decomposeLU();
+    return factor.gather();
+}
+
+int DistributedMatrix::work(int argc, char **argv) {
+    return SocketTransport::work(argc, argv, [](Transport &group, std::vector<std::string> &arguments) {
+        // The operation and its block size, the operands arrive from rank 0
+        if(arguments.size() != 2) Logger::logInvalidDistribution("process " + std::to_string(group.rank()));
+        int blockSize = std::stoi(arguments[1]);
+        std::vector<int> pivots;
+        if(arguments[0] == "multiply") multiplyOn(group, NULL, NULL, blockSize);
+        else if(arguments[0] == "lu") decomposeOn(group, NULL, blockSize, pivots);
+        else Logger::logInvalidDistribution("process " + std::to_string(group.rank()));
+    });
+}
+
+Matrix DistributedMatrix::multiply(Matrix &a, Matrix &b, int processes, int blockSize) {
+    // If dimensions don't match display error message
+    if(a.columns() != b.rows()) Logger::logInvalidDimensions(a.getFilePath(), a.rows(), a.columns(), b.getFilePath(), b.rows(), b.columns());
+    // The workers receive their blocks of the operands from this process
+    std::vector<Matrix> result;
+    SocketTransport::launch(processes, {"multiply", std::to_string(blockSize)}, [&](Transport &group) {
+        result.push_back(multiplyOn(group, &a, &b, blockSize));
+    });
+    return result[0];
+}
+
+std::vector<Matrix> DistributedMatrix::decomposeLU(Matrix &a, int processes, int blockSize) {
+    if(a.rows() != a.columns()) Logger::logInvalidLUDecomposition(a.getFilePath());
+    std::vector<Matrix> packed;
+    std::vector<int> pivots;
+    SocketTransport::launch(processes, {"lu", std::to_string(blockSize)}, [&](Transport &group) {
+        packed.push_back(decomposeOn(group, &a, blockSize, pivots));
+    });
+    // Split the packed factors and replay the swaps on the identity
+    int n = a.rows();
+    std::vector<int> order(n);
+    for(int i = 0; i < n; i++) order[i] = i;
+    for(int j = 0; j < n; j++) std::swap(order[j], order[pivots[j]]);
+    std::vector<double> L((long long) n * n), U((long long) n * n), P((long long) n * n);
+    for(int i = 0; i < n; i++) {
+        L[(long long) i * n + i] = 1;
+        P[(long long) i * n + order[i]] = 1;
+        for(int j = 0; j < n; j++) (j < i ? L : U)[(long long) i * n + j] = packed[0].matrix[i][j];
+    }
+    return {Matrix(a.getFilePath(), n, n, L), Matrix(a.getFilePath(), n, n, U), Matrix(a.getFilePath(), n, n, P)};
+}
@@ -0,0 +1,177 @@
+#include<string>
+#include<vector>
+#include"matrix.hpp"
+#include"transport.hpp"
+#ifndef DISTRIBUTED_HPP
+#define DISTRIBUTED_HPP
+
+/**
+ * @brief A matrix spread over the processes of a group in the 2D block-cyclic
+ * layout. The processes form a gridRows x gridColumns grid, rank r sitting at
+ * row r / gridColumns and column r % gridColumns, and block (I, J) of the matrix
+ * lives on the process at grid row I % gridRows and grid column J % gridColumns.
+ * Every process of the group must make the same calls in the same order, and
+ * the local work of each process runs on the library's own kernels
+ *
+ */
+class DistributedMatrix {
+    private:
+    /** Transport connecting the group */
+    Transport *transport;
+    /** Filepath identifier of the distributed matrix, used for logging */
+    std::string fp;
+    /** Global dimensions */
+    int m, n;
+    /** Rows and columns of each block */
+    int block;
+    /** Shape of the process grid and this process's place in it */
+    int gridRows, gridColumns, myRow, myColumn;
+    /** Dimensions of the local part */
+    int localRows, localColumns;
+    /** Row-major blocks owned by this process */
+    std::vector<double> local;
+
+    /**
+     * @brief Creates a distributed matrix of zeros
+     */
+    DistributedMatrix(Transport &group, std::string filepath, int rows, int columns, int blockSize, int processRows, int processColumns);
+
+    /**
+     * @brief Returns how many of the global rows before row are local, which is
+     * the local index of row when it is local
+     */
+    int rowsBefore(int row);
+
+    /**
+     * @brief Returns how many of the global columns before column are local, which
+     * is the local index of column when it is local
+     */
+    int columnsBefore(int column);
+
+    /**
+     * @brief Sends values from the process at grid column root to the rest of this process's grid row
+     */
+    void broadcastRow(std::vector<double> &values, int root);
+
+    /**
+     * @brief Sends values from the process at grid row root to the rest of this process's grid column
+     */
+    void broadcastColumn(std::vector<double> &values, int root);
+
+    /**
+     * @brief Exchanges values with the process at the given grid row of this grid column
+     */
+    void exchange(std::vector<double> &values, int row);
+
+    /**
+     * @brief Distributes a matrix held by rank 0 alone, which sends every other
+     * process its blocks. The other processes pass no matrix
+     */
+    static DistributedMatrix scatter(Transport &group, Matrix *matrix, int blockSize, int processRows, int processColumns);
+
+    /**
+     * @brief Runs the part of multiply every process of the group shares, with the
+     * operands given on rank 0 only
+     */
+    static Matrix multiplyOn(Transport &group, Matrix *a, Matrix *b, int blockSize);
+
+    /**
+     * @brief Runs the part of decomposeLU every process of the group shares, with
+     * the matrix given on rank 0 only, returning the packed factors
+     */
+    static Matrix decomposeOn(Transport &group, Matrix *a, int blockSize, std::vector<int> &pivots);
+
+    public:
+    /**
+     * @brief Distributes a matrix every process holds a copy of, each keeping only its own blocks
+     *
+     * @param group transport connecting the processes
+     * @param matrix the whole matrix
+     * @param blockSize rows and columns of each block
+     * @param processRows rows of the process grid, whose size must match the group
+     * @param processColumns columns of the process grid
+     */
+    DistributedMatrix(Transport &group, Matrix &matrix, int blockSize, int processRows, int processColumns);
+
+    /**
+     * @brief Returns the number of rows of the whole matrix
+     *
+     * @return int number of rows
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of columns of the whole matrix
+     *
+     * @return int number of columns
+     */
+    int columns();
+
+    /**
+     * @brief Collects the blocks of every process into the whole matrix on every process
+     *
+     * @return Matrix the whole matrix
+     */
+    Matrix gather();
+
+    /**
+     * @brief Multiplies with SUMMA, broadcasting a block column of this matrix along
+     * the grid rows and a block row of the other along the grid columns for each
+     * step, which every process folds into its blocks of the product
+     *
+     * @param other matrix on the same grid with the same block size
+     * @return DistributedMatrix the product, on the same grid
+     */
+    DistributedMatrix operator*(DistributedMatrix &other);
+
+    /**
+     * @brief Factors the NxN matrix in place so that P * A = L * U using partial
+     * pivoting, leaving the unit lower L below the diagonal and U on and above it
+     *
+     * @return std::vector<int> row swapped with each row in turn, the same on every process
+     */
+    std::vector<int> decomposeLU();
+
+    /**
+     * @brief Computes A * B over a group of worker processes on this machine
+     *
+     * @param a left operand
+     * @param b right operand
+     * @param processes number of processes to spread the work over
+     * @param blockSize rows and columns of each block
+     * @return Matrix the product
+     */
+    static Matrix multiply(Matrix &a, Matrix &b, int processes, int blockSize);
+
+    /**
+     * @brief Decomposes an NxN matrix with partial pivoting over a group of worker
+     * processes on this machine
+     *
+     * @param a matrix to decompose
+     * @param processes number of processes to spread the work over
+     * @param blockSize rows and columns of each block
+     * @return std::vector<Matrix> Vector containing the Lower(index0), Upper(index1) and Permutation(index2) output matrices, with P * A = L * U
+     */
+    static std::vector<Matrix> decomposeLU(Matrix &a, int processes, int blockSize);
+
+    /**
+     * @brief Chooses the most nearly square process grid for a group
+     *
+     * @param processes number of processes in the group
+     * @param processRows receives the rows of the grid
+     * @param processColumns receives the columns of the grid
+     */
+    static void gridShape(int processes, int &processRows, int &processColumns);
+
+    /**
+     * @brief Runs one worker rank of multiply or decomposeLU, the entry point of
+     * the worker executable started by SocketTransport::launch
+     *
+     * @param argc number of command line arguments
+     * @param argv command line arguments given by SocketTransport::launch
+     * @return int exit code of the worker
+     */
+    static int work(int argc, char **argv);
+};
+
+#endif
@@ -0,0 +1,545 @@
+#include<cmath>
+#include<limits>
+#include<vector>
+#include<algorithm>
+#include"eigen.hpp"
+#include"factorizations.hpp"
+#include"kernels.hpp"
+#include"parallel.hpp"
+
+// Columns reduced together by the blocked tridiagonalization
+static const int TRIDIAGONAL_BLOCK = 32;
+// Largest subproblem the divide and conquer hands to the implicit QL iteration
+static const int DIVIDE_BASE = 32;
+// Iterations of the implicit QL allowed for each eigenvalue
+static const int QL_ITERATIONS = 60;
+// Iterations allowed when solving for one root of the secular equation
+static const int SECULAR_ITERATIONS = 100;
+// Minimum number of secular roots or eigenpairs handed to a thread
+static const int ROOT_GRAIN = 32;
+// Rounding unit of double precision
+static const double EPSILON = std::numeric_limits<double>::epsilon();
+
+//////////////////////////////////////////
+//  Tridiagonal reduction
+//////////////////////////////////////////
+
+void tridiagonalize(int n, double *a, double *d, double *e, double *tau) {
+    std::vector<double> column(n), y(n), vw(TRIDIAGONAL_BLOCK), wv(TRIDIAGONAL_BLOCK);
+    std::vector<const double*> rows(n);
+    // The last two columns are already tridiagonal
+    for(int k = 0; k < n - 2; k += TRIDIAGONAL_BLOCK) {
+        int b = std::min(TRIDIAGONAL_BLOCK, n - 2 - k);
+        // Reflectors of the panel and their images, indexed by global row
+        std::vector<double> v((long long) n * b, 0), w((long long) n * b, 0);
+        for(int i = 0; i < b; i++) {
+            int j = k + i;
+            // Bring column j up to date with the reflectors already generated in the panel
+            for(int r = j; r < n; r++) {
+                double update = 0;
+                for(int p = 0; p < i; p++)
+                    update += v[(long long) r * b + p] * w[(long long) j * b + p] + w[(long long) r * b + p] * v[(long long) j * b + p];
+                a[(long long) r * n + j] -= update;
+            }
+            d[j] = a[(long long) j * n + j];
+            // Annihilate column j below the subdiagonal
+            int len = n - j - 1;
+            for(int r = 0; r < len; r++) column[r] = a[(long long) (j + 1 + r) * n + j];
+            tau[j] = householder(len, column.data());
+            e[j] = column[0];
+            for(int r = 0; r < len; r++) a[(long long) (j + 1 + r) * n + j] = column[r];
+            column[0] = 1;
+            // y = A22 * v, where the trailing matrix still lacks this panel's update
+            for(int r = 0; r < len; r++) rows[r] = a + (long long) (j + 1 + r) * n + j + 1;
+            gemv(len, len, rows.data(), column.data(), y.data());
+            // Account for the pending update, y -= V * (W^T * v) + W * (V^T * v)
+            for(int p = 0; p < i; p++) vw[p] = wv[p] = 0;
+            for(int r = 0; r < len; r++)
+                for(int p = 0; p < i; p++) {
+                    vw[p] += w[(long long) (j + 1 + r) * b + p] * column[r];
+                    wv[p] += v[(long long) (j + 1 + r) * b + p] * column[r];
+                }
+            for(int r = 0; r < len; r++)
+                for(int p = 0; p < i; p++)
+                    y[r] -= v[(long long) (j + 1 + r) * b + p] * vw[p] + w[(long long) (j + 1 + r) * b + p] * wv[p];
+            // w = tau * y - tau^2 / 2 * (y^T * v) * v makes the two sided update a rank two correction
+            double alpha = -0.5 * tau[j] * tau[j] * vectorDot(len, y.data(), column.data());
+            for(int r = 0; r < len; r++) {
+                v[(long long) (j + 1 + r) * b + i] = column[r];
+                w[(long long) (j + 1 + r) * b + i] = tau[j] * y[r] + alpha * column[r];
+            }
+        }
+        // Apply the panel to the trailing matrix, A22 -= V * W^T + W * V^T
+        int s = k + b, size = n - s;
+        std::vector<double> vt((long long) b * size), wt((long long) b * size);
+        for(int r = 0; r < size; r++)
+            for(int p = 0; p < b; p++) {
+                vt[(long long) p * size + r] = v[(long long) (s + r) * b + p];
+                wt[(long long) p * size + r] = w[(long long) (s + r) * b + p];
+            }
+        vectorScale(size * b, -1, v.data() + (long long) s * b);
+        vectorScale(size * b, -1, w.data() + (long long) s * b);
+        gemm(size, size, b, v.data() + (long long) s * b, b, wt.data(), size, a + (long long) s * n + s, n, true);
+        gemm(size, size, b, w.data() + (long long) s * b, b, vt.data(), size, a + (long long) s * n + s, n, true);
+    }
+    // Copy out the trailing 2 x 2 block
+    if(n >= 2) {
+        d[n - 2] = a[(long long) (n - 2) * n + n - 2];
+        e[n - 2] = a[(long long) (n - 1) * n + n - 2];
+        tau[n - 2] = 0;
+    }
+    if(n >= 1) d[n - 1] = a[(long long) n * n - 1];
+}
+
+void tridiagonalApplyQ(int n, const double *a, const double *tau, int r, double *c) {
+    // Q leaves the first row alone, the remaining reflectors form a QR factorization of order n - 1
+    if(n < 3) return;
+    int size = n - 1;
+    std::vector<double> reflectors((long long) size * size, 0);
+    for(int i = 1; i < size; i++)
+        for(int j = 0; j < i; j++) reflectors[(long long) i * size + j] = a[(long long) (i + 1) * n + j];
+    qrApply(size, size, reflectors.data(), tau, r, c + r);
+}
+
+//////////////////////////////////////////
+//  Implicit QL iteration
+//////////////////////////////////////////
+
+/**
+ * @brief Diagonalizes a symmetric tridiagonal matrix with the implicit QL iteration
+ * using Wilkinson shifts, rotating the columns of z when it is given. e[i] couples
+ * i and i + 1 and e[n - 1] is workspace. The eigenvalues are left unordered
+ */
+static bool implicitQL(int n, double *d, double *e, double *z, int ldz) {
+    if(n == 0) return true;
+    e[n - 1] = 0;
+    for(int l = 0; l < n; l++) {
+        int iterations = 0, m;
+        do {
+            // Look for a negligible subdiagonal entry splitting the matrix
+            for(m = l; m < n - 1; m++) {
+                double dd = std::fabs(d[m]) + std::fabs(d[m + 1]);
+                if(std::fabs(e[m]) <= EPSILON * dd || std::fabs(e[m]) < std::numeric_limits<double>::min()) break;
+            }
+            if(m == l) break;
+            if(iterations++ == QL_ITERATIONS) return false;
+            // Shift by the eigenvalue of the leading 2 x 2 block closer to d[l]
+            double g = (d[l + 1] - d[l]) / (2 * e[l]);
+            double r = std::hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+            double s = 1, c = 1, p = 0;
+            int i;
+            // Chase the bulge from the bottom of the unreduced block to the top
+            for(i = m - 1; i >= l; i--) {
+                double f = s * e[i], b = c * e[i];
+                e[i + 1] = r = std::hypot(f, g);
+                if(r == 0) {
+                    // Underflow split the matrix, restart on the smaller block
+                    d[i + 1] -= p;
+                    e[m] = 0;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                if(z)
+                    for(int k = 0; k < n; k++) {
+                        double *row = z + (long long) k * ldz;
+                        f = row[i + 1];
+                        row[i + 1] = s * row[i] + c * f;
+                        row[i] = c * row[i] - s * f;
+                    }
+            }
+            if(r == 0 && i >= l) continue;
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0;
+        } while(true);
+    }
+    return true;
+}
+
+/**
+ * @brief Sorts n eigenvalues into ascending order, permuting the columns of the
+ * n x n block z alongside when it is given
+ */
+static void sortEigenpairs(int n, double *d, double *z, int ldz) {
+    std::vector<int> order(n);
+    for(int i = 0; i < n; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [d](int x, int y) { return d[x] < d[y]; });
+    std::vector<double> values(n), row(n);
+    for(int i = 0; i < n; i++) values[i] = d[order[i]];
+    std::copy(values.begin(), values.end(), d);
+    if(!z) return;
+    for(int r = 0; r < n; r++) {
+        double *zr = z + (long long) r * ldz;
+        for(int i = 0; i < n; i++) row[i] = zr[order[i]];
+        std::copy(row.begin(), row.end(), zr);
+    }
+}
+
+//////////////////////////////////////////
+//  Divide and conquer
+//////////////////////////////////////////
+
+/**
+ * @brief Finds root i of the secular equation 1 / rho + sum z[j]^2 / (d[j] - lambda) = 0
+ * for ascending poles d and unit z. The root is measured from the nearer pole so the
+ * differences delta[j] = d[j] - lambda, which the eigenvectors are built from, keep
+ * full relative accuracy. Each step fits one pole on either side of the root and
+ * falls back to bisection whenever the fit leaves the bracket
+ */
+static double secularRoot(int k, const double *d, const double *z, double rho, int i, double *shift, double *delta) {
+    double origin, lower, upper;
+    if(i < k - 1) {
+        // Decide which half of (d[i], d[i+1]) holds the root from the sign at the midpoint
+        double half = (d[i + 1] - d[i]) / 2;
+        double f = 1 / rho;
+        for(int j = 0; j < k; j++) f += z[j] * z[j] / ((d[j] - d[i]) - half);
+        if(f > 0) {
+            origin = d[i];
+            lower = 0;
+            upper = half;
+        } else {
+            origin = d[i + 1];
+            lower = -half;
+            upper = 0;
+        }
+    } else {
+        // The last root lies within rho of the largest pole since z has unit norm
+        origin = d[k - 1];
+        lower = 0;
+        upper = rho;
+    }
+    for(int j = 0; j < k; j++) shift[j] = d[j] - origin;
+    double tau = (lower + upper) / 2;
+    for(int iteration = 0; iteration < SECULAR_ITERATIONS; iteration++) {
+        // Split the sum into the poles left and right of the root with their derivatives
+        double psi = 0, dpsi = 0, phi = 0, dphi = 0;
+        for(int j = 0; j < k; j++) {
+            delta[j] = shift[j] - tau;
+            double t = z[j] / delta[j];
+            if(j <= i) {
+                psi += z[j] * t;
+                dpsi += t * t;
+            } else {
+                phi += z[j] * t;
+                dphi += t * t;
+            }
+        }
+        double f = 1 / rho + psi + phi;
+        if(f > 0) upper = tau;
+        else lower = tau;
+        // Stop once the residual is at the level of the rounding in its evaluation
+        if(std::fabs(f) <= 8 * EPSILON * k * (1 / rho + std::fabs(psi) + std::fabs(phi))) break;
+        if(upper - lower <= 2 * EPSILON * std::fmax(std::fabs(lower), std::fabs(upper))) break;
+        // Model psi by a + b / (delta[i] - eta) and phi by A + B / (delta[i+1] - eta)
+        double left = delta[i];
+        double b = left * left * dpsi;
+        double c = 1 / rho + psi - left * dpsi;
+        double eta;
+        if(i < k - 1) {
+            double right = delta[i + 1];
+            double bb = right * right * dphi;
+            c += phi - right * dphi;
+            // Multiply out c + b / (left - eta) + bb / (right - eta) = 0
+            double qa = c, qb = -(c * (left + right) + b + bb), qc = c * left * right + b * right + bb * left;
+            double disc = std::sqrt(std::fmax(qb * qb - 4 * qa * qc, 0.0));
+            double q = -0.5 * (qb + std::copysign(disc, qb));
+            double first = qa != 0 ? q / qa : qc / -qb;
+            double second = q != 0 ? qc / q : first;
+            eta = first > left && first < right ? first : second;
+        } else {
+            eta = c != 0 ? left + b / c : 0;
+        }
+        double next = tau + eta;
+        tau = next > lower && next < upper ? next : (lower + upper) / 2;
+    }
+    for(int j = 0; j < k; j++) delta[j] = shift[j] - tau;
+    return origin + tau;
+}
+
+/**
+ * @brief Merges the solved halves of a divide and conquer step. On entry the
+ * n x n block z is diag(Q1, Q2) and d holds the eigenvalues of both halves, and the
+ * matrix to diagonalize is diag(d) + rho * u * u^T with u the last row of Q1
+ * followed by sign times the first row of Q2. On return d and z hold the merged eigenpairs
+ */
+static void mergeHalves(int n, int m, double *d, double *z, int ldz, double rho, double sign) {
+    std::vector<double> u(n);
+    for(int j = 0; j < m; j++) u[j] = z[(long long) (m - 1) * ldz + j];
+    for(int j = m; j < n; j++) u[j] = sign * z[(long long) m * ldz + j];
+    // Normalize u, folding its norm into rho
+    double norm = vectorNorm(n, u.data());
+    rho *= norm * norm;
+    vectorScale(n, 1 / norm, u.data());
+    // Visit the poles in ascending order
+    std::vector<int> order(n);
+    for(int i = 0; i < n; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [d](int x, int y) { return d[x] < d[y]; });
+    std::vector<double> poles(n), weights(n);
+    double largest = rho;
+    for(int i = 0; i < n; i++) {
+        poles[i] = d[order[i]];
+        weights[i] = u[order[i]];
+        largest = std::fmax(largest, std::fabs(poles[i]));
+    }
+    // Deflate negligible weights, and close poles after rotating one weight onto the other
+    double tolerance = 8 * EPSILON * largest;
+    std::vector<int> kept, deflated;
+    for(int i = 0; i < n; i++) {
+        if(rho * std::fabs(weights[i]) <= tolerance) {
+            deflated.push_back(i);
+            continue;
+        }
+        if(!kept.empty()) {
+            int p = kept.back();
+            double t = std::hypot(weights[p], weights[i]);
+            double c = weights[i] / t, s = weights[p] / t;
+            if(std::fabs((poles[i] - poles[p]) * c * s) <= tolerance) {
+                int zp = order[p], zi = order[i];
+                for(int r = 0; r < n; r++) {
+                    double *row = z + (long long) r * ldz;
+                    double qp = row[zp], qi = row[zi];
+                    row[zp] = c * qp - s * qi;
+                    row[zi] = s * qp + c * qi;
+                }
+                double dp = poles[p], di = poles[i];
+                poles[p] = c * c * dp + s * s * di;
+                poles[i] = s * s * dp + c * c * di;
+                weights[p] = 0;
+                weights[i] = t;
+                kept.pop_back();
+                deflated.push_back(p);
+            }
+        }
+        kept.push_back(i);
+    }
+    // The rotations can nudge the surviving poles out of order
+    std::stable_sort(kept.begin(), kept.end(), [&poles](int x, int y) { return poles[x] < poles[y]; });
+    int k = kept.size();
+    std::vector<double> dk(k), zk(k), roots(k), delta((long long) k * k);
+    for(int j = 0; j < k; j++) {
+        dk[j] = poles[kept[j]];
+        zk[j] = weights[kept[j]];
+    }
+    // Roots are independent of each other
+    parallelFor(0, k, ROOT_GRAIN, [&](int begin, int end) {
+        std::vector<double> shift(k);
+        for(int i = begin; i < end; i++)
+            roots[i] = secularRoot(k, dk.data(), zk.data(), rho, i, shift.data(), delta.data() + (long long) i * k);
+    });
+    // Recompute the weights from the roots so the eigenvectors come out orthogonal
+    std::vector<double> zhat(k);
+    for(int j = 0; j < k; j++) {
+        double product = -delta[(long long) (k - 1) * k + j] / rho;
+        for(int i = 0; i < j; i++) product *= -delta[(long long) i * k + j] / (dk[i] - dk[j]);
+        for(int i = j; i < k - 1; i++) product *= -delta[(long long) i * k + j] / (dk[i + 1] - dk[j]);
+        zhat[j] = std::copysign(std::sqrt(std::fmax(product, 0.0)), zk[j]);
+    }
+    // Eigenvectors of the rank one problem, one per column
+    std::vector<double> vectors((long long) k * k);
+    for(int i = 0; i < k; i++) {
+        const double *di = delta.data() + (long long) i * k;
+        double sum = 0;
+        for(int j = 0; j < k; j++) {
+            double x = zhat[j] / di[j];
+            vectors[(long long) j * k + i] = x;
+            sum += x * x;
+        }
+        double scale = 1 / std::sqrt(sum);
+        for(int j = 0; j < k; j++) vectors[(long long) j * k + i] *= scale;
+    }
+    // Rotate the surviving columns of z by them
+    std::vector<double> basis((long long) n * k), merged((long long) n * k, 0);
+    for(int r = 0; r < n; r++)
+        for(int j = 0; j < k; j++) basis[(long long) r * k + j] = z[(long long) r * ldz + order[kept[j]]];
+    gemm(n, k, k, basis.data(), k, vectors.data(), k, merged.data(), k, true);
+    // Gather every eigenpair and write them back in ascending order
+    std::vector<double> values(n), columns((long long) n * n);
+    for(int j = 0; j < k; j++) {
+        values[j] = roots[j];
+        for(int r = 0; r < n; r++) columns[(long long) r * n + j] = merged[(long long) r * k + j];
+    }
+    for(int j = 0; j < deflated.size(); j++) {
+        values[k + j] = poles[deflated[j]];
+        for(int r = 0; r < n; r++) columns[(long long) r * n + k + j] = z[(long long) r * ldz + order[deflated[j]]];
+    }
+    for(int r = 0; r < n; r++) std::copy(columns.begin() + (long long) r * n, columns.begin() + (long long) (r + 1) * n, z + (long long) r * ldz);
+    std::copy(values.begin(), values.end(), d);
+    sortEigenpairs(n, d, z, ldz);
+}
+
+/**
+ * @brief Solves the tridiagonal eigenproblem of order n into the n x n block z by
+ * tearing it in half with a rank one correction, solving both halves and merging.
+ * Halves are solved concurrently while tasks allows more than one
+ */
+static bool divideConquer(int n, double *d, double *e, double *z, int ldz, int tasks) {
+    if(n <= DIVIDE_BASE) {
+        for(int r = 0; r < n; r++)
+            for(int c = 0; c < n; c++) z[(long long) r * ldz + c] = r == c;
+        if(!implicitQL(n, d, e, z, ldz)) return false;
+        sortEigenpairs(n, d, z, ldz);
+        return true;
+    }
+    // T = diag(T1, T2) + rho * u * u^T with u = e[m-1] + sign * e[m]
+    int m = n / 2;
+    double beta = e[m - 1];
+    double rho = std::fabs(beta), sign = beta < 0 ? -1 : 1;
+    d[m - 1] -= rho;
+    d[m] -= rho;
+    // The off diagonal blocks of diag(Q1, Q2) are zero
+    for(int r = 0; r < n; r++)
+        for(int c = 0; c < n; c++)
+            if((r < m) != (c < m)) z[(long long) r * ldz + c] = 0;
+    bool converged[2];
+    parallelFor(0, 2, tasks > 1 ? 1 : 2, [&](int begin, int end) {
+        for(int h = begin; h < end; h++) {
+            int offset = h == 0 ? 0 : m, size = h == 0 ? m : n - m;
+            converged[h] = divideConquer(size, d + offset, e + offset, z + (long long) offset * ldz + offset, ldz, tasks / 2);
+        }
+    });
+    if(!converged[0] || !converged[1]) return false;
+    if(rho != 0) mergeHalves(n, m, d, z, ldz, rho, sign);
+    else sortEigenpairs(n, d, z, ldz);
+    return true;
+}
+
+bool tridiagonalEigen(int n, double *d, double *e, double *z) {
+    if(n > 0) e[n - 1] = 0;
+    // Eigenvalues alone cost O(n^2) with the QL iteration
+    if(!z) {
+        if(!implicitQL(n, d, e, nullptr, 0)) return false;
+        sortEigenpairs(n, d, nullptr, 0);
+        return true;
+    }
+    return divideConquer(n, d, e, z, n, getThreadCount());
+}
+
+//////////////////////////////////////////
+//  Bisection and inverse iteration
+//////////////////////////////////////////
+
+/**
+ * @brief Returns how many eigenvalues of the tridiagonal matrix are below x,
+ * which is the number of negative pivots of T - x * I
+ */
+static int sturmCount(int n, const double *d, const double *e, double x, double pivmin) {
+    int count = 0;
+    double q = 1;
+    for(int i = 0; i < n; i++) {
+        q = d[i] - x - (i > 0 ? e[i - 1] * e[i - 1] / q : 0);
+        if(std::fabs(q) < pivmin) q = -pivmin;
+        if(q < 0) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Solves (T - lambda * I) * x = x in place with Gaussian elimination with
+ * partial pivoting, replacing zero pivots by a small multiple of the norm
+ */
+static void shiftedSolve(int n, const double *d, const double *e, double lambda, double tiny, double *x) {
+    std::vector<double> diag(n), upper(n), second(n), multiplier(n);
+    std::vector<bool> swapped(n, false);
+    for(int i = 0; i < n; i++) {
+        diag[i] = d[i] - lambda;
+        upper[i] = i < n - 1 ? e[i] : 0;
+        second[i] = 0;
+    }
+    for(int i = 0; i < n - 1; i++) {
+        if(std::fabs(diag[i]) >= std::fabs(e[i])) {
+            if(diag[i] == 0) diag[i] = tiny;
+            multiplier[i] = e[i] / diag[i];
+            diag[i + 1] -= multiplier[i] * upper[i];
+        } else {
+            // Swap rows i and i + 1, which fills in a second superdiagonal
+            multiplier[i] = diag[i] / e[i];
+            swapped[i] = true;
+            diag[i] = e[i];
+            double next = diag[i + 1];
+            diag[i + 1] = upper[i] - multiplier[i] * next;
+            upper[i] = next;
+            if(i < n - 2) {
+                second[i] = upper[i + 1];
+                upper[i + 1] = -multiplier[i] * second[i];
+            }
+        }
+    }
+    if(diag[n - 1] == 0) diag[n - 1] = tiny;
+    // Forward substitution with the recorded swaps, then back substitution
+    for(int i = 0; i < n - 1; i++) {
+        if(swapped[i]) std::swap(x[i], x[i + 1]);
+        x[i + 1] -= multiplier[i] * x[i];
+    }
+    for(int i = n - 1; i >= 0; i--) {
+        double sum = x[i];
+        if(i < n - 1) sum -= upper[i] * x[i + 1];
+        if(i < n - 2) sum -= second[i] * x[i + 2];
+        x[i] = sum / diag[i];
+    }
+}
+
+void tridiagonalLargest(int n, const double *d, const double *e, int k, double *values, double *z) {
+    // Gershgorin bounds on the spectrum
+    double lower = d[0], upper = d[0], squares = 1;
+    for(int i = 0; i < n; i++) {
+        double radius = (i > 0 ? std::fabs(e[i - 1]) : 0) + (i < n - 1 ? std::fabs(e[i]) : 0);
+        lower = std::fmin(lower, d[i] - radius);
+        upper = std::fmax(upper, d[i] + radius);
+        if(i < n - 1) squares = std::fmax(squares, e[i] * e[i]);
+    }
+    double norm = std::fmax(std::fabs(lower), std::fabs(upper));
+    double pivmin = std::numeric_limits<double>::min() * squares;
+    // Bisect for eigenvalue n - 1 - j, keeping count(low) <= index < count(high)
+    parallelFor(0, k, ROOT_GRAIN, [&](int begin, int end) {
+        for(int j = begin; j < end; j++) {
+            int index = n - 1 - j;
+            double low = lower - EPSILON * norm - pivmin, high = upper + EPSILON * norm + pivmin;
+            while(high - low > 2 * EPSILON * std::fmax(std::fabs(low), std::fabs(high)) + pivmin) {
+                double mid = low + (high - low) / 2;
+                if(mid <= low || mid >= high) break;
+                if(sturmCount(n, d, e, mid, pivmin) <= index) low = mid;
+                else high = mid;
+            }
+            values[j] = low + (high - low) / 2;
+        }
+    });
+    // Eigenvalues closer than this share a cluster whose vectors are orthogonalized together
+    double gap = 1e-3 * norm;
+    std::vector<int> clusters;
+    for(int j = 0; j < k; j++)
+        if(j == 0 || values[j - 1] - values[j] > gap) clusters.push_back(j);
+    clusters.push_back(k);
+    double tiny = EPSILON * std::fmax(norm, std::numeric_limits<double>::min());
+    parallelFor(0, clusters.size() - 1, 1, [&](int begin, int end) {
+        std::vector<double> x(n);
+        for(int c = begin; c < end; c++)
+            for(int j = clusters[c]; j < clusters[c + 1]; j++) {
+                // Start from a fixed pseudo random vector so no eigenvector is missed by symmetry
+                unsigned int state = 2463534242u + j;
+                for(int i = 0; i < n; i++) {
+                    state ^= state << 13;
+                    state ^= state >> 17;
+                    state ^= state << 5;
+                    x[i] = (state % 2001) / 1000.0 - 1;
+                }
+                for(int iteration = 0; iteration < 3; iteration++) {
+                    shiftedSolve(n, d, e, values[j], tiny, x.data());
+                    // Remove the components along the vectors already found in the cluster
+                    for(int p = clusters[c]; p < j; p++) {
+                        double projection = 0;
+                        for(int i = 0; i < n; i++) projection += x[i] * z[(long long) i * k + p];
+                        for(int i = 0; i < n; i++) x[i] -= projection * z[(long long) i * k + p];
+                    }
+                    vectorScale(n, 1 / vectorNorm(n, x.data()), x.data());
+                }
+                for(int i = 0; i < n; i++) z[(long long) i * k + j] = x[i];
+            }
+    });
+}
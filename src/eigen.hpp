@@ -0,0 +1,60 @@
+#ifndef EIGEN_HPP
+#define EIGEN_HPP
+
+/**
+ * @brief Reduces a full symmetric row-major matrix to tridiagonal form
+ * T = Q^T * A * Q with blocked Householder reflections. Each panel of reflectors
+ * is applied to the trailing matrix as the symmetric rank 2k update
+ * A -= V * W^T + W * V^T, so the bulk of the work is matrix products. On return
+ * reflector j is stored below the subdiagonal of column j with an implicit unit
+ * entry on the subdiagonal
+ *
+ * @param n order of the matrix
+ * @param a pointer to the matrix, overwritten with the reflectors
+ * @param d receives the n diagonal entries of T
+ * @param e receives the n - 1 subdiagonal entries of T
+ * @param tau receives the n - 1 reflector scales
+ */
+void tridiagonalize(int n, double *a, double *d, double *e, double *tau);
+
+/**
+ * @brief Overwrites the row-major n x r matrix C with Q * C for a reduction from tridiagonalize
+ *
+ * @param n order of the reduced matrix
+ * @param a pointer to the reduced matrix
+ * @param tau reflector scales from the reduction
+ * @param r columns of C
+ * @param c pointer to C
+ */
+void tridiagonalApplyQ(int n, const double *a, const double *tau, int r, double *c);
+
+/**
+ * @brief Computes every eigenvalue of a symmetric tridiagonal matrix, and optionally
+ * its eigenvectors. Eigenvectors come from Cuppen's divide and conquer with
+ * deflation, where the merged vectors are rebuilt from the roots of the secular
+ * equation as proposed by Gu and Eisenstat so they stay orthogonal. Small
+ * subproblems, and the eigenvalues only case, use the implicit QL iteration
+ *
+ * @param n order of the matrix
+ * @param d pointer to the n diagonal entries, overwritten with the eigenvalues in ascending order
+ * @param e pointer to the n - 1 subdiagonal entries followed by one entry of workspace, destroyed
+ * @param z pointer to the row-major n x n output whose columns receive the eigenvectors, or null
+ * @return true if the iteration converged
+ */
+bool tridiagonalEigen(int n, double *d, double *e, double *z);
+
+/**
+ * @brief Computes the k largest eigenvalues of a symmetric tridiagonal matrix by
+ * Sturm sequence bisection and their eigenvectors by inverse iteration, doing
+ * work proportional to k rather than n for each matrix row
+ *
+ * @param n order of the matrix
+ * @param d pointer to the n diagonal entries
+ * @param e pointer to the n - 1 subdiagonal entries
+ * @param k number of eigenpairs, between 1 and n
+ * @param values receives the k largest eigenvalues in descending order
+ * @param z pointer to the row-major n x k output whose columns receive the eigenvectors
+ */
+void tridiagonalLargest(int n, const double *d, const double *e, int k, double *values, double *z);
+
+#endif
@@ -0,0 +1,664 @@
+#include<cmath>
+#include<vector>
+#include<algorithm>
+#include"factorizations.hpp"
+#include"kernels.hpp"
+#include"parallel.hpp"
+#include"tuning.hpp"
+
+// Columns factored together by the blocked Cholesky
+static const int CHOLESKY_BLOCK = 64;
+// Minimum number of rows handed to a thread by the trailing updates
+static const int UPDATE_GRAIN = 16;
+// Reflectors accumulated into one compact WY block by the QR factorization
+static const int QR_BLOCK = 32;
+
+bool isSymmetric(int n, const double *a) {
+    // Scale the tolerance by the largest magnitude in the matrix
+    double largest = 0;
+    for(long long i = 0; i < (long long) n * n; i++) largest = std::fmax(largest, std::fabs(a[i]));
+    double tolerance = largest * 1e-12;
+    // Compare every entry below the diagonal with its mirror
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < i; j++)
+            if(!(std::fabs(a[(long long) i * n + j] - a[(long long) j * n + i]) <= tolerance)) return false;
+    return true;
+}
+
+//////////////////////////////////////////
+//  Cholesky factorization
+//////////////////////////////////////////
+
+/**
+ * @brief Factors the diagonal block starting at k of size b with the unblocked
+ * algorithm, returning false if a pivot is not positive
+ */
+static bool choleskyDiagonal(int n, double *a, int k, int b) {
+    for(int j = k; j < k + b; j++) {
+        double *rowJ = a + (long long) j * n;
+        // The pivot is what remains of the diagonal after the previous columns
+        double pivot = rowJ[j] - vectorDot(j - k, rowJ + k, rowJ + k);
+        if(!(pivot > 0)) return false;
+        rowJ[j] = std::sqrt(pivot);
+        // Compute the rest of the column within the block
+        for(int i = j + 1; i < k + b; i++) {
+            double *rowI = a + (long long) i * n;
+            rowI[j] = (rowI[j] - vectorDot(j - k, rowI + k, rowJ + k)) / rowJ[j];
+        }
+    }
+    return true;
+}
+
+bool choleskyFactor(int n, double *a) {
+    for(int k = 0; k < n; k += CHOLESKY_BLOCK) {
+        int b = k + CHOLESKY_BLOCK < n ? CHOLESKY_BLOCK : n - k;
+        // Factor the diagonal block, stopping at the first non positive pivot
+        if(!choleskyDiagonal(n, a, k, b)) return false;
+        int start = k + b;
+        int remaining = n - start;
+        if(remaining == 0) break;
+        // Solve the panel below the diagonal block, one independent row at a time
+        parallelFor(start, n, UPDATE_GRAIN, [=](int lo, int hi) {
+            for(int i = lo; i < hi; i++) {
+                double *rowI = a + (long long) i * n;
+                for(int j = k; j < k + b; j++) {
+                    double *rowJ = a + (long long) j * n;
+                    rowI[j] = (rowI[j] - vectorDot(j - k, rowI + k, rowJ + k)) / rowJ[j];
+                }
+            }
+        });
+        // Subtract the panel's outer product from the lower trailing triangle.
+        // Rows are paired from both ends so every task gets a similar amount of work
+        int pairs = (remaining + 1) / 2;
+        parallelFor(0, pairs, UPDATE_GRAIN, [=](int lo, int hi) {
+            for(int t = lo; t < hi; t++) {
+                int rows[2] = { start + t, n - 1 - t };
+                int count = rows[0] == rows[1] ? 1 : 2;
+                for(int r = 0; r < count; r++) {
+                    double *rowI = a + (long long) rows[r] * n;
+                    for(int j = start; j <= rows[r]; j++)
+                        rowI[j] -= vectorDot(b, rowI + k, a + (long long) j * n + k);
+                }
+            }
+        });
+    }
+    // Clear the strict upper triangle so only L remains
+    for(int i = 0; i < n; i++)
+        for(int j = i + 1; j < n; j++) a[(long long) i * n + j] = 0;
+    return true;
+}
+
+void choleskySolve(int n, const double *l, int r, double *b) {
+    // Forward substitute L * Y = B one row of right hand sides at a time
+    for(int i = 0; i < n; i++) {
+        double *rowB = b + (long long) i * r;
+        for(int k = 0; k < i; k++) vectorAxpy(r, -l[(long long) i * n + k], b + (long long) k * r, rowB);
+        vectorScale(r, 1 / l[(long long) i * n + i], rowB);
+    }
+    // Back substitute L^T * X = Y
+    for(int i = n - 1; i >= 0; i--) {
+        double *rowB = b + (long long) i * r;
+        for(int k = i + 1; k < n; k++) vectorAxpy(r, -l[(long long) k * n + i], b + (long long) k * r, rowB);
+        vectorScale(r, 1 / l[(long long) i * n + i], rowB);
+    }
+}
+
+//////////////////////////////////////////
+//  LU factorization with partial pivoting
+//////////////////////////////////////////
+
+/**
+ * @brief Blocked right-looking LU shared by the float and double factorizations.
+ * Each panel is factored column by column, then the trailing matrix is updated
+ * with the panel's outer product, where nearly all the work is done
+ */
+template<typename T>
+static bool luFactorBlocked(int n, T *a, int *perm) {
+    for(int i = 0; i < n; i++) perm[i] = i;
+    // Panel width, and columns of the trailing matrix updated together so the rows of U being read stay in cache
+    TuningProfile profile = getTuningProfile();
+    int block = profile.luBlock, tile = profile.luTile;
+    std::vector<T> panel;
+    std::vector<int> pivots(block);
+    for(int k = 0; k < n; k += block) {
+        int b = std::min(block, n - k);
+        int height = n - k;
+        // Copy the panel of columns k to k + b column by column, so the pivot
+        // searches and eliminations below run down contiguous memory
+        panel.resize((long long) b * height);
+        for(int i = 0; i < height; i++)
+            for(int c = 0; c < b; c++) panel[(long long) c * height + i] = a[(long long) (k + i) * n + k + c];
+        for(int j = 0; j < b; j++) {
+            T *column = panel.data() + (long long) j * height;
+            int p = j;
+            for(int i = j + 1; i < height; i++)
+                if(std::fabs(column[i]) > std::fabs(column[p])) p = i;
+            T pivot = column[p];
+            if(pivot == 0 || !std::isfinite(pivot)) return false;
+            pivots[j] = p;
+            if(p != j)
+                for(int c = 0; c < b; c++) std::swap(panel[(long long) c * height + j], panel[(long long) c * height + p]);
+            for(int i = j + 1; i < height; i++) column[i] /= pivot;
+            for(int c = j + 1; c < b; c++) {
+                T *other = panel.data() + (long long) c * height;
+                T multiplier = other[j];
+                for(int i = j + 1; i < height; i++) other[i] -= multiplier * column[i];
+            }
+        }
+        for(int i = 0; i < height; i++)
+            for(int c = 0; c < b; c++) a[(long long) (k + i) * n + k + c] = panel[(long long) c * height + i];
+        // Apply the panel's row swaps to the columns on either side of it
+        for(int j = 0; j < b; j++) {
+            int p = pivots[j];
+            if(p == j) continue;
+            T *rowJ = a + (long long) (k + j) * n, *rowP = a + (long long) (k + p) * n;
+            std::swap_ranges(rowJ, rowJ + k, rowP);
+            std::swap_ranges(rowJ + k + b, rowJ + n, rowP + k + b);
+            std::swap(perm[k + j], perm[k + p]);
+        }
+        int start = k + b;
+        if(start == n) break;
+        // Solve the unit lower diagonal block for the rows of U right of the panel
+        for(int j = k; j < start; j++)
+            for(int i = j + 1; i < start; i++) {
+                T multiplier = a[(long long) i * n + j];
+                T *rowI = a + (long long) i * n, *rowJ = a + (long long) j * n;
+                for(int c = start; c < n; c++) rowI[c] -= multiplier * rowJ[c];
+            }
+        // Subtract the panel's outer product from the trailing matrix, one tile of columns at a time
+        parallelFor(start, n, UPDATE_GRAIN, [=](int lo, int hi) {
+            for(int c0 = start; c0 < n; c0 += tile) {
+                int c1 = std::min(n, c0 + tile);
+                for(int i = lo; i < hi; i++) {
+                    T *rowI = a + (long long) i * n;
+                    for(int j = k; j < start; j++) {
+                        T multiplier = rowI[j];
+                        const T *rowJ = a + (long long) j * n;
+                        for(int c = c0; c < c1; c++) rowI[c] -= multiplier * rowJ[c];
+                    }
+                }
+            }
+        });
+    }
+    return true;
+}
+
+/**
+ * @brief Permutes the right hand sides and substitutes with both factors
+ */
+template<typename T>
+static void luSolveBlocked(int n, const T *lu, const int *perm, int r, T *b) {
+    std::vector<T> permuted((long long) n * r);
+    for(int i = 0; i < n; i++) std::copy(b + (long long) perm[i] * r, b + (long long) (perm[i] + 1) * r, permuted.begin() + (long long) i * r);
+    // Forward substitute with the unit lower factor
+    for(int i = 0; i < n; i++) {
+        T *rowB = permuted.data() + (long long) i * r;
+        for(int k = 0; k < i; k++) {
+            T multiplier = lu[(long long) i * n + k];
+            const T *rowK = permuted.data() + (long long) k * r;
+            for(int c = 0; c < r; c++) rowB[c] -= multiplier * rowK[c];
+        }
+    }
+    // Back substitute with the upper factor
+    for(int i = n - 1; i >= 0; i--) {
+        T *rowB = permuted.data() + (long long) i * r;
+        for(int k = i + 1; k < n; k++) {
+            T multiplier = lu[(long long) i * n + k];
+            const T *rowK = permuted.data() + (long long) k * r;
+            for(int c = 0; c < r; c++) rowB[c] -= multiplier * rowK[c];
+        }
+        T pivot = lu[(long long) i * n + i];
+        for(int c = 0; c < r; c++) rowB[c] /= pivot;
+    }
+    std::copy(permuted.begin(), permuted.end(), b);
+}
+
+bool luFactor(int n, double *a, int *perm) {
+    return luFactorBlocked(n, a, perm);
+}
+
+bool luFactor(int n, float *a, int *perm) {
+    return luFactorBlocked(n, a, perm);
+}
+
+void luSolve(int n, const double *lu, const int *perm, int r, double *b) {
+    luSolveBlocked(n, lu, perm, r, b);
+}
+
+void luSolve(int n, const float *lu, const int *perm, int r, float *b) {
+    luSolveBlocked(n, lu, perm, r, b);
+}
+
+//////////////////////////////////////////
+//  Bunch-Kaufman LDL^T factorization
+//////////////////////////////////////////
+
+/**
+ * @brief Swaps index p and q of the symmetric matrix, exchanging whole rows and
+ * the columns of the trailing rows starting at k
+ */
+static void symmetricSwap(int n, double *a, int k, int p, int q) {
+    if(p == q) return;
+    for(int j = 0; j < n; j++) std::swap(a[(long long) p * n + j], a[(long long) q * n + j]);
+    for(int i = k; i < n; i++) std::swap(a[(long long) i * n + p], a[(long long) i * n + q]);
+}
+
+bool ldltFactor(int n, double *a, int *perm, int *pivots) {
+    // Bunch-Kaufman threshold balancing growth between 1x1 and 2x2 pivots
+    const double alpha = (1 + std::sqrt(17.0)) / 8;
+    for(int i = 0; i < n; i++) perm[i] = i;
+    int k = 0;
+    while(k < n) {
+        // Find the largest entry below the diagonal in column k
+        double diagonal = std::fabs(a[(long long) k * n + k]);
+        double columnMax = 0;
+        int imax = k;
+        for(int i = k + 1; i < n; i++)
+            if(std::fabs(a[(long long) i * n + k]) > columnMax) {
+                columnMax = std::fabs(a[(long long) i * n + k]);
+                imax = i;
+            }
+        // A zero column means the matrix is singular
+        if(!(std::fmax(diagonal, columnMax) > 0)) return false;
+        // Choose between a 1x1 pivot at k, a 1x1 pivot at imax, or a 2x2 pivot
+        int kp = k;
+        int step = 1;
+        if(diagonal < alpha * columnMax) {
+            double rowMax = 0;
+            for(int j = k; j < n; j++)
+                if(j != imax) rowMax = std::fmax(rowMax, std::fabs(a[(long long) imax * n + j]));
+            if(diagonal * rowMax >= alpha * columnMax * columnMax) kp = k;
+            else if(std::fabs(a[(long long) imax * n + imax]) >= alpha * rowMax) kp = imax;
+            else {
+                kp = imax;
+                step = 2;
+            }
+        }
+        // Bring the pivot into position, recording the interchange
+        int kk = k + step - 1;
+        if(kp != kk) {
+            symmetricSwap(n, a, k, kk, kp);
+            std::swap(perm[kk], perm[kp]);
+        }
+        int start = k + step;
+        if(step == 1) {
+            // Compute the column of L and apply the rank one update to the trailing matrix
+            double d = a[(long long) k * n + k];
+            std::vector<double> column(n);
+            for(int i = start; i < n; i++) column[i] = a[(long long) i * n + k];
+            parallelFor(start, n, UPDATE_GRAIN, [&](int lo, int hi) {
+                for(int i = lo; i < hi; i++) {
+                    double l = column[i] / d;
+                    vectorAxpy(n - start, -l, &column[start], a + (long long) i * n + start);
+                    a[(long long) i * n + k] = l;
+                }
+            });
+            pivots[k] = 1;
+        } else {
+            // Invert the 2x2 block and apply the rank two update to the trailing matrix
+            double d11 = a[(long long) k * n + k];
+            double d21 = a[(long long) (k + 1) * n + k];
+            double d22 = a[(long long) (k + 1) * n + k + 1];
+            double det = d11 * d22 - d21 * d21;
+            std::vector<double> first(n), second(n);
+            for(int i = start; i < n; i++) {
+                first[i] = a[(long long) i * n + k];
+                second[i] = a[(long long) i * n + k + 1];
+            }
+            parallelFor(start, n, UPDATE_GRAIN, [&](int lo, int hi) {
+                for(int i = lo; i < hi; i++) {
+                    double l1 = (d22 * first[i] - d21 * second[i]) / det;
+                    double l2 = (d11 * second[i] - d21 * first[i]) / det;
+                    double *row = a + (long long) i * n;
+                    vectorAxpy(n - start, -l1, &first[start], row + start);
+                    vectorAxpy(n - start, -l2, &second[start], row + start);
+                    row[k] = l1;
+                    row[k + 1] = l2;
+                }
+            });
+            pivots[k] = 2;
+            pivots[k + 1] = 2;
+        }
+        k += step;
+    }
+    // Clear the upper triangle, leaving D's diagonal in place
+    for(int i = 0; i < n; i++)
+        for(int j = i + 1; j < n; j++) a[(long long) i * n + j] = 0;
+    return true;
+}
+
+void ldltSolve(int n, const double *a, const int *perm, const int *pivots, int r, double *b) {
+    // Mark where each 2x2 block of D starts, its subdiagonal entry belongs to D rather than L
+    std::vector<bool> blockStart(n, false);
+    for(int i = 0; i < n; i += pivots[i]) blockStart[i] = pivots[i] == 2;
+    // Apply the permutation to the right hand sides
+    std::vector<double> x((long long) n * r);
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < r; j++) x[(long long) i * r + j] = b[(long long) perm[i] * r + j];
+    // Forward substitute through the unit lower factor
+    for(int i = 0; i < n; i++)
+        for(int k = 0; k < i; k++) {
+            if(k == i - 1 && blockStart[k]) continue;
+            vectorAxpy(r, -a[(long long) i * n + k], &x[(long long) k * r], &x[(long long) i * r]);
+        }
+    // Solve with the block diagonal D
+    for(int i = 0; i < n; i += pivots[i]) {
+        double *row = &x[(long long) i * r];
+        if(pivots[i] == 1) {
+            vectorScale(r, 1 / a[(long long) i * n + i], row);
+            continue;
+        }
+        // Solve the 2x2 block formed by rows i and i + 1
+        double d11 = a[(long long) i * n + i];
+        double d21 = a[(long long) (i + 1) * n + i];
+        double d22 = a[(long long) (i + 1) * n + i + 1];
+        double det = d11 * d22 - d21 * d21;
+        double *next = &x[(long long) (i + 1) * r];
+        for(int j = 0; j < r; j++) {
+            double first = row[j];
+            double second = next[j];
+            row[j] = (d22 * first - d21 * second) / det;
+            next[j] = (d11 * second - d21 * first) / det;
+        }
+    }
+    // Back substitute through the transposed unit lower factor
+    for(int i = n - 1; i >= 0; i--)
+        for(int k = i + 1; k < n; k++) {
+            if(k == i + 1 && blockStart[i]) continue;
+            vectorAxpy(r, -a[(long long) k * n + i], &x[(long long) k * r], &x[(long long) i * r]);
+        }
+    // Undo the permutation
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < r; j++) b[(long long) perm[i] * r + j] = x[(long long) i * r + j];
+}
+
+//////////////////////////////////////////
+//  Householder QR factorization
+//////////////////////////////////////////
+
+double householder(int len, double *x) {
+    double norm = len > 1 ? vectorNorm(len - 1, x + 1) : 0;
+    // Nothing to annihilate, the reflector is the identity
+    if(norm == 0) return 0;
+    double alpha = x[0];
+    // Choose the sign of beta opposite alpha to avoid cancellation
+    double beta = -std::copysign(std::hypot(alpha, norm), alpha);
+    double tau = (beta - alpha) / beta;
+    vectorScale(len - 1, 1 / (alpha - beta), x + 1);
+    x[0] = beta;
+    return tau;
+}
+
+/**
+ * @brief Factors a column-major rows x cols panel with unblocked Householder
+ * reflections, storing the reflectors below the diagonal
+ */
+static void panelFactor(int rows, int cols, double *p, double *tau) {
+    for(int c = 0; c < cols && c < rows; c++) {
+        double *column = p + (long long) c * rows + c;
+        int len = rows - c;
+        tau[c] = householder(len, column);
+        if(tau[c] == 0) continue;
+        // Apply the reflector to the remaining columns of the panel
+        double beta = column[0];
+        column[0] = 1;
+        for(int j = c + 1; j < cols; j++) {
+            double *other = p + (long long) j * rows + c;
+            double w = vectorDot(len, column, other);
+            vectorAxpy(len, -tau[c] * w, column, other);
+        }
+        column[0] = beta;
+    }
+}
+
+/**
+ * @brief Holds one block of reflectors in the forms needed to apply it as I - V * T * V^T
+ */
+struct ReflectorBlock {
+    /** Number of rows the reflectors span */
+    int rows;
+    /** Number of reflectors in the block */
+    int size;
+    /** Row-major rows x size matrix of reflectors with explicit unit diagonal */
+    std::vector<double> V;
+    /** Row-major size x rows transpose of V */
+    std::vector<double> Vt;
+    /** Row-major size x size upper triangular factor */
+    std::vector<double> T;
+};
+
+/**
+ * @brief Extracts the reflectors for columns [j, j + size) of a row-major factorization
+ * and builds the triangular factor T of their compact WY form
+ */
+static void buildBlock(int m, int n, const double *a, const double *tau, int j, int size, ReflectorBlock &block) {
+    int rows = m - j;
+    block.rows = rows;
+    block.size = size;
+    block.V.assign((long long) rows * size, 0);
+    block.Vt.assign((long long) size * rows, 0);
+    block.T.assign(size * size, 0);
+    // Copy the reflectors with their implicit unit entries made explicit
+    for(int i = 0; i < rows; i++)
+        for(int c = 0; c < size && c <= i; c++) {
+            double value = i == c ? 1 : a[(long long) (j + i) * n + j + c];
+            block.V[(long long) i * size + c] = value;
+            block.Vt[(long long) c * rows + i] = value;
+        }
+    // Build T column by column, T[0:c, c] = -tau_c * T[0:c, 0:c] * V[:, 0:c]^T * v_c
+    std::vector<double> z(size);
+    for(int c = 0; c < size; c++) {
+        block.T[c * size + c] = tau[j + c];
+        for(int p = 0; p < c; p++)
+            z[p] = vectorDot(rows - c, &block.Vt[(long long) p * rows + c], &block.Vt[(long long) c * rows + c]);
+        for(int p = 0; p < c; p++) {
+            double sum = 0;
+            for(int q = p; q < c; q++) sum += block.T[p * size + q] * z[q];
+            block.T[p * size + c] = -tau[j + c] * sum;
+        }
+    }
+}
+
+/**
+ * @brief Applies a block of reflectors to the row-major block.rows x cols matrix C,
+ * computing (I - V * T^T * V^T) * C when transpose is set and (I - V * T * V^T) * C otherwise
+ */
+static void applyBlock(ReflectorBlock &block, bool transpose, int cols, double *c, int ldc) {
+    int rows = block.rows;
+    int size = block.size;
+    if(cols == 0) return;
+    bool parallel = (long long) rows * cols * size > 1000000;
+    // W = V^T * C
+    std::vector<double> W((long long) size * cols, 0);
+    gemm(size, cols, rows, &block.Vt[0], rows, c, ldc, &W[0], cols, parallel);
+    // W = T^T * W or W = T * W, updating rows in an order that leaves inputs intact
+    std::vector<double> row(cols);
+    if(transpose) {
+        for(int i = size - 1; i >= 0; i--) {
+            for(int j = 0; j < cols; j++) row[j] = 0;
+            for(int k = 0; k <= i; k++) vectorAxpy(cols, block.T[k * size + i], &W[(long long) k * cols], &row[0]);
+            for(int j = 0; j < cols; j++) W[(long long) i * cols + j] = -row[j];
+        }
+    } else {
+        for(int i = 0; i < size; i++) {
+            for(int j = 0; j < cols; j++) row[j] = 0;
+            for(int k = i; k < size; k++) vectorAxpy(cols, block.T[i * size + k], &W[(long long) k * cols], &row[0]);
+            for(int j = 0; j < cols; j++) W[(long long) i * cols + j] = -row[j];
+        }
+    }
+    // C = C - V * W, with the sign already folded into W
+    gemm(rows, cols, size, &block.V[0], size, &W[0], cols, c, ldc, parallel);
+}
+
+void qrFactor(int m, int n, double *a, double *tau) {
+    int k = m < n ? m : n;
+    std::vector<double> panel;
+    ReflectorBlock block;
+    for(int j = 0; j < k; j += QR_BLOCK) {
+        int size = j + QR_BLOCK < k ? QR_BLOCK : k - j;
+        int rows = m - j;
+        // Factor the panel in column-major order so each column is contiguous
+        panel.assign((long long) rows * size, 0);
+        for(int i = 0; i < rows; i++)
+            for(int c = 0; c < size; c++) panel[(long long) c * rows + i] = a[(long long) (j + i) * n + j + c];
+        panelFactor(rows, size, &panel[0], tau + j);
+        for(int i = 0; i < rows; i++)
+            for(int c = 0; c < size; c++) a[(long long) (j + i) * n + j + c] = panel[(long long) c * rows + i];
+        // Apply the block of reflectors to the trailing columns
+        if(j + size < n) {
+            buildBlock(m, n, a, tau, j, size, block);
+            applyBlock(block, true, n - j - size, a + (long long) j * n + j + size, n);
+        }
+    }
+}
+
+void qrApplyTranspose(int m, int n, const double *a, const double *tau, int r, double *c) {
+    int k = m < n ? m : n;
+    ReflectorBlock block;
+    // Q^T applies the blocks of reflectors in the order they were generated
+    for(int j = 0; j < k; j += QR_BLOCK) {
+        int size = j + QR_BLOCK < k ? QR_BLOCK : k - j;
+        buildBlock(m, n, a, tau, j, size, block);
+        applyBlock(block, true, r, c + (long long) j * r, r);
+    }
+}
+
+void qrApply(int m, int n, const double *a, const double *tau, int r, double *c) {
+    int k = m < n ? m : n;
+    ReflectorBlock block;
+    // Q applies the blocks of reflectors in reverse order
+    int last = ((k - 1) / QR_BLOCK) * QR_BLOCK;
+    for(int j = last; j >= 0 && k > 0; j -= QR_BLOCK) {
+        int size = j + QR_BLOCK < k ? QR_BLOCK : k - j;
+        buildBlock(m, n, a, tau, j, size, block);
+        applyBlock(block, false, r, c + (long long) j * r, r);
+    }
+}
+
+void qrFormQ(int m, int n, const double *a, const double *tau, double *q) {
+    int k = m < n ? m : n;
+    // Start from the first k columns of the identity
+    for(long long i = 0; i < (long long) m * k; i++) q[i] = 0;
+    for(int i = 0; i < k; i++) q[(long long) i * k + i] = 1;
+    // Apply the blocks in reverse, columns before a block are untouched by it
+    ReflectorBlock block;
+    int last = ((k - 1) / QR_BLOCK) * QR_BLOCK;
+    for(int j = last; j >= 0 && k > 0; j -= QR_BLOCK) {
+        int size = j + QR_BLOCK < k ? QR_BLOCK : k - j;
+        buildBlock(m, n, a, tau, j, size, block);
+        applyBlock(block, false, k - j, q + (long long) j * k + j, k);
+    }
+}
+
+void qrPivotedFactor(int m, int n, double *a, double *tau, int *jpvt) {
+    int k = m < n ? m : n;
+    // Work on a column-major copy so every column is contiguous
+    std::vector<double> columns((long long) m * n);
+    for(int i = 0; i < m; i++)
+        for(int j = 0; j < n; j++) columns[(long long) j * m + i] = a[(long long) i * n + j];
+    // Track the partial column norms and their values at the last recomputation
+    std::vector<double> partial(n), original(n);
+    for(int j = 0; j < n; j++) {
+        jpvt[j] = j;
+        partial[j] = original[j] = vectorNorm(m, &columns[(long long) j * m]);
+    }
+    const double threshold = std::sqrt(2.220446049250313e-16);
+    for(int i = 0; i < k; i++) {
+        // Swap the remaining column of largest norm into position
+        int best = i;
+        for(int j = i + 1; j < n; j++)
+            if(partial[j] > partial[best]) best = j;
+        if(best != i) {
+            std::swap_ranges(columns.begin() + (long long) i * m, columns.begin() + (long long) (i + 1) * m, columns.begin() + (long long) best * m);
+            std::swap(jpvt[i], jpvt[best]);
+            std::swap(partial[i], partial[best]);
+            std::swap(original[i], original[best]);
+        }
+        // Generate the reflector and apply it to the remaining columns
+        double *column = &columns[(long long) i * m + i];
+        int len = m - i;
+        tau[i] = householder(len, column);
+        double beta = column[0];
+        column[0] = 1;
+        parallelFor(i + 1, n, UPDATE_GRAIN, [&](int lo, int hi) {
+            for(int j = lo; j < hi; j++) {
+                double *other = &columns[(long long) j * m + i];
+                if(tau[i] != 0) vectorAxpy(len, -tau[i] * vectorDot(len, column, other), column, other);
+                // Downdate the norm, recomputing it when cancellation makes the downdate unreliable
+                if(partial[j] == 0) continue;
+                double ratio = std::fabs(other[0]) / partial[j];
+                double remaining = std::fmax(0.0, 1 - ratio * ratio);
+                double drift = remaining * (partial[j] / original[j]) * (partial[j] / original[j]);
+                if(drift <= threshold) {
+                    partial[j] = original[j] = len > 1 ? vectorNorm(len - 1, other + 1) : 0;
+                } else partial[j] *= std::sqrt(remaining);
+            }
+        });
+        column[0] = beta;
+    }
+    // Copy the factorization back in row-major order
+    for(int i = 0; i < m; i++)
+        for(int j = 0; j < n; j++) a[(long long) i * n + j] = columns[(long long) j * m + i];
+}
+
+void tsqr(int m, int n, const double *a, double *r, double *q, int nrhs, double *b) {
+    // Split the rows into blocks of at least 2n rows, one per thread
+    int blocks = m / (2 * n);
+    if(blocks > getThreadCount()) blocks = getThreadCount();
+    if(blocks < 1) blocks = 1;
+    std::vector<int> starts(blocks + 1);
+    for(int p = 0; p <= blocks; p++) starts[p] = (long long) m * p / blocks;
+    // Factor each block of rows concurrently, stacking the R factors and reduced right hand sides
+    std::vector<std::vector<double>> factors(blocks), scales(blocks);
+    std::vector<double> stacked((long long) blocks * n * n, 0);
+    std::vector<double> stackedB((long long) blocks * n * (nrhs > 0 ? nrhs : 1), 0);
+    parallelFor(0, blocks, 1, [&](int lo, int hi) {
+        for(int p = lo; p < hi; p++) {
+            int rows = starts[p + 1] - starts[p];
+            factors[p].assign(a + (long long) starts[p] * n, a + (long long) starts[p + 1] * n);
+            scales[p].assign(n, 0);
+            qrFactor(rows, n, &factors[p][0], &scales[p][0]);
+            for(int i = 0; i < n; i++)
+                for(int j = i; j < n; j++) stacked[((long long) p * n + i) * n + j] = factors[p][(long long) i * n + j];
+            if(b != 0) {
+                double *block = b + (long long) starts[p] * nrhs;
+                qrApplyTranspose(rows, n, &factors[p][0], &scales[p][0], nrhs, block);
+                for(long long i = 0; i < (long long) n * nrhs; i++) stackedB[(long long) p * n * nrhs + i] = block[i];
+            }
+        }
+    });
+    // Factor the stacked R factors to get the final R
+    std::vector<double> stackedTau(n);
+    qrFactor(blocks * n, n, &stacked[0], &stackedTau[0]);
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++) r[(long long) i * n + j] = j >= i ? stacked[(long long) i * n + j] : 0;
+    // Reduce the right hand sides through the second level
+    if(b != 0) {
+        qrApplyTranspose(blocks * n, n, &stacked[0], &stackedTau[0], nrhs, &stackedB[0]);
+        for(long long i = 0; i < (long long) n * nrhs; i++) b[i] = stackedB[i];
+    }
+    // Q is each block's thin Q times its slice of the second level Q
+    if(q != 0) {
+        std::vector<double> top((long long) blocks * n * n);
+        qrFormQ(blocks * n, n, &stacked[0], &stackedTau[0], &top[0]);
+        parallelFor(0, blocks, 1, [&](int lo, int hi) {
+            for(int p = lo; p < hi; p++) {
+                int rows = starts[p + 1] - starts[p];
+                std::vector<double> local((long long) rows * n);
+                qrFormQ(rows, n, &factors[p][0], &scales[p][0], &local[0]);
+                double *out = q + (long long) starts[p] * n;
+                for(long long i = 0; i < (long long) rows * n; i++) out[i] = 0;
+                gemm(rows, n, n, &local[0], n, &top[(long long) p * n * n], n, out, n, false);
+            }
+        });
+    }
+}
+
+void upperTriangularSolve(int n, const double *u, int ldu, int r, double *b) {
+    // Back substitute one row of right hand sides at a time
+    for(int i = n - 1; i >= 0; i--) {
+        double *row = b + (long long) i * r;
+        for(int k = i + 1; k < n; k++) vectorAxpy(r, -u[(long long) i * ldu + k], b + (long long) k * r, row);
+        vectorScale(r, 1 / u[(long long) i * ldu + i], row);
+    }
+}
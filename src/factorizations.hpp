@@ -0,0 +1,206 @@
+#ifndef FACTORIZATIONS_HPP
+#define FACTORIZATIONS_HPP
+
+/**
+ * @brief Returns whether a row-major n x n matrix is symmetric to within a small
+ * tolerance relative to its largest entry
+ *
+ * @param n order of the matrix
+ * @param a pointer to the matrix
+ * @return true if the matrix is symmetric
+ */
+bool isSymmetric(int n, const double *a);
+
+/**
+ * @brief Factors a symmetric positive definite row-major matrix as L * L^T with a
+ * blocked right-looking algorithm. Only the lower triangle is read, it is
+ * overwritten with L and the strict upper triangle is set to zero
+ *
+ * @param n order of the matrix
+ * @param a pointer to the matrix
+ * @return true if the factorization succeeded, false as soon as a pivot is not positive
+ */
+bool choleskyFactor(int n, double *a);
+
+/**
+ * @brief Solves L * L^T * X = B in place for a factor produced by choleskyFactor
+ *
+ * @param n order of the factor
+ * @param l pointer to the row-major lower factor
+ * @param r number of right hand sides
+ * @param b pointer to the row-major n x r right hand sides, overwritten with X
+ */
+void choleskySolve(int n, const double *l, int r, double *b);
+
+/**
+ * @brief Factors a row-major n x n matrix as P * A = L * U with a blocked
+ * right-looking algorithm and partial pivoting. On return the strict lower
+ * triangle holds the unit lower factor L and the upper triangle holds U
+ *
+ * @param n order of the matrix
+ * @param a pointer to the matrix, overwritten with the factors
+ * @param perm receives the permutation, row i of P * A is row perm[i] of A
+ * @return true if the factorization succeeded, false at a zero or non-finite pivot
+ */
+bool luFactor(int n, double *a, int *perm);
+
+/**
+ * @brief Factors a row-major n x n single precision matrix as P * A = L * U,
+ * moving half the bytes of the double precision factorization and fitting twice
+ * as many values in each SIMD register
+ *
+ * @param n order of the matrix
+ * @param a pointer to the matrix, overwritten with the factors
+ * @param perm receives the permutation, row i of P * A is row perm[i] of A
+ * @return true if the factorization succeeded, false at a zero or non-finite pivot
+ */
+bool luFactor(int n, float *a, int *perm);
+
+/**
+ * @brief Solves A * X = B in place for a factorization produced by luFactor
+ *
+ * @param n order of the matrix
+ * @param lu pointer to the factored matrix
+ * @param perm permutation produced by luFactor
+ * @param r number of right hand sides
+ * @param b pointer to the row-major n x r right hand sides, overwritten with X
+ */
+void luSolve(int n, const double *lu, const int *perm, int r, double *b);
+
+/**
+ * @brief Solves A * X = B in place for a single precision factorization produced by luFactor
+ *
+ * @param n order of the matrix
+ * @param lu pointer to the factored matrix
+ * @param perm permutation produced by luFactor
+ * @param r number of right hand sides
+ * @param b pointer to the row-major n x r right hand sides, overwritten with X
+ */
+void luSolve(int n, const float *lu, const int *perm, int r, float *b);
+
+/**
+ * @brief Factors a symmetric row-major matrix as P * A * P^T = L * D * L^T using
+ * Bunch-Kaufman diagonal pivoting. On return the strict lower triangle holds the
+ * unit lower factor L, the diagonal and first subdiagonal hold the 1x1 and 2x2
+ * blocks of D, and the rest of the upper triangle is zero
+ *
+ * @param n order of the matrix
+ * @param a pointer to the full symmetric matrix
+ * @param perm receives the permutation, row i of P * A is row perm[i] of A
+ * @param pivots receives the size of the diagonal block each index belongs to
+ * @return true if the factorization succeeded, false if the matrix is singular
+ */
+bool ldltFactor(int n, double *a, int *perm, int *pivots);
+
+/**
+ * @brief Solves A * X = B in place for a factorization produced by ldltFactor
+ *
+ * @param n order of the matrix
+ * @param a pointer to the factored matrix
+ * @param perm permutation produced by ldltFactor
+ * @param pivots block sizes produced by ldltFactor
+ * @param r number of right hand sides
+ * @param b pointer to the row-major n x r right hand sides, overwritten with X
+ */
+void ldltSolve(int n, const double *a, const int *perm, const int *pivots, int r, double *b);
+
+/**
+ * @brief Generates a Householder reflector H = I - tau * v * v^T with H * x = beta * e1.
+ * On return x[0] holds beta and x[1..len) holds v below its implicit unit entry
+ *
+ * @param len length of x
+ * @param x pointer to the contiguous vector being reflected
+ * @return double the scale tau, zero when x is already a multiple of e1
+ */
+double householder(int len, double *x);
+
+/**
+ * @brief Factors a row-major m x n matrix as Q * R with blocked Householder
+ * reflections. Each block of reflectors is applied to the trailing columns in
+ * compact WY form, I - V * T * V^T, so the bulk of the work is matrix products.
+ * On return the upper triangle holds R and the reflectors are stored below the
+ * diagonal with an implicit unit leading entry
+ *
+ * @param m rows of the matrix
+ * @param n columns of the matrix
+ * @param a pointer to the matrix, overwritten with the factorization
+ * @param tau receives the min(m, n) reflector scales
+ */
+void qrFactor(int m, int n, double *a, double *tau);
+
+/**
+ * @brief Factors a row-major m x n matrix as A * P = Q * R with Householder
+ * reflections, choosing the remaining column of largest norm at every step so
+ * the magnitudes on the diagonal of R are non increasing. Storage matches qrFactor
+ *
+ * @param m rows of the matrix
+ * @param n columns of the matrix
+ * @param a pointer to the matrix, overwritten with the factorization
+ * @param tau receives the min(m, n) reflector scales
+ * @param jpvt receives the permutation, column j of A * P is column jpvt[j] of A
+ */
+void qrPivotedFactor(int m, int n, double *a, double *tau, int *jpvt);
+
+/**
+ * @brief Overwrites the row-major m x r matrix C with Q^T * C for a factorization from qrFactor
+ *
+ * @param m rows of the factored matrix
+ * @param n columns of the factored matrix
+ * @param a pointer to the factored matrix
+ * @param tau reflector scales from the factorization
+ * @param r columns of C
+ * @param c pointer to C
+ */
+void qrApplyTranspose(int m, int n, const double *a, const double *tau, int r, double *c);
+
+/**
+ * @brief Overwrites the row-major m x r matrix C with Q * C for a factorization from qrFactor
+ *
+ * @param m rows of the factored matrix
+ * @param n columns of the factored matrix
+ * @param a pointer to the factored matrix
+ * @param tau reflector scales from the factorization
+ * @param r columns of C
+ * @param c pointer to C
+ */
+void qrApply(int m, int n, const double *a, const double *tau, int r, double *c);
+
+/**
+ * @brief Builds the thin m x min(m, n) orthonormal factor Q from a factorization from qrFactor
+ *
+ * @param m rows of the factored matrix
+ * @param n columns of the factored matrix
+ * @param a pointer to the factored matrix
+ * @param tau reflector scales from the factorization
+ * @param q pointer to the row-major output, overwritten with Q
+ */
+void qrFormQ(int m, int n, const double *a, const double *tau, double *q);
+
+/**
+ * @brief Computes the QR factorization of a tall and skinny row-major matrix with
+ * the communication avoiding TSQR scheme. Blocks of rows are factored concurrently,
+ * their R factors are stacked and factored again, and the right hand sides are
+ * reduced alongside so Q never has to be formed to solve least squares problems
+ *
+ * @param m rows of the matrix, at least n
+ * @param n columns of the matrix
+ * @param a pointer to the matrix, left unchanged
+ * @param r pointer to the row-major n x n output, overwritten with R
+ * @param q pointer to the row-major m x n output for the thin Q, or null to skip forming it
+ * @param nrhs number of right hand sides
+ * @param b pointer to the row-major m x nrhs right hand sides, or null, whose first n rows are overwritten with those of Q^T * B
+ */
+void tsqr(int m, int n, const double *a, double *r, double *q, int nrhs, double *b);
+
+/**
+ * @brief Solves U * X = B in place for an upper triangular row-major matrix U
+ *
+ * @param n order of U
+ * @param u pointer to U
+ * @param ldu leading dimension of U
+ * @param r number of right hand sides
+ * @param b pointer to the row-major n x r right hand sides, overwritten with X
+ */
+void upperTriangularSolve(int n, const double *u, int ldu, int r, double *b);
+
+#endif
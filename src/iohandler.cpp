@@ -83,12 +83,13 @@ void readMtx(std::string filepath, int &m, int &n, std::vector<std::vector<doubl
     if(idx - 1 != m) Logger::logInvalidInput(filepath);
 }
 
-void writeMtx(std::string filepath, std::vector<std::vector<double>> &matrix){
+void writeMtx(std::string filepath, const std::vector<std::vector<double>> &matrix){
     // Get the dimensions of the matrix provided
     int m = matrix.size();
     int n = matrix[0].size();
     // Open the file to write to
     std::ofstream file(filepath + ".mtx");
+    if(!file.good()) Logger::logInvalidOutput(filepath + ".mtx");
     // Output the row and column dimensions
     file << m << ":" << n;
     // Loop through and output values
@@ -99,6 +100,7 @@ void writeMtx(std::string filepath, std::vector<std::vector<double>> &matrix){
             // Otherwise just output the separator and the value
             else file << ":" << matrix[i][j];
     }
-    // Close the file pointer
+    // Close the file pointer, reporting any write that failed
     file.close();
+    if(file.fail()) Logger::logInvalidOutput(filepath + ".mtx");
 }
\ No newline at end of file
@@ -19,8 +19,10 @@ void readHeader(std::string line, std::string filepath, int &m, int &n);
  * 
  * @param line line of matrix values to parse
  * @param matrix matrix that we are adding row to
+ * @param filepath filepath used to report invalid input
+ * @param n number of values the row must hold
  */
-void readRow(std::string line, std::vector<std::vector<double>> &matrix, std::string filepath);
+void readRow(std::string line, std::vector<std::vector<double>> &matrix, std::string filepath, int n);
 
 /**
  * @brief Populates the provided references with information from
@@ -34,11 +36,12 @@ void readRow(std::string line, std::vector<std::vector<double>> &matrix, std::st
 void readMtx(std::string filepath, int &m, int &n, std::vector<std::vector<double>> &matrix);
 
 /**
- * @brief Writes a provided matrix to the provided filepath
+ * @brief Writes a provided matrix to the provided filepath, throwing if the
+ * file cannot be written
  * 
  * @param filepath filepath to write matrix to
  * @param matrix matrix to write to file
  */
-void writeMtx(std::string filepath, std::vector<std::vector<double>> &matrix);
+void writeMtx(std::string filepath, const std::vector<std::vector<double>> &matrix);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include<cmath>
+#include<atomic>
+#include<vector>
+#include"kernels.hpp"
+#include"parallel.hpp"
+#include"tuning.hpp"
+
+// Independent accumulators used by reductions so they vectorize without reassociation
+static const int LANES = 8;
+// Minimum number of values handed to a thread by the matrix-vector kernels
+static const int VECTOR_GRAIN = 1 << 15;
+
+// Whether large square products may use Strassen-Winograd, off unless a caller opts in
+static std::atomic<bool> strassenEnabled(false);
+
+void setStrassenEnabled(bool enabled) {
+    strassenEnabled = enabled;
+}
+
+bool getStrassenEnabled() {
+    return strassenEnabled;
+}
+
+void setStrassenCrossover(int size) {
+    // The crossover lives in the tuning profile alongside the block sizes
+    TuningProfile profile = getTuningProfile();
+    profile.strassenCrossover = size < 16 ? 16 : size;
+    setTuningProfile(profile);
+}
+
+int getStrassenCrossover() {
+    return getTuningProfile().strassenCrossover;
+}
+
+//////////////////////////////////////////
+//  Classical blocked kernel
+//////////////////////////////////////////
+
+/**
+ * @brief Accumulates rows [rowBegin, rowEnd) of C += A * B
+ */
+static void gemmRows(int rowBegin, int rowEnd, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc, int depthBlock, int columnBlock) {
+    // Walk the shared dimension and columns in cache sized blocks
+    for(int kk = 0; kk < k; kk += depthBlock) {
+        int kEnd = kk + depthBlock < k ? kk + depthBlock : k;
+        for(int jj = 0; jj < n; jj += columnBlock) {
+            int jEnd = jj + columnBlock < n ? jj + columnBlock : n;
+            for(int i = rowBegin; i < rowEnd; i++) {
+                double *out = c + (long long) i * ldc;
+                // Scale each row of B by one value of A and add it into the row of C
+                for(int p = kk; p < kEnd; p++) {
+                    double value = a[(long long) i * lda + p];
+                    const double *row = b + (long long) p * ldb;
+                    for(int j = jj; j < jEnd; j++) out[j] += value * row[j];
+                }
+            }
+        }
+    }
+}
+
+void gemm(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc, bool parallel) {
+    // Take the block sizes once so the whole product uses the same ones
+    TuningProfile profile = getTuningProfile();
+    int rowBlock = profile.rowBlock, depthBlock = profile.depthBlock, columnBlock = profile.columnBlock;
+    // Run serially when asked or when the product is too small to split
+    if(!parallel) {
+        gemmRows(0, m, n, k, a, lda, b, ldb, c, ldc, depthBlock, columnBlock);
+        return;
+    }
+    // Otherwise hand blocks of rows of C to separate threads, smaller ones when there
+    // are too few rows to give every thread a block
+    int threads = getThreadCount();
+    int share = (m + threads - 1) / threads;
+    if(share < rowBlock) rowBlock = share > 1 ? share : 1;
+    int blocks = (m + rowBlock - 1) / rowBlock;
+    parallelFor(0, blocks, 1, [=](int lo, int hi) {
+        int rowEnd = hi * rowBlock < m ? hi * rowBlock : m;
+        gemmRows(lo * rowBlock, rowEnd, n, k, a, lda, b, ldb, c, ldc, depthBlock, columnBlock);
+    });
+}
+
+//////////////////////////////////////////
+//  Strassen-Winograd kernel
+//////////////////////////////////////////
+
+/**
+ * @brief Runs body(lo, hi) over the rows of an h x h block, split across threads
+ * in runs of at least the profile's parallel threshold when parallel is set
+ */
+template<typename F>
+static void forRows(int h, bool parallel, F body) {
+    if(!parallel) {
+        body(0, h);
+        return;
+    }
+    int grain = getTuningProfile().parallelValues / h;
+    parallelFor(0, h, grain > 1 ? grain : 1, body);
+}
+
+/**
+ * @brief Z = X + Y for h x h blocks
+ */
+static void addBlock(int h, const double *x, int ldx, const double *y, int ldy, double *z, int ldz, bool parallel) {
+    forRows(h, parallel, [=](int lo, int hi) {
+        for(int i = lo; i < hi; i++)
+            for(int j = 0; j < h; j++)
+                z[(long long) i * ldz + j] = x[(long long) i * ldx + j] + y[(long long) i * ldy + j];
+    });
+}
+
+/**
+ * @brief Z = X - Y for h x h blocks
+ */
+static void subtractBlock(int h, const double *x, int ldx, const double *y, int ldy, double *z, int ldz, bool parallel) {
+    forRows(h, parallel, [=](int lo, int hi) {
+        for(int i = lo; i < hi; i++)
+            for(int j = 0; j < h; j++)
+                z[(long long) i * ldz + j] = x[(long long) i * ldx + j] - y[(long long) i * ldy + j];
+    });
+}
+
+/**
+ * @brief Returns the workspace a Strassen-Winograd product of size n needs,
+ * three h x h temporaries per level of recursion
+ */
+static long long workspaceSize(int n, int crossover) {
+    long long total = 0;
+    while(n > crossover) {
+        n /= 2;
+        total += 3LL * n * n;
+    }
+    return total;
+}
+
+/**
+ * @brief Computes C = A * B for n x n blocks with Strassen-Winograd. n must halve
+ * evenly down to the crossover. The seven products are scheduled so that only
+ * three h x h temporaries are live per level, with the quadrants of C holding
+ * partial results in between. When parallel is set, the products at the
+ * crossover and the block sums each use every thread in turn
+ */
+static void winograd(int n, const double *a, int lda, const double *b, int ldb, double *c, int ldc, double *work, int crossover, bool parallel) {
+    // At the crossover compute the product with the classical kernel
+    if(n <= crossover) {
+        forRows(n, parallel, [=](int lo, int hi) {
+            for(int i = lo; i < hi; i++)
+                for(int j = 0; j < n; j++) c[(long long) i * ldc + j] = 0;
+        });
+        gemm(n, n, n, a, lda, b, ldb, c, ldc, parallel);
+        return;
+    }
+    // Locate the quadrants of each operand
+    int h = n / 2;
+    const double *a11 = a, *a12 = a + h, *a21 = a + (long long) h * lda, *a22 = a21 + h;
+    const double *b11 = b, *b12 = b + h, *b21 = b + (long long) h * ldb, *b22 = b21 + h;
+    double *c11 = c, *c12 = c + h, *c21 = c + (long long) h * ldc, *c22 = c21 + h;
+    // Take this level's temporaries from the front of the workspace
+    double *x = work, *y = work + (long long) h * h, *z = work + 2LL * h * h;
+    double *rest = work + 3LL * h * h;
+    // P7 = (A11 - A21) * (B22 - B12) into C21
+    subtractBlock(h, a11, lda, a21, lda, x, h, parallel);
+    subtractBlock(h, b22, ldb, b12, ldb, y, h, parallel);
+    winograd(h, x, h, y, h, c21, ldc, rest, crossover, parallel);
+    // P5 = (A21 + A22) * (B12 - B11) into C22
+    addBlock(h, a21, lda, a22, lda, x, h, parallel);
+    subtractBlock(h, b12, ldb, b11, ldb, y, h, parallel);
+    winograd(h, x, h, y, h, c22, ldc, rest, crossover, parallel);
+    // P6 = (S1 - A11) * (B22 - T1) into C12
+    subtractBlock(h, x, h, a11, lda, x, h, parallel);
+    subtractBlock(h, b22, ldb, y, h, y, h, parallel);
+    winograd(h, x, h, y, h, c12, ldc, rest, crossover, parallel);
+    // P1 = A11 * B11 into Z, with S4 = A12 - S2 prepared in X
+    subtractBlock(h, a12, lda, x, h, x, h, parallel);
+    winograd(h, a11, lda, b11, ldb, z, h, rest, crossover, parallel);
+    // Combine into U2 = P1 + P6, U3 = U2 + P7, U4 = U2 + P5 and U7 = U3 + P5
+    addBlock(h, c12, ldc, z, h, c12, ldc, parallel);
+    addBlock(h, c21, ldc, c12, ldc, c21, ldc, parallel);
+    addBlock(h, c12, ldc, c22, ldc, c12, ldc, parallel);
+    addBlock(h, c22, ldc, c21, ldc, c22, ldc, parallel);
+    // P3 = S4 * B22 into C11, then C12 = U4 + P3
+    winograd(h, x, h, b22, ldb, c11, ldc, rest, crossover, parallel);
+    addBlock(h, c12, ldc, c11, ldc, c12, ldc, parallel);
+    // P4 = A22 * (T2 - B21) into C11, then C21 = U3 - P4
+    subtractBlock(h, y, h, b21, ldb, y, h, parallel);
+    winograd(h, a22, lda, y, h, c11, ldc, rest, crossover, parallel);
+    subtractBlock(h, c21, ldc, c11, ldc, c21, ldc, parallel);
+    // P2 = A12 * B21 into C11, then C11 = P1 + P2
+    winograd(h, a12, lda, b21, ldb, c11, ldc, rest, crossover, parallel);
+    addBlock(h, c11, ldc, z, h, c11, ldc, parallel);
+}
+
+/**
+ * @brief Computes C = A * B for n x n matrices with Strassen-Winograd, padding
+ * with zeros up to the nearest size that halves evenly down to the crossover
+ */
+static void strassen(int n, const double *a, const double *b, double *c, int crossover) {
+    // Count the levels of recursion and the padded size they require
+    int levels = 0;
+    int base = n;
+    while(base > crossover) {
+        base = (base + 1) / 2;
+        levels++;
+    }
+    int padded = base << levels;
+    // Copy into zero padded operands when the size does not halve evenly
+    std::vector<double> paddedA, paddedB, paddedC;
+    const double *left = a, *right = b;
+    double *out = c;
+    if(padded != n) {
+        paddedA.assign((long long) padded * padded, 0);
+        paddedB.assign((long long) padded * padded, 0);
+        paddedC.assign((long long) padded * padded, 0);
+        for(int i = 0; i < n; i++)
+            for(int j = 0; j < n; j++) {
+                paddedA[(long long) i * padded + j] = a[(long long) i * n + j];
+                paddedB[(long long) i * padded + j] = b[(long long) i * n + j];
+            }
+        left = &paddedA[0];
+        right = &paddedB[0];
+        out = &paddedC[0];
+    }
+    // Every thread works on each sub-product in turn, so one workspace serves them all
+    std::vector<double> workspace(workspaceSize(padded, crossover));
+    winograd(padded, left, padded, right, padded, out, padded, &workspace[0], crossover, getThreadCount() > 1);
+    // Copy the result out of the padded product
+    if(padded != n)
+        for(int i = 0; i < n; i++)
+            for(int j = 0; j < n; j++) c[(long long) i * n + j] = out[(long long) i * padded + j];
+}
+
+void multiply(int m, int n, int k, const double *a, const double *b, double *c) {
+    // Use Strassen-Winograd for large square operands when enabled
+    int crossover = getStrassenCrossover();
+    if(strassenEnabled && m == n && n == k && n > crossover) {
+        strassen(n, a, b, c, crossover);
+        return;
+    }
+    // Otherwise accumulate into a zeroed C with the classical kernel
+    for(long long i = 0; i < (long long) m * n; i++) c[i] = 0;
+    gemm(m, n, k, a, k, b, n, c, n, (long long) m * n * k > 1000000);
+}
+
+//////////////////////////////////////////
+//  Vector kernels
+//////////////////////////////////////////
+
+double vectorDot(int n, const double *x, const double *y) {
+    // Accumulate into independent lanes which the compiler maps onto SIMD registers
+    double acc[LANES] = { 0 };
+    int i = 0;
+    for(; i + LANES <= n; i += LANES)
+        for(int l = 0; l < LANES; l++) acc[l] += x[i + l] * y[i + l];
+    // Add the remainder and fold the lanes together
+    double total = 0;
+    for(; i < n; i++) total += x[i] * y[i];
+    for(int l = 0; l < LANES; l++) total += acc[l];
+    return total;
+}
+
+void vectorAxpy(int n, double alpha, const double *x, double *y) {
+    for(int i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+void vectorScale(int n, double alpha, double *x) {
+    for(int i = 0; i < n; i++) x[i] *= alpha;
+}
+
+double vectorNorm(int n, const double *x) {
+    // Find the largest magnitude to scale by
+    double acc[LANES] = { 0 };
+    int i = 0;
+    for(; i + LANES <= n; i += LANES)
+        for(int l = 0; l < LANES; l++) acc[l] = std::fmax(acc[l], std::fabs(x[i + l]));
+    double scale = 0;
+    for(; i < n; i++) scale = std::fmax(scale, std::fabs(x[i]));
+    for(int l = 0; l < LANES; l++) scale = std::fmax(scale, acc[l]);
+    // A zero or non-finite scale is already the answer
+    if(scale == 0 || !std::isfinite(scale)) return scale;
+    // Sum the squares of the scaled values
+    double inverse = 1 / scale;
+    for(int l = 0; l < LANES; l++) acc[l] = 0;
+    for(i = 0; i + LANES <= n; i += LANES)
+        for(int l = 0; l < LANES; l++) {
+            double value = x[i + l] * inverse;
+            acc[l] += value * value;
+        }
+    double total = 0;
+    for(; i < n; i++) total += (x[i] * inverse) * (x[i] * inverse);
+    for(int l = 0; l < LANES; l++) total += acc[l];
+    return scale * std::sqrt(total);
+}
+
+void gemv(int m, int n, const double *const *rows, const double *x, double *y) {
+    // Each output is an independent dot product, so split the rows across threads
+    int grain = n > 0 ? VECTOR_GRAIN / n + 1 : m;
+    parallelFor(0, m, grain, [=](int lo, int hi) {
+        for(int i = lo; i < hi; i++) y[i] = vectorDot(n, rows[i], x);
+    });
+}
+
+void gemvTranspose(int m, int n, const double *const *rows, const double *x, double *y) {
+    // Split the columns across threads, each accumulating scaled rows into its slice of y
+    int grain = m > 0 ? VECTOR_GRAIN / m + 1 : n;
+    parallelFor(0, n, grain, [=](int lo, int hi) {
+        for(int j = lo; j < hi; j++) y[j] = 0;
+        for(int i = 0; i < m; i++) vectorAxpy(hi - lo, x[i], rows[i] + lo, y + lo);
+    });
+}
+
+void ger(int m, int n, double alpha, const double *x, const double *y, double *const *rows) {
+    // Every row receives its own scaled copy of y, so split the rows across threads
+    int grain = n > 0 ? VECTOR_GRAIN / n + 1 : m;
+    parallelFor(0, m, grain, [=](int lo, int hi) {
+        for(int i = lo; i < hi; i++) vectorAxpy(n, alpha * x[i], y, rows[i]);
+    });
+}
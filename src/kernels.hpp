@@ -0,0 +1,145 @@
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+/**
+ * @brief Enables or disables the Strassen-Winograd path for large square products.
+ * The classical kernel computes every entry with an error below n * u * |A| * |B|
+ * (u the unit roundoff, absolute values taken elementwise). Strassen-Winograd only
+ * satisfies the normwise bound
+ *
+ *     max|C - AB| <= ((n / n0)^log2(18) * (n0^2 + 5 * n0) - 5 * n) * u * max|A| * max|B|
+ *
+ * where n0 is the crossover size, so small entries of C may lose relative accuracy.
+ * Disabled by default, so products stay classical unless a caller opts in
+ *
+ * @param enabled true to allow Strassen-Winograd, false to always use the classical kernel
+ */
+void setStrassenEnabled(bool enabled);
+
+/**
+ * @brief Returns whether the Strassen-Winograd path is enabled
+ *
+ * @return true if large square products may use Strassen-Winograd
+ */
+bool getStrassenEnabled();
+
+/**
+ * @brief Sets the size at or below which Strassen-Winograd recursion hands
+ * sub-products to the classical blocked kernel, in the active tuning profile
+ *
+ * @param size crossover size, values below 16 are raised to 16
+ */
+void setStrassenCrossover(int size);
+
+/**
+ * @brief Returns the Strassen-Winograd crossover size
+ *
+ * @return int crossover size
+ */
+int getStrassenCrossover();
+
+/**
+ * @brief Accumulates C += A * B using the classical cache blocked kernel. All
+ * matrices are row-major with the given leading dimensions
+ *
+ * @param m rows of A and C
+ * @param n columns of B and C
+ * @param k columns of A and rows of B
+ * @param a pointer to A
+ * @param lda leading dimension of A
+ * @param b pointer to B
+ * @param ldb leading dimension of B
+ * @param c pointer to C
+ * @param ldc leading dimension of C
+ * @param parallel whether row blocks of C may be computed concurrently
+ */
+void gemm(int m, int n, int k, const double *a, int lda, const double *b, int ldb, double *c, int ldc, bool parallel);
+
+/**
+ * @brief Computes C = A * B for row-major contiguous matrices, choosing
+ * Strassen-Winograd for large square operands when enabled and the classical
+ * blocked kernel otherwise
+ *
+ * @param m rows of A and C
+ * @param n columns of B and C
+ * @param k columns of A and rows of B
+ * @param a pointer to A
+ * @param b pointer to B
+ * @param c pointer to C, overwritten with the product
+ */
+void multiply(int m, int n, int k, const double *a, const double *b, double *c);
+
+/**
+ * @brief Returns the dot product of two contiguous vectors
+ *
+ * @param n length of the vectors
+ * @param x pointer to the first vector
+ * @param y pointer to the second vector
+ * @return double sum of x[i] * y[i]
+ */
+double vectorDot(int n, const double *x, const double *y);
+
+/**
+ * @brief Accumulates y += alpha * x for contiguous vectors
+ *
+ * @param n length of the vectors
+ * @param alpha scale applied to x
+ * @param x pointer to the vector being added
+ * @param y pointer to the vector being updated
+ */
+void vectorAxpy(int n, double alpha, const double *x, double *y);
+
+/**
+ * @brief Scales a contiguous vector in place, x *= alpha
+ *
+ * @param n length of the vector
+ * @param alpha scale to apply
+ * @param x pointer to the vector
+ */
+void vectorScale(int n, double alpha, double *x);
+
+/**
+ * @brief Returns the Euclidean norm of a contiguous vector, scaling by the
+ * largest magnitude first so the squares can neither overflow nor underflow
+ *
+ * @param n length of the vector
+ * @param x pointer to the vector
+ * @return double square root of the sum of squares
+ */
+double vectorNorm(int n, const double *x);
+
+/**
+ * @brief Computes y = A * x where row i of A starts at rows[i]
+ *
+ * @param m rows of A
+ * @param n columns of A
+ * @param rows pointers to the start of each row of A
+ * @param x pointer to the vector of length n
+ * @param y pointer to the vector of length m, overwritten with the product
+ */
+void gemv(int m, int n, const double *const *rows, const double *x, double *y);
+
+/**
+ * @brief Computes y = A^T * x where row i of A starts at rows[i]
+ *
+ * @param m rows of A
+ * @param n columns of A
+ * @param rows pointers to the start of each row of A
+ * @param x pointer to the vector of length m
+ * @param y pointer to the vector of length n, overwritten with the product
+ */
+void gemvTranspose(int m, int n, const double *const *rows, const double *x, double *y);
+
+/**
+ * @brief Accumulates the rank one update A += alpha * x * y^T where row i of A starts at rows[i]
+ *
+ * @param m rows of A
+ * @param n columns of A
+ * @param alpha scale applied to the update
+ * @param x pointer to the vector of length m
+ * @param y pointer to the vector of length n
+ * @param rows pointers to the start of each row of A
+ */
+void ger(int m, int n, double alpha, const double *x, const double *y, double *const *rows);
+
+#endif
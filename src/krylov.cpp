@@ -0,0 +1,385 @@
+#include<cmath>
+#include<string>
+#include<vector>
+#include<algorithm>
+#include"krylov.hpp"
+#include"kernels.hpp"
+
+//////////////////////////////////////////
+//  Linear operators
+//////////////////////////////////////////
+
+MatrixOperator::MatrixOperator(Matrix &a) : matrix(a) {
+    if(a.rows() != a.columns()) Logger::logInvalidIterative(a.getFilePath());
+}
+
+int MatrixOperator::size() {
+    return matrix.rows();
+}
+
+void MatrixOperator::apply(const double *x, double *y) {
+    // Gather the row pointers of the matrix for the kernel
+    int n = matrix.rows();
+    std::vector<const double*> rows(n);
+    for(int i = 0; i < n; i++) rows[i] = matrix.rowData(i + 1);
+    gemv(n, n, rows.data(), x, y);
+}
+
+SparseOperator::SparseOperator(SparseMatrix &a) : matrix(a) {
+    if(a.m != a.n) Logger::logInvalidIterative(a.fp);
+}
+
+int SparseOperator::size() {
+    return matrix.m;
+}
+
+void SparseOperator::apply(const double *x, double *y) {
+    matrix.multiply(x, y);
+}
+
+FunctionOperator::FunctionOperator(int size, std::function<void(const double*, double*)> function) {
+    n = size;
+    product = function;
+}
+
+int FunctionOperator::size() {
+    return n;
+}
+
+void FunctionOperator::apply(const double *x, double *y) {
+    product(x, y);
+}
+
+//////////////////////////////////////////
+//  Preconditioners
+//////////////////////////////////////////
+
+JacobiPreconditioner::JacobiPreconditioner(Matrix &a) {
+    if(a.rows() != a.columns()) Logger::logInvalidIterative(a.getFilePath());
+    for(int i = 1; i <= a.rows(); i++) {
+        if(a(i, i) == 0) Logger::logInvalidIterative(a.getFilePath());
+        inverse.push_back(1 / a(i, i));
+    }
+}
+
+JacobiPreconditioner::JacobiPreconditioner(SparseMatrix &a) {
+    if(a.m != a.n) Logger::logInvalidIterative(a.fp);
+    for(int i = 1; i <= a.m; i++) {
+        double value = a.access(i, i);
+        if(value == 0) Logger::logInvalidIterative(a.fp);
+        inverse.push_back(1 / value);
+    }
+}
+
+void JacobiPreconditioner::apply(const double *r, double *z) {
+    for(int i = 0; i < inverse.size(); i++) z[i] = r[i] * inverse[i];
+}
+
+IncompleteLU::IncompleteLU(SparseMatrix &a) {
+    if(a.m != a.n) Logger::logInvalidIterative(a.fp);
+    n = a.n;
+    rowStart = a.rowStart;
+    columnIndex = a.columnIndex;
+    values = a.values;
+    // Find each row's diagonal, which the factorization divides by
+    diagonal.resize(n);
+    for(int i = 0; i < n; i++) {
+        std::vector<int>::iterator found = std::lower_bound(columnIndex.begin() + rowStart[i], columnIndex.begin() + rowStart[i + 1], i);
+        if(found == columnIndex.begin() + rowStart[i + 1] || *found != i) Logger::logInvalidIterative(a.fp);
+        diagonal[i] = found - columnIndex.begin();
+    }
+    // Eliminate row by row, updating only the positions already in the pattern
+    std::vector<int> position(n, -1);
+    for(int i = 0; i < n; i++) {
+        for(int k = rowStart[i]; k < rowStart[i + 1]; k++) position[columnIndex[k]] = k;
+        for(int k = rowStart[i]; k < diagonal[i]; k++) {
+            int pivotRow = columnIndex[k];
+            if(values[diagonal[pivotRow]] == 0) Logger::logInvalidIterative(a.fp);
+            double multiplier = values[k] /= values[diagonal[pivotRow]];
+            for(int j = diagonal[pivotRow] + 1; j < rowStart[pivotRow + 1]; j++)
+                if(position[columnIndex[j]] >= 0) values[position[columnIndex[j]]] -= multiplier * values[j];
+        }
+        for(int k = rowStart[i]; k < rowStart[i + 1]; k++) position[columnIndex[k]] = -1;
+        if(values[diagonal[i]] == 0) Logger::logInvalidIterative(a.fp);
+    }
+}
+
+void IncompleteLU::apply(const double *r, double *z) {
+    // Forward substitution with the unit lower factor
+    for(int i = 0; i < n; i++) {
+        double sum = r[i];
+        for(int k = rowStart[i]; k < diagonal[i]; k++) sum -= values[k] * z[columnIndex[k]];
+        z[i] = sum;
+    }
+    // Back substitution with the upper factor
+    for(int i = n - 1; i >= 0; i--) {
+        double sum = z[i];
+        for(int k = diagonal[i] + 1; k < rowStart[i + 1]; k++) sum -= values[k] * z[columnIndex[k]];
+        z[i] = sum / values[diagonal[i]];
+    }
+}
+
+IncompleteCholesky::IncompleteCholesky(SparseMatrix &a) {
+    if(a.m != a.n) Logger::logInvalidIterative(a.fp);
+    n = a.n;
+    // Keep the lower triangle, whose rows must each end with a diagonal value
+    rowStart.push_back(0);
+    for(int i = 0; i < n; i++) {
+        for(int k = a.rowStart[i]; k < a.rowStart[i + 1] && a.columnIndex[k] <= i; k++) {
+            columnIndex.push_back(a.columnIndex[k]);
+            values.push_back(a.values[k]);
+        }
+        if(values.size() == rowStart.back() || columnIndex.back() != i) Logger::logInvalidIterative(a.fp);
+        rowStart.push_back(values.size());
+    }
+    // Compute each row of L from the rows above it, restricted to the pattern
+    for(int i = 0; i < n; i++) {
+        int last = rowStart[i + 1] - 1;
+        for(int k = rowStart[i]; k <= last; k++) {
+            int j = columnIndex[k];
+            // Subtract the dot product of the parts of rows i and j left of column j
+            double sum = values[k];
+            int p = rowStart[i], q = rowStart[j];
+            while(p < k && q < rowStart[j + 1] - 1) {
+                if(columnIndex[p] < columnIndex[q]) p++;
+                else if(columnIndex[p] > columnIndex[q]) q++;
+                else sum -= values[p++] * values[q++];
+            }
+            if(k < last) values[k] = sum / values[rowStart[j + 1] - 1];
+            else {
+                if(!(sum > 0)) Logger::logInvalidIterative(a.fp);
+                values[k] = std::sqrt(sum);
+            }
+        }
+    }
+}
+
+void IncompleteCholesky::apply(const double *r, double *z) {
+    // Forward substitution with L
+    for(int i = 0; i < n; i++) {
+        double sum = r[i];
+        int last = rowStart[i + 1] - 1;
+        for(int k = rowStart[i]; k < last; k++) sum -= values[k] * z[columnIndex[k]];
+        z[i] = sum / values[last];
+    }
+    // Back substitution with L^T, walking the rows of L as columns
+    for(int i = n - 1; i >= 0; i--) {
+        int last = rowStart[i + 1] - 1;
+        z[i] /= values[last];
+        for(int k = rowStart[i]; k < last; k++) z[columnIndex[k]] -= values[k] * z[i];
+    }
+}
+
+//////////////////////////////////////////
+//  Krylov solvers
+//////////////////////////////////////////
+
+/**
+ * @brief Applies the preconditioner, or copies the vector when there is none
+ */
+static void precondition(Preconditioner *m, int n, const double *r, double *z) {
+    if(m) m->apply(r, z);
+    else std::copy(r, r + n, z);
+}
+
+/**
+ * @brief Overwrites r with b - A * x
+ */
+static void residualOf(LinearOperator &a, const std::vector<double> &b, const std::vector<double> &x, std::vector<double> &r) {
+    a.apply(x.data(), r.data());
+    for(int i = 0; i < r.size(); i++) r[i] = b[i] - r[i];
+}
+
+/**
+ * @brief Counts an iteration, records its residual and returns whether the callback lets the solve go on
+ */
+static bool record(KrylovResult &result, KrylovOptions &options, double residual) {
+    result.iterations++;
+    result.history.push_back(residual);
+    return !options.callback || options.callback(result.iterations, residual);
+}
+
+double KrylovSolver::prepare(LinearOperator &a, Vector &b, KrylovOptions &options, KrylovResult &result, std::vector<double> &r) {
+    int n = a.size();
+    if(b.size() != n) Logger::logInvalidIterative(b.fp);
+    if(options.initialGuess) {
+        if(options.initialGuess->size() != n) Logger::logInvalidIterative(options.initialGuess->fp);
+        result.x.values = options.initialGuess->values;
+    }
+    double norm = vectorNorm(n, b.values.data());
+    // The solution of a zero right hand side is zero
+    if(norm == 0) {
+        result.x.values.assign(n, 0);
+        r.assign(n, 0);
+        result.converged = true;
+        result.history.push_back(0);
+        return 0;
+    }
+    r.resize(n);
+    residualOf(a, b.values, result.x.values, r);
+    double residual = vectorNorm(n, r.data()) / norm;
+    result.history.push_back(residual);
+    result.converged = residual <= options.tolerance;
+    return norm;
+}
+
+void KrylovSolver::finish(LinearOperator &a, Vector &b, double norm, KrylovResult &result) {
+    // Report the true residual rather than the one the iteration tracked
+    if(norm == 0) return;
+    std::vector<double> r(b.size());
+    residualOf(a, b.values, result.x.values, r);
+    result.residual = vectorNorm(r.size(), r.data()) / norm;
+}
+
+KrylovResult KrylovSolver::conjugateGradient(LinearOperator &a, Vector &b, KrylovOptions options) {
+    int n = a.size();
+    KrylovResult result(n);
+    std::vector<double> r;
+    double norm = prepare(a, b, options, result, r);
+    std::vector<double> &x = result.x.values;
+    std::vector<double> z(n), p(n), q(n);
+    precondition(options.preconditioner, n, r.data(), z.data());
+    p = z;
+    double rz = vectorDot(n, r.data(), z.data());
+    while(!result.converged && result.iterations < options.maxIterations) {
+        // Step along p to the minimum of the error in the energy norm
+        a.apply(p.data(), q.data());
+        double curvature = vectorDot(n, p.data(), q.data());
+        // A direction without positive curvature means the operator is not positive definite
+        if(!(curvature > 0)) break;
+        double alpha = rz / curvature;
+        vectorAxpy(n, alpha, p.data(), x.data());
+        vectorAxpy(n, -alpha, q.data(), r.data());
+        double residual = vectorNorm(n, r.data()) / norm;
+        result.converged = residual <= options.tolerance;
+        if(!record(result, options, residual)) break;
+        // Make the next direction conjugate to the previous ones
+        precondition(options.preconditioner, n, r.data(), z.data());
+        double next = vectorDot(n, r.data(), z.data());
+        double beta = next / rz;
+        rz = next;
+        for(int i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+    }
+    finish(a, b, norm, result);
+    return result;
+}
+
+KrylovResult KrylovSolver::gmres(LinearOperator &a, Vector &b, KrylovOptions options) {
+    int n = a.size();
+    KrylovResult result(n);
+    std::vector<double> r;
+    double norm = prepare(a, b, options, result, r);
+    std::vector<double> &x = result.x.values;
+    int m = std::max(1, std::min(options.restart, n));
+    std::vector<std::vector<double>> basis(m + 1, std::vector<double>(n));
+    std::vector<std::vector<double>> h(m + 1, std::vector<double>(m, 0));
+    std::vector<double> cs(m), sn(m), g(m + 1), y(m), w(n), z(n);
+    double beta = vectorNorm(n, r.data());
+    while(!result.converged && result.iterations < options.maxIterations) {
+        // Start each cycle from the normalized residual
+        for(int i = 0; i < n; i++) basis[0][i] = r[i] / beta;
+        std::fill(g.begin(), g.end(), 0);
+        g[0] = beta;
+        int k = 0;
+        bool stop = false;
+        while(k < m && result.iterations < options.maxIterations) {
+            // Extend the basis with the product of its newest vector
+            precondition(options.preconditioner, n, basis[k].data(), z.data());
+            a.apply(z.data(), w.data());
+            // Orthogonalize against the basis with modified Gram-Schmidt
+            for(int j = 0; j <= k; j++) {
+                h[j][k] = vectorDot(n, w.data(), basis[j].data());
+                vectorAxpy(n, -h[j][k], basis[j].data(), w.data());
+            }
+            double subdiagonal = vectorNorm(n, w.data());
+            if(subdiagonal != 0)
+                for(int i = 0; i < n; i++) basis[k + 1][i] = w[i] / subdiagonal;
+            // Apply the earlier rotations to the new column, then zero its subdiagonal with a new one
+            for(int j = 0; j < k; j++) {
+                double upper = cs[j] * h[j][k] + sn[j] * h[j + 1][k];
+                h[j + 1][k] = cs[j] * h[j + 1][k] - sn[j] * h[j][k];
+                h[j][k] = upper;
+            }
+            double radius = std::hypot(h[k][k], subdiagonal);
+            // A singular Hessenberg matrix cannot take this column
+            if(radius == 0) {
+                stop = true;
+                break;
+            }
+            cs[k] = h[k][k] / radius;
+            sn[k] = subdiagonal / radius;
+            h[k][k] = radius;
+            g[k + 1] = -sn[k] * g[k];
+            g[k] = cs[k] * g[k];
+            k++;
+            double residual = std::fabs(g[k]) / norm;
+            result.converged = residual <= options.tolerance;
+            // A zero subdiagonal means the basis already holds the solution
+            if(!record(result, options, residual) || result.converged || subdiagonal == 0) {
+                stop = true;
+                break;
+            }
+        }
+        // Combine the basis vectors with the least squares solution of the cycle
+        for(int i = k - 1; i >= 0; i--) {
+            y[i] = g[i];
+            for(int j = i + 1; j < k; j++) y[i] -= h[i][j] * y[j];
+            y[i] /= h[i][i];
+        }
+        std::fill(w.begin(), w.end(), 0);
+        for(int j = 0; j < k; j++) vectorAxpy(n, y[j], basis[j].data(), w.data());
+        precondition(options.preconditioner, n, w.data(), z.data());
+        vectorAxpy(n, 1, z.data(), x.data());
+        if(stop) break;
+        // Restart from the true residual
+        residualOf(a, b.values, x, r);
+        beta = vectorNorm(n, r.data());
+        if(beta == 0) result.converged = true;
+    }
+    finish(a, b, norm, result);
+    return result;
+}
+
+KrylovResult KrylovSolver::bicgstab(LinearOperator &a, Vector &b, KrylovOptions options) {
+    int n = a.size();
+    KrylovResult result(n);
+    std::vector<double> r;
+    double norm = prepare(a, b, options, result, r);
+    std::vector<double> &x = result.x.values;
+    std::vector<double> shadow = r, p(n, 0), v(n, 0), s(n), t(n), pHat(n), sHat(n);
+    double rho = 1, alpha = 1, omega = 1;
+    while(!result.converged && result.iterations < options.maxIterations) {
+        double next = vectorDot(n, shadow.data(), r.data());
+        // The residual has become orthogonal to the shadow residual, a breakdown
+        if(next == 0 || omega == 0) break;
+        double beta = (next / rho) * (alpha / omega);
+        rho = next;
+        for(int i = 0; i < n; i++) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        // Take the BiCG step
+        precondition(options.preconditioner, n, p.data(), pHat.data());
+        a.apply(pHat.data(), v.data());
+        double projection = vectorDot(n, shadow.data(), v.data());
+        if(projection == 0) break;
+        alpha = rho / projection;
+        for(int i = 0; i < n; i++) s[i] = r[i] - alpha * v[i];
+        vectorAxpy(n, alpha, pHat.data(), x.data());
+        double residual = vectorNorm(n, s.data()) / norm;
+        if(residual <= options.tolerance) {
+            result.converged = true;
+            record(result, options, residual);
+            break;
+        }
+        // Then the step minimizing the residual along the preconditioned s
+        precondition(options.preconditioner, n, s.data(), sHat.data());
+        a.apply(sHat.data(), t.data());
+        double tt = vectorDot(n, t.data(), t.data());
+        omega = tt > 0 ? vectorDot(n, t.data(), s.data()) / tt : 0;
+        vectorAxpy(n, omega, sHat.data(), x.data());
+        for(int i = 0; i < n; i++) r[i] = s[i] - omega * t[i];
+        residual = vectorNorm(n, r.data()) / norm;
+        result.converged = residual <= options.tolerance;
+        if(!record(result, options, residual)) break;
+    }
+    finish(a, b, norm, result);
+    return result;
+}
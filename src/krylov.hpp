@@ -0,0 +1,295 @@
+#include<string>
+#include<vector>
+#include<functional>
+#include"matrix.hpp"
+#include"vector.hpp"
+#include"sparse.hpp"
+#ifndef KRYLOV_HPP
+#define KRYLOV_HPP
+
+/**
+ * @brief A square linear operator known only through its product with a
+ * vector, which is all the Krylov solvers need. Subclass it to solve with
+ * implicit operators that are never stored at all
+ *
+ */
+class LinearOperator {
+    public:
+    virtual ~LinearOperator() {}
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the operator
+     */
+    virtual int size() = 0;
+
+    /**
+     * @brief Computes y = A * x for contiguous vectors of the operator's size
+     *
+     * @param x pointer to the vector being multiplied
+     * @param y pointer to the vector overwritten with the product
+     */
+    virtual void apply(const double *x, double *y) = 0;
+};
+
+/**
+ * @brief A dense NxN Matrix as a linear operator. The matrix must outlive the operator
+ *
+ */
+class MatrixOperator : public LinearOperator {
+    private:
+    /** Matrix being applied */
+    Matrix &matrix;
+
+    public:
+    /**
+     * @brief Wraps an NxN matrix
+     *
+     * @param a matrix to apply
+     */
+    MatrixOperator(Matrix &a);
+
+    int size();
+    void apply(const double *x, double *y);
+};
+
+/**
+ * @brief A square SparseMatrix as a linear operator. The matrix must outlive the operator
+ *
+ */
+class SparseOperator : public LinearOperator {
+    private:
+    /** Matrix being applied */
+    SparseMatrix &matrix;
+
+    public:
+    /**
+     * @brief Wraps an NxN sparse matrix
+     *
+     * @param a matrix to apply
+     */
+    SparseOperator(SparseMatrix &a);
+
+    int size();
+    void apply(const double *x, double *y);
+};
+
+/**
+ * @brief A linear operator given by a function computing its product, such as
+ * a stencil applied on the fly
+ *
+ */
+class FunctionOperator : public LinearOperator {
+    private:
+    /** Number of rows and columns */
+    int n;
+    /** Function computing y = A * x */
+    std::function<void(const double*, double*)> product;
+
+    public:
+    /**
+     * @brief Wraps a function computing the product of an NxN operator
+     *
+     * @param size number of rows and columns
+     * @param function function called with x and y that overwrites y with A * x
+     */
+    FunctionOperator(int size, std::function<void(const double*, double*)> function);
+
+    int size();
+    void apply(const double *x, double *y);
+};
+
+/**
+ * @brief An approximation M of a matrix that is cheap to invert, so the solvers
+ * work on the better conditioned M^-1 * A
+ *
+ */
+class Preconditioner {
+    public:
+    virtual ~Preconditioner() {}
+
+    /**
+     * @brief Computes z = M^-1 * r for contiguous vectors of the operator's size
+     *
+     * @param r pointer to the vector being preconditioned
+     * @param z pointer to the vector overwritten with the result
+     */
+    virtual void apply(const double *r, double *z) = 0;
+};
+
+/**
+ * @brief Divides by the diagonal of the matrix
+ *
+ */
+class JacobiPreconditioner : public Preconditioner {
+    private:
+    /** Reciprocal of each diagonal value */
+    std::vector<double> inverse;
+
+    public:
+    /**
+     * @brief Takes the diagonal of an NxN matrix, which must not hold a zero
+     *
+     * @param a matrix being preconditioned
+     */
+    JacobiPreconditioner(Matrix &a);
+
+    /**
+     * @brief Takes the diagonal of an NxN sparse matrix, which must not hold a zero
+     *
+     * @param a matrix being preconditioned
+     */
+    JacobiPreconditioner(SparseMatrix &a);
+
+    void apply(const double *r, double *z);
+};
+
+/**
+ * @brief Incomplete LU factorization without fill, ILU(0). The factors keep the
+ * nonzero pattern of the matrix and drop every value outside it, so they cost
+ * no more memory than the matrix itself
+ *
+ */
+class IncompleteLU : public Preconditioner {
+    private:
+    /** Number of rows and columns */
+    int n;
+    /** Unit lower factor below the diagonal and upper factor on and above it, in the pattern of the matrix */
+    std::vector<int> rowStart, columnIndex;
+    std::vector<double> values;
+    /** Position of each row's diagonal within values */
+    std::vector<int> diagonal;
+
+    public:
+    /**
+     * @brief Factors an NxN sparse matrix whose diagonal is stored in full
+     *
+     * @param a matrix being preconditioned
+     */
+    IncompleteLU(SparseMatrix &a);
+
+    void apply(const double *r, double *z);
+};
+
+/**
+ * @brief Incomplete Cholesky factorization without fill, IC(0), for symmetric
+ * positive definite matrices. The lower factor keeps the nonzero pattern of the
+ * lower triangle of the matrix
+ *
+ */
+class IncompleteCholesky : public Preconditioner {
+    private:
+    /** Number of rows and columns */
+    int n;
+    /** Rows of the lower factor, each ending with its diagonal */
+    std::vector<int> rowStart, columnIndex;
+    std::vector<double> values;
+
+    public:
+    /**
+     * @brief Factors an NxN symmetric positive definite sparse matrix, reading its lower triangle
+     *
+     * @param a matrix being preconditioned
+     */
+    IncompleteCholesky(SparseMatrix &a);
+
+    void apply(const double *r, double *z);
+};
+
+/**
+ * @brief Settings shared by the Krylov solvers
+ *
+ */
+struct KrylovOptions {
+    /** Stop once the residual norm falls to this fraction of the right hand side's */
+    double tolerance;
+    /** Most iterations to run, each one product with the operator (two for BiCGSTAB) */
+    int maxIterations;
+    /** Iterations between GMRES restarts, the number of basis vectors it keeps */
+    int restart;
+    /** Preconditioner to apply, or null for none */
+    Preconditioner *preconditioner;
+    /** Starting solution, or null to start from zero */
+    Vector *initialGuess;
+    /** Called after every iteration with its number and relative residual, stopping the solve when it returns false */
+    std::function<bool(int, double)> callback;
+
+    KrylovOptions() : tolerance(1e-10), maxIterations(1000), restart(30), preconditioner(NULL), initialGuess(NULL) {}
+};
+
+/**
+ * @brief Outcome of a Krylov solve
+ *
+ */
+struct KrylovResult {
+    /** The approximate solution */
+    Vector x;
+    /** Whether the residual reached the tolerance */
+    bool converged;
+    /** Number of iterations run */
+    int iterations;
+    /** Relative residual norm |b - A * x| / |b| of the returned solution */
+    double residual;
+    /** Relative residual norm before the first iteration and after each one */
+    std::vector<double> history;
+
+    KrylovResult(int size) : x(size), converged(false), iterations(0), residual(0) {}
+};
+
+/**
+ * @brief Krylov subspace solvers for A * x = b, which only ever multiply by A and
+ * so never need the memory or cubic time of a factorization
+ *
+ */
+class KrylovSolver {
+    private:
+    /**
+     * @brief Checks the sizes, places the starting solution in the result and
+     * the starting residual in r, and returns the norm of b
+     */
+    static double prepare(LinearOperator &a, Vector &b, KrylovOptions &options, KrylovResult &result, std::vector<double> &r);
+
+    /**
+     * @brief Stores the relative residual of the solution in the result
+     */
+    static void finish(LinearOperator &a, Vector &b, double norm, KrylovResult &result);
+
+    public:
+    /**
+     * @brief Solves with the preconditioned conjugate gradient method, for
+     * symmetric positive definite operators and preconditioners
+     *
+     * @param a operator of the system
+     * @param b right hand side with N values
+     * @param options tolerance, limits, preconditioner and callback
+     * @return KrylovResult the solution with its residual history
+     */
+    static KrylovResult conjugateGradient(LinearOperator &a, Vector &b, KrylovOptions options = KrylovOptions());
+
+    /**
+     * @brief Solves with restarted GMRES, for any nonsingular operator. The
+     * preconditioner is applied on the right so the residuals tracked are those
+     * of the original system
+     *
+     * @param a operator of the system
+     * @param b right hand side with N values
+     * @param options tolerance, limits, restart length, preconditioner and callback
+     * @return KrylovResult the solution with its residual history
+     */
+    static KrylovResult gmres(LinearOperator &a, Vector &b, KrylovOptions options = KrylovOptions());
+
+    /**
+     * @brief Solves with BiCGSTAB, for nonsymmetric operators, keeping a fixed
+     * handful of vectors where GMRES keeps its whole basis. The preconditioner is
+     * applied on the right
+     *
+     * @param a operator of the system
+     * @param b right hand side with N values
+     * @param options tolerance, limits, preconditioner and callback
+     * @return KrylovResult the solution with its residual history
+     */
+    static KrylovResult bicgstab(LinearOperator &a, Vector &b, KrylovOptions options = KrylovOptions());
+};
+
+#endif
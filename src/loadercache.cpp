@@ -0,0 +1,154 @@
+#include<map>
+#include<list>
+#include<mutex>
+#include<chrono>
+#include<utility>
+#include<string>
+#include<vector>
+#include<sys/stat.h>
+#include"loadercache.hpp"
+
+// Memory cached files may take unless set otherwise
+static const long long DEFAULT_BUDGET = 256LL << 20;
+
+// Files modified more recently than this many nanoseconds ago are not cached
+static const long long RACY_WINDOW = 2000000000LL;
+
+// Reference to cache flag
+bool LoaderCache::flag;
+
+// Reference to cache pointer
+LoaderCache* LoaderCache::cache;
+
+// Reference to the lock guarding the cache
+std::mutex LoaderCache::lock;
+
+bool FileStamp::operator==(const FileStamp &other) const {
+    return valid && other.valid && device == other.device && inode == other.inode && size == other.size && modified == other.modified;
+}
+
+LoaderCache::LoaderCache() {
+    budget = DEFAULT_BUDGET;
+    used = 0;
+    hitCount = 0;
+    missCount = 0;
+}
+
+LoaderCache* LoaderCache::getInstance() {
+    std::lock_guard<std::mutex> guard(lock);
+    // If the cache has been initialized return it
+    if(flag) return cache;
+    // Otherwise initialize and return its pointer
+    cache = new LoaderCache();
+    flag = true;
+    return cache;
+}
+
+FileStamp LoaderCache::stamp(std::string filepath) {
+    FileStamp result = {false, 0, 0, 0, 0};
+    struct stat info;
+    if(stat(filepath.c_str(), &info) != 0) return result;
+    result.valid = true;
+    result.device = info.st_dev;
+    result.inode = info.st_ino;
+    result.size = info.st_size;
+#ifdef __APPLE__
+    result.modified = info.st_mtimespec.tv_sec * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    result.modified = info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+    return result;
+}
+
+void LoaderCache::remove(std::map<std::string, Entry>::iterator position) {
+    used -= position->second.bytes;
+    recency.erase(position->second.position);
+    entries.erase(position);
+}
+
+bool LoaderCache::lookup(std::string filepath, FileStamp &current, int &m, int &n, SharedRows &matrix, unsigned long long &version) {
+    SharedRows rows;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::map<std::string, Entry>::iterator found = entries.find(filepath);
+        // A file whose stamp moved on has been rewritten, so its entry is dropped
+        if(found != entries.end() && !(found->second.stamp == current)) {
+            remove(found);
+            found = entries.end();
+        }
+        if(found == entries.end()) {
+            missCount++;
+            return false;
+        }
+        // Move the entry to the front of the recency list
+        recency.splice(recency.begin(), recency, found->second.position);
+        m = found->second.m;
+        n = found->second.n;
+        version = found->second.version;
+        rows = found->second.rows;
+        hitCount++;
+    }
+    // The rows are shared, so a matrix writing to them copies them first
+    matrix = std::move(rows);
+    return true;
+}
+
+void LoaderCache::store(std::string filepath, FileStamp &current, SharedRows &matrix, unsigned long long version) {
+    if(!current.valid) return;
+    // A file this fresh may be rewritten again without its stamp changing
+    long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    if(current.modified > now - RACY_WINDOW) return;
+    long long bytes = matrix.size() * sizeof(std::vector<double>);
+    for(int i = 0; i < matrix.size(); i++) bytes += matrix[i].size() * sizeof(double);
+    Entry entry;
+    entry.stamp = current;
+    entry.m = matrix.size();
+    entry.n = matrix.size() == 0 ? 0 : matrix[0].size();
+    entry.rows = matrix;
+    entry.version = version;
+    entry.bytes = bytes;
+    std::lock_guard<std::mutex> guard(lock);
+    if(bytes > budget) return;
+    // Replace any entry loaded concurrently for the same file
+    std::map<std::string, Entry>::iterator found = entries.find(filepath);
+    if(found != entries.end()) remove(found);
+    // Evict from the back of the recency list until the file fits
+    while(used + bytes > budget) remove(entries.find(recency.back()));
+    recency.push_front(filepath);
+    entry.position = recency.begin();
+    entries.insert(std::make_pair(filepath, entry));
+    used += bytes;
+}
+
+void LoaderCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    recency.clear();
+    used = 0;
+}
+
+void LoaderCache::setBudget(long long bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    budget = bytes < 0 ? 0 : bytes;
+    while(used > budget) remove(entries.find(recency.back()));
+}
+
+long long LoaderCache::getBudget() {
+    std::lock_guard<std::mutex> guard(lock);
+    return budget;
+}
+
+long long LoaderCache::getUsed() {
+    std::lock_guard<std::mutex> guard(lock);
+    return used;
+}
+
+long long LoaderCache::hits() {
+    std::lock_guard<std::mutex> guard(lock);
+    return hitCount;
+}
+
+long long LoaderCache::misses() {
+    std::lock_guard<std::mutex> guard(lock);
+    return missCount;
+}
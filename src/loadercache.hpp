@@ -0,0 +1,170 @@
+#include<map>
+#include<list>
+#include<mutex>
+#include<string>
+#include<vector>
+#include"sharedrows.hpp"
+#ifndef LOADERCACHE_HPP
+#define LOADERCACHE_HPP
+
+/**
+ * @brief Identity of a file's contents as reported by the file system. A file
+ * rewritten in place keeps its inode but changes its size or modification time
+ *
+ */
+struct FileStamp {
+    /** Whether the file could be inspected at all */
+    bool valid;
+    /** Device and inode of the file */
+    long long device, inode;
+    /** Size of the file in bytes */
+    long long size;
+    /** Modification time in nanoseconds since the epoch */
+    long long modified;
+
+    bool operator==(const FileStamp &other) const;
+};
+
+/**
+ * @brief Singleton holding the parsed contents of recently loaded mtx files, so
+ * loading an unchanged file again is a lookup instead of a parse. Entries are
+ * keyed on the filepath and checked against the file's stamp, and are evicted
+ * least recently used first once they exceed a memory budget. Files modified
+ * within the last few seconds are not cached, since a rewrite within the
+ * resolution of the file system clock could leave the stamp unchanged
+ *
+ */
+class LoaderCache {
+    private:
+    /** Flag for whether the cache has been initialized */
+    static bool flag;
+
+    /** Pointer to the cache */
+    static LoaderCache* cache;
+
+    /** Guards every member, since matrices may be loaded from several threads */
+    static std::mutex lock;
+
+    /**
+     * @brief The parsed contents of a file with the stamp they were read at
+     *
+     */
+    struct Entry {
+        FileStamp stamp;
+        int m, n;
+        SharedRows rows;
+        unsigned long long version;
+        long long bytes;
+        std::list<std::string>::iterator position;
+    };
+
+    /** Entries by filepath */
+    std::map<std::string, Entry> entries;
+    /** Filepaths from most to least recently used */
+    std::list<std::string> recency;
+    /** Most bytes the entries may take */
+    long long budget;
+    /** Bytes the entries take */
+    long long used;
+    /** Loads answered from the cache */
+    long long hitCount;
+    /** Loads that had to parse the file */
+    long long missCount;
+
+    /**
+     * @brief Construct the cache with the default budget
+     *
+     */
+    LoaderCache();
+
+    /**
+     * @brief Removes one entry, the lock must be held
+     *
+     * @param position entry to remove
+     */
+    void remove(std::map<std::string, Entry>::iterator position);
+
+    public:
+    /**
+     * @brief Get the instance of the cache
+     *
+     * @return LoaderCache* pointer to the cache
+     */
+    static LoaderCache* getInstance();
+
+    /**
+     * @brief Reads the stamp of a file, which is invalid if the file cannot be inspected
+     *
+     * @param filepath filepath to the file
+     * @return FileStamp identity of the file's contents
+     */
+    static FileStamp stamp(std::string filepath);
+
+    /**
+     * @brief Looks up the parsed contents of a file, which must still have the given stamp
+     *
+     * @param filepath filepath to the mtx file
+     * @param current stamp of the file taken before the lookup
+     * @param m receives the number of rows
+     * @param n receives the number of columns
+     * @param matrix receives the rows, shared with the cache until either is written to
+     * @param version receives the version the contents were given when first loaded
+     * @return true if the contents were cached
+     */
+    bool lookup(std::string filepath, FileStamp &current, int &m, int &n, SharedRows &matrix, unsigned long long &version);
+
+    /**
+     * @brief Stores the parsed contents of a file, evicting the least recently used
+     * files beyond the budget. Contents larger than the whole budget, of files that
+     * could not be inspected or of files modified too recently are not stored
+     *
+     * @param filepath filepath to the mtx file
+     * @param current stamp of the file taken before it was parsed
+     * @param matrix the parsed rows, which the cache shares rather than copies
+     * @param version version given to the contents
+     */
+    void store(std::string filepath, FileStamp &current, SharedRows &matrix, unsigned long long version);
+
+    /**
+     * @brief Drops every cached file
+     *
+     */
+    void clear();
+
+    /**
+     * @brief Sets the memory budget, evicting files beyond it. A budget of 0 disables caching
+     *
+     * @param bytes most bytes cached files may take
+     */
+    void setBudget(long long bytes);
+
+    /**
+     * @brief Returns the memory budget
+     *
+     * @return long long most bytes cached files may take
+     */
+    long long getBudget();
+
+    /**
+     * @brief Returns the memory taken by cached files
+     *
+     * @return long long bytes taken
+     */
+    long long getUsed();
+
+    /**
+     * @brief Returns how many loads were answered from the cache
+     *
+     * @return long long number of hits
+     */
+    long long hits();
+
+    /**
+     * @brief Returns how many loads had to parse the file
+     *
+     * @return long long number of misses
+     */
+    long long misses();
+};
+
+#endif
@@ -12,6 +12,9 @@ Logger* Logger::logger;
 // Reference to file to write log to
 std::ofstream Logger::file;
 
+// Reference to the lock guarding the logger
+std::mutex Logger::lock;
+
 Logger::Logger(){
     // Open the log file
     file.open("log/debug.log", std::ofstream::app);
@@ -20,6 +23,7 @@ Logger::Logger(){
 }
 
 Logger* Logger::getInstance() {
+    std::lock_guard<std::mutex> guard(lock);
     // If the logger has been initialized return it
     if(flag) return logger;
     // Otherwise initialize and return its pointer
@@ -35,6 +39,7 @@ Logger::~Logger(){
 }
 
 void Logger::log(std::string message) {
+    std::lock_guard<std::mutex> guard(lock);
     // Output the error message to the log file
     file << message << std::endl;
 }
@@ -81,6 +86,206 @@ void Logger::logInvalidLUDecomposition(std::string fp){
     throw std::runtime_error(errorMessage);
 }
 
+void Logger::logInvalidCholesky(std::string fp){
+    // Log error with identifier and decomposition requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to complete Cholesky Decomposition of: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Cholesky Decomposition: \n");
+    errorMessage.append("\t1) Matrix being decomposed is NxN.\n");
+    errorMessage.append("\t2) Matrix is symmetric.\n");
+    errorMessage.append("\t3) Matrix is positive definite.\n");
+    errorMessage.append("\t   NOTE: Symmetric indefinite matrices can use the LDL^T Decomposition.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidLDLT(std::string fp){
+    // Log error with identifier and decomposition requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to complete LDL^T Decomposition of: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of LDL^T Decomposition: \n");
+    errorMessage.append("\t1) Matrix being decomposed is NxN.\n");
+    errorMessage.append("\t2) Matrix is symmetric.\n");
+    errorMessage.append("\t3) Matrix is not singular.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidLeastSquares(std::string fp){
+    // Log error with identifier and least squares requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to solve the Least Squares problem of: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Least Squares: \n");
+    errorMessage.append("\t1) Matrix has at least as many rows as columns.\n");
+    errorMessage.append("\t2) Matrix has full column rank.\n");
+    errorMessage.append("\t   NOTE: rank() reports the numerical rank of a Matrix.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidEigen(std::string fp){
+    // Log error with identifier and eigensolver requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to compute the Eigendecomposition of: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Symmetric Eigendecomposition: \n");
+    errorMessage.append("\t1) Matrix being decomposed is NxN.\n");
+    errorMessage.append("\t2) Matrix is symmetric.\n");
+    errorMessage.append("\t3) Number of requested eigenpairs is between 1 and N.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidSVD(std::string fp){
+    // Log error with identifier and truncated SVD requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to compute the Truncated SVD of: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Truncated SVD: \n");
+    errorMessage.append("\t1) Rank is between 1 and the smaller dimension of the Matrix.\n");
+    errorMessage.append("\t2) Oversampling and power iterations are not negative.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidManifest(std::string fp, int line){
+    // Log error with identifier, line and manifest requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to run line ");
+    errorMessage.append(std::to_string(line));
+    errorMessage.append(" of the Batch Manifest: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Batch Manifest: \n");
+    errorMessage.append("\t1) Manifest file exists and can be read.\n");
+    errorMessage.append("\t2) Each line is operation:input[:input...]:output.\n");
+    errorMessage.append("\t3) Each operation is registered and given its number of inputs.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidDaemon(std::string fp, std::string request){
+    // Log error with identifier, request and daemon requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to serve the request '");
+    errorMessage.append(request);
+    errorMessage.append("' of the Matrix Daemon: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Matrix Daemon: \n");
+    errorMessage.append("\t1) The daemon is running and listening on the socket.\n");
+    errorMessage.append("\t2) Each request names a registered operation with its number of operands.\n");
+    errorMessage.append("\t3) Each operand names a resident matrix.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidDistribution(std::string fp){
+    // Log error with identifier and distribution requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to run the distributed operation on: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Distributed operation: \n");
+    errorMessage.append("\t1) The process grid covers every process of the group.\n");
+    errorMessage.append("\t2) Operands share the process grid and block size, with dimensions that agree.\n");
+    errorMessage.append("\t3) Every process of the group can be reached.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidChain(std::string fp){
+    // Log error with identifier and chain requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to multiply the chain of matrices: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Chain multiplication: \n");
+    errorMessage.append("\t1) The chain holds at least one matrix.\n");
+    errorMessage.append("\t2) Each matrix has as many columns as the next has rows.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidStructure(std::string fp){
+    // Log error with identifier and structure requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to store the structured matrix: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Structured storage: \n");
+    errorMessage.append("\t1) Matrix being stored is NxN.\n");
+    errorMessage.append("\t2) Symmetric matrices equal their transpose.\n");
+    errorMessage.append("\t3) Banded matrices are zero outside their band, whose widths are not negative.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidSolve(std::string fp){
+    // Log error with identifier and solve requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to solve the linear system of: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of solving A * X = B: \n");
+    errorMessage.append("\t1) Matrix A is NxN.\n");
+    errorMessage.append("\t2) Matrix B has N rows.\n");
+    errorMessage.append("\t3) Matrix A is not singular.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidIterative(std::string fp){
+    // Log error with identifier and iterative solver requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to solve the linear system iteratively: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of Krylov solvers: \n");
+    errorMessage.append("\t1) Operator A is NxN.\n");
+    errorMessage.append("\t2) Right hand side b and any initial guess have N values.\n");
+    errorMessage.append("\t3) Jacobi and ILU(0) preconditioners need a nonzero diagonal.\n");
+    errorMessage.append("\t4) IC(0) preconditioners need a symmetric positive definite matrix.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidQuantization(std::string fp){
+    // Log error with identifier and quantized product requirements
+    std::string errorMessage = "";
+    errorMessage.append("Unable to multiply the quantized matrices: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of quantized products: \n");
+    errorMessage.append("\t1) Left operand is quantized with a scale per row.\n");
+    errorMessage.append("\t2) Right operand is quantized with a scale per column.\n");
+    errorMessage.append("\t3) Both operands use the same integer type.\n");
+    errorMessage.append("\t4) Left operand has as many columns as the right has rows.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
 void Logger::logInvalidColumn(int column, std::string fp){
     // Log error with identifier and column number
     std::string errorMessage = "";
@@ -109,6 +314,22 @@ void Logger::logInvalidRow(int row, std::string fp){
     throw std::runtime_error(errorMessage);
 }
 
+void Logger::logInvalidBatchIndex(int index, int count, std::string fp){
+    // Log error with identifier, index and batch size
+    std::string errorMessage = "";
+    errorMessage.append("Invalid batch index requested: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("The requested index was ");
+    errorMessage.append(std::to_string(index));
+    errorMessage.append(" but the batch holds ");
+    errorMessage.append(std::to_string(count));
+    errorMessage.append(" matrices.\n");
+    errorMessage.append("Remember that batch indices are 1-indexed.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
 void Logger::logInvalidInput(std::string fp){
     // Log error with identifier and formatting hints
     std::string errorMessage = "";
@@ -127,6 +348,38 @@ void Logger::logInvalidInput(std::string fp){
     throw std::runtime_error(errorMessage);
 }
 
+void Logger::logInvalidOutput(std::string fp){
+    // Log error with identifier and the likely causes
+    std::string errorMessage = "";
+    errorMessage.append("Unable to write the output file: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("Requirements of writing a Matrix: \n");
+    errorMessage.append("\t1) The directory of the file exists.\n");
+    errorMessage.append("\t2) The file can be created or overwritten.\n");
+    errorMessage.append("\t3) The device has space for the file.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
+void Logger::logInvalidVector(std::string fp, int m, int n) {
+    // Log error with identifier and dimensions
+    std::string errorMessage = "";
+    errorMessage.append("Unable to create a Vector from: ");
+    errorMessage.append(fp);
+    errorMessage.append("\n");
+    errorMessage.append("================================\n");
+    errorMessage.append("The matrix was ");
+    errorMessage.append(std::to_string(m));
+    errorMessage.append("x");
+    errorMessage.append(std::to_string(n));
+    errorMessage.append(".\n");
+    errorMessage.append("A Vector must have a single row or a single column.\n");
+    // Throw error with log message
+    throw std::runtime_error(errorMessage);
+}
+
 void Logger::logInvalidDimensions(std::string fp1, int m1, int n1, std::string fp2, int m2, int n2) {
     // Log error with dimensions and identifiers
     std::string errorMessage = "";
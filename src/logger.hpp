@@ -1,5 +1,6 @@
 #include<string>
 #include<fstream>
+#include<mutex>
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
@@ -19,6 +20,9 @@ class Logger {
     /** File to write log messages to */
     static std::ofstream file;
 
+    /** Guards initialization and writes, since matrices may be loaded from several threads */
+    static std::mutex lock;
+
     /**
      * @brief Construct the logger
      * 
@@ -68,6 +72,99 @@ class Logger {
      */
     static void logInvalidLUDecomposition(std::string fp);
 
+    /**
+     * @brief Throws an exception about invalid matrix for Cholesky decomposition
+     * 
+     * @param fp file path to the root matrix being decomposed
+     */
+    static void logInvalidCholesky(std::string fp);
+
+    /**
+     * @brief Throws an exception about invalid matrix for LDL^T decomposition
+     * 
+     * @param fp file path to the root matrix being decomposed
+     */
+    static void logInvalidLDLT(std::string fp);
+
+    /**
+     * @brief Throws an exception about a least squares problem that cannot be solved
+     * 
+     * @param fp file path to the root matrix of the problem
+     */
+    static void logInvalidLeastSquares(std::string fp);
+
+    /**
+     * @brief Throws an exception about an eigenproblem that cannot be solved
+     * 
+     * @param fp file path to the matrix being decomposed
+     */
+    static void logInvalidEigen(std::string fp);
+
+    /**
+     * @brief Throws an exception about a truncated SVD that cannot be computed
+     * 
+     * @param fp file path to the matrix being decomposed
+     */
+    static void logInvalidSVD(std::string fp);
+
+    /**
+     * @brief Throws an exception about a batch manifest that cannot be run
+     * 
+     * @param fp file path to the manifest
+     * @param line line number of the offending job, 0 if the manifest could not be opened
+     */
+    static void logInvalidManifest(std::string fp, int line);
+
+    /**
+     * @brief Throws an exception about a request the matrix daemon cannot serve
+     * 
+     * @param fp file path to the daemon's socket
+     * @param request the request, or what was being attempted when the daemon could not be reached
+     */
+    static void logInvalidDaemon(std::string fp, std::string request);
+
+    /**
+     * @brief Throws an exception about a distributed operation that cannot be run
+     * 
+     * @param fp file path to the matrix being operated on, or the process that could not be reached
+     */
+    static void logInvalidDistribution(std::string fp);
+
+    /**
+     * @brief Throws an exception about a chain of matrices that cannot be multiplied
+     * 
+     * @param fp file paths of the matrices in the chain
+     */
+    static void logInvalidChain(std::string fp);
+
+    /**
+     * @brief Throws an exception about a matrix that does not fit a structured storage type
+     * 
+     * @param fp file path to the matrix being stored
+     */
+    static void logInvalidStructure(std::string fp);
+
+    /**
+     * @brief Throws an exception about a linear system that cannot be solved
+     * 
+     * @param fp filepath to the root matrix of the system
+     */
+    static void logInvalidSolve(std::string fp);
+
+    /**
+     * @brief Throws an exception about a system an iterative solver or preconditioner cannot handle
+     * 
+     * @param fp filepath to the root matrix of the system
+     */
+    static void logInvalidIterative(std::string fp);
+
+    /**
+     * @brief Throws an exception about quantized operands that cannot be multiplied
+     * 
+     * @param fp filepath to the root matrix of the left operand
+     */
+    static void logInvalidQuantization(std::string fp);
+
     /**
      * @brief Throws an exception about invalid column access
      * 
@@ -84,6 +181,15 @@ class Logger {
      */
     static void logInvalidRow(int row, std::string fp);
 
+    /**
+     * @brief Throws an exception about a batch index outside the batch
+     * 
+     * @param index batch index that was invalid
+     * @param count number of matrices in the batch
+     * @param fp filepath to the root matrix of the batch
+     */
+    static void logInvalidBatchIndex(int index, int count, std::string fp);
+
     /**
      * @brief Throw an error for invalid input file
      * 
@@ -91,6 +197,22 @@ class Logger {
      */
     static void logInvalidInput(std::string fp);
 
+    /**
+     * @brief Throw an error for an output file that could not be written
+     * 
+     * @param fp filepath of the output file
+     */
+    static void logInvalidOutput(std::string fp);
+
+    /**
+     * @brief Throw an error about a matrix that cannot be used as a vector
+     * 
+     * @param fp filepath of the matrix
+     * @param m row count of the matrix
+     * @param n column count of the matrix
+     */
+    static void logInvalidVector(std::string fp, int m, int n);
+
     /**
      * @brief Throw an error about invalid matrix dimensions for an operation
      * 
@@ -1,21 +1,94 @@
 #include<iostream>
 #include<vector>
+#include<utility>
 #include<string>
 #include<fstream>
+#include<cmath>
+#include<algorithm>
+#include<atomic>
+#include<functional>
+#include<limits>
+#include<chrono>
 #include"matrix.hpp"
+#include"derivedcache.hpp"
+#include"loadercache.hpp"
+#include"kernels.hpp"
+#include"vector.hpp"
+#include"factorizations.hpp"
+#include"eigen.hpp"
+#include"svd.hpp"
+#include"parallel.hpp"
+#include"topology.hpp"
+#include"reductions.hpp"
+#include"tuning.hpp"
+
+// Source of versions, each new or mutated matrix takes the next one
+static std::atomic<unsigned long long> versions(0);
+// Refinement steps the mixed precision solve takes before falling back to double precision
+static const int REFINEMENT_STEPS = 30;
+// Times the autotuner runs each candidate, keeping the fastest
+static const int TUNING_REPEATS = 3;
+
+/**
+ * @brief Gathers a pointer to the start of each row for the reduction kernels
+ */
+static std::vector<const double*> rowPointers(const std::vector<std::vector<double>> &values) {
+    std::vector<const double*> rows(values.size());
+    for(size_t i = 0; i < values.size(); i++) rows[i] = values[i].data();
+    return rows;
+}
+
+/**
+ * @brief Names a cached reduction, keeping compensated and plain results apart
+ */
+static std::string reductionKind(std::string kind) {
+    return getCompensatedSummation() ? kind + "Compensated" : kind;
+}
+
+/**
+ * @brief Allocates and fills the rows of a result in parallel chunks. Each row is
+ * first written by the worker whose chunk holds it, which under the first-touch
+ * policy puts its pages on that worker's node, while the other policies are set
+ * on the worker around the fill so the pages are placed as they are touched
+ */
+static std::vector<std::vector<double>> buildRows(int m, int n, std::function<void(int, double*)> fill) {
+    std::vector<std::vector<double>> rows(m);
+    int grain = std::max(1, getTuningProfile().parallelValues / std::max(n, 1));
+    parallelFor(0, m, grain, [&rows, &fill, n](int lo, int hi) {
+        PlacementScope placement;
+        for(int i = lo; i < hi; i++) {
+            rows[i].resize(n);
+            fill(i, rows[i].data());
+        }
+    });
+    return rows;
+}
 
 //////////////////////////////////////////
 //  Importing/Exporting Matrix objects
 //////////////////////////////////////////
 
 Matrix::Matrix(std::string filepath, std::vector<std::vector<double>> vals) {
-    // Store the matrix's filepath
+    // Store the matrix's filepath and version
     fp = filepath;
+    version = ++versions;
     // Store the dimensions of the matrix
     m = vals.size();
     n = vals[0].size();
-    // Read in the values for the matrix
-    for(int i = 0; i < m; i++) matrix.push_back(vals[i]);
+    // Take over the rows, which keeps them where they were built
+    matrix = SharedRows(std::move(vals));
+}
+
+Matrix::Matrix(std::string filepath, int rows, int columns, std::vector<double> &vals) {
+    // Store the matrix's filepath, version and dimensions
+    fp = filepath;
+    version = ++versions;
+    m = rows;
+    n = columns;
+    // Split the row-major values into rows
+    matrix = buildRows(m, n, [&vals, columns](int i, double *row) {
+        std::copy(vals.begin() + (long long) i * columns, vals.begin() + (long long) (i + 1) * columns, row);
+    });
 }
 
 Matrix::Matrix(std::string filepath){
@@ -23,13 +96,19 @@ Matrix::Matrix(std::string filepath){
     Logger::getInstance()->log("Creating a Matrix from the filepath: " + filepath);
     // Store the matrix's filepath
     fp = filepath;
-    // Populate the matrix from input file
-    readMtx(fp, m, n, matrix);
+    // An unchanged file loaded before keeps its contents and version
+    LoaderCache *cache = LoaderCache::getInstance();
+    FileStamp stamp = LoaderCache::stamp(fp);
+    if(cache->lookup(fp, stamp, m, n, matrix, version)) return;
+    // Otherwise populate the matrix from input file
+    readMtx(fp, m, n, matrix.write());
+    version = ++versions;
+    cache->store(fp, stamp, matrix, version);
 }
 
 void Matrix::save(std::string filename) {
     // Write the matrix to the provided filepath
-    writeMtx(filename, matrix);
+    writeMtx(filename, matrix.read());
 }
 
 //////////////////////////////////////////
@@ -51,7 +130,7 @@ Matrix Matrix::getColumn(int column) {
     // Read through columns pushing to rows
     for(int i = 0; i < m; i++) vals[i].push_back(matrix[i][column - 1]);
     // Return the column matrix
-    return Matrix(fp, vals);
+    return Matrix(fp, std::move(vals));
 }
 
 std::string Matrix::display() {
@@ -81,6 +160,15 @@ double Matrix::access(int row, int column){
     return matrix[row - 1][column - 1];
 }
 
+void Matrix::set(int row, int column, double value) {
+    // Check the bounds of the row and column
+    if(row < 1 || row > m) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Store the value, which changes the contents and splits them from any copy
+    matrix.write()[row - 1][column - 1] = value;
+    version = ++versions;
+}
+
 int Matrix::rows() {
     // Return the number of rows for the matrix
     return m;
@@ -96,6 +184,45 @@ std::string Matrix::getFilePath() {
     return fp;
 }
 
+std::vector<double> Matrix::flatten() {
+    // Copy each row after the previous one
+    std::vector<double> vals;
+    vals.reserve((long long) m * n);
+    for(int i = 0; i < m; i++) vals.insert(vals.end(), matrix[i].begin(), matrix[i].end());
+    return vals;
+}
+
+unsigned long long Matrix::getVersion() {
+    // Returns the version of the contents
+    return version;
+}
+
+//////////////////////////////////////////
+//  Caching derived results
+//////////////////////////////////////////
+
+bool Matrix::recall(std::string kind, std::vector<Matrix> &values) {
+    return DerivedCache::getInstance()->lookup(version, kind, values);
+}
+
+std::vector<Matrix> Matrix::remember(std::string kind, std::vector<Matrix> values) {
+    DerivedCache::getInstance()->store(version, kind, values);
+    return values;
+}
+
+void Matrix::clearCache() {
+    DerivedCache::getInstance()->erase(version);
+}
+
+void Matrix::detach() {
+    // Copying the values leaves the contents, and so the version, unchanged
+    matrix.detach();
+}
+
+bool Matrix::isShared() {
+    return matrix.shared();
+}
+
 //////////////////////////////////////////
 //  Operators for Matrix objects
 //////////////////////////////////////////
@@ -103,27 +230,35 @@ std::string Matrix::getFilePath() {
 Matrix Matrix::operator*(Matrix &other){
     // If dimensions don't match display error message
     if(n != other.rows()) Logger::logInvalidDimensions(fp, m, n, other.getFilePath(), other.rows(), other.columns());
-    // Initialize values grid for new matrix
-    std::vector<std::vector<double>> vals(m, std::vector<double>(other.columns()));
-    // Loop through all indices in output grid
-    for(int i = 0; i < m; i++)
-        for(int j = 0; j < other.columns(); j++)
-            // For each index total the row x column values
-            for(int ii = 0; ii < n; ii++)
-                    vals[i][j] += matrix[i][ii] * other.access(ii + 1, j + 1);
+    // Copy both operands into contiguous buffers for the kernels
+    std::vector<double> left = flatten();
+    std::vector<double> right = other.flatten();
+    std::vector<double> vals((long long) m * other.columns());
+    // Compute the product with the blocked or Strassen-Winograd kernel
+    multiply(m, other.columns(), n, left.data(), right.data(), vals.data());
     // Return the new resulting Matrix
-    return Matrix(fp, vals);
+    return Matrix(fp, m, other.columns(), vals);
+}
+
+Vector Matrix::operator*(Vector &other) {
+    // If dimensions don't match display error message
+    if(n != other.size()) Logger::logInvalidDimensions(fp, m, n, other.getFilePath(), other.size(), 1);
+    // Gather the row pointers for the kernel
+    std::vector<const double*> rows(m);
+    for(int i = 0; i < m; i++) rows[i] = matrix[i].data();
+    // Each value of the result is the dot product of a row with the vector
+    std::vector<double> result(m);
+    gemv(m, n, rows.data(), other.values.data(), result.data());
+    return Vector(fp, result);
 }
 
 Matrix Matrix::operator*(double val) {
-    // Initialize array to hold resulting values
-    std::vector<std::vector<double>> vals(m, std::vector<double>(n));
-    // Loop through scaling values
-    for(int i = 0; i < m; i++)
-        for(int j = 0; j < n; j++)
-            vals[i][j] = matrix[i][j] * val;
+    // Scale each row on the worker that owns it
+    std::vector<std::vector<double>> vals = buildRows(m, n, [this, val](int i, double *row) {
+        for(int j = 0; j < n; j++) row[j] = matrix[i][j] * val;
+    });
     // Return the resulting matrix
-    return Matrix(fp, vals);
+    return Matrix(fp, std::move(vals));
 }
 
 Matrix Matrix::operator*(int val) {
@@ -137,14 +272,12 @@ Matrix Matrix::operator*(float val) {
 }
 
 Matrix Matrix::operator/(double val) {
-    // Initialize array to hold resulting values
-    std::vector<std::vector<double>> vals(m, std::vector<double>(n));
-    // Loop through scaling values
-    for(int i = 0; i < m; i++)
-        for(int j = 0; j < n; j++)
-            vals[i][j] = matrix[i][j] / val;
+    // Scale each row on the worker that owns it
+    std::vector<std::vector<double>> vals = buildRows(m, n, [this, val](int i, double *row) {
+        for(int j = 0; j < n; j++) row[j] = matrix[i][j] / val;
+    });
     // Return the resulting matrix
-    return Matrix(fp, vals);
+    return Matrix(fp, std::move(vals));
 }
 
 Matrix Matrix::operator/(int val) {
@@ -163,8 +296,7 @@ bool Matrix::operator==(Matrix &other){
     if(m != other.rows() || n != other.columns()) return false;
     // Otherwise iterate through and if mismatch occurs return false
     for(int i = 0; i < m; i++)
-        for(int j = 0; j < n; j++)
-            if(matrix[i][j] != other.access(i + 1, j + 1)) return false;
+        if(matrix[i] != other.matrix[i]) return false;
     // If all were equal return true
     return true;
 }
@@ -177,47 +309,204 @@ bool Matrix::operator!=(Matrix &other){
 Matrix Matrix::operator+(Matrix &other) {
     // If dimensions don't match display error message
     if(m != other.rows() || n != other.columns()) Logger::logInvalidDimensions(fp, m, n, other.getFilePath(), other.rows(), other.columns());
-    // Initialize values grid for new matrix
-    std::vector<std::vector<double>> vals(m, std::vector<double>(n));
-    // Loop through all indices in output grid
-    for(int i = 0; i < m; i++)
-        for(int j = 0; j < n; j++)
-            // Each index is the sum of the two in the input
-            vals[i][j] = matrix[i][j] + other.access(i + 1, j + 1);
+    // Each index is the sum of the two in the input, row by row on the worker that owns it
+    std::vector<std::vector<double>> vals = buildRows(m, n, [this, &other](int i, double *row) {
+        for(int j = 0; j < n; j++) row[j] = matrix[i][j] + other.matrix[i][j];
+    });
     // Return the resulting matrix
-    return Matrix(fp, vals);
+    return Matrix(fp, std::move(vals));
 }
 
 Matrix Matrix::operator-() {
-    // Initialize values grid for new matrix
-    std::vector<std::vector<double>> vals(m, std::vector<double>(n));
-    // Loop through all indices in output grid
-    for(int i = 0; i < m; i++)
-        for(int j = 0; j < n; j++)
-            // Each index is the negative of its value in matrix
-            vals[i][j] = -matrix[i][j];
+    // Each index is the negative of its value in matrix, row by row on the worker that owns it
+    std::vector<std::vector<double>> vals = buildRows(m, n, [this](int i, double *row) {
+        for(int j = 0; j < n; j++) row[j] = -matrix[i][j];
+    });
     // Return the resulting matrix
-    return Matrix(fp, vals);
+    return Matrix(fp, std::move(vals));
 }
 
 Matrix Matrix::operator-(Matrix &other) {
     // If dimensions don't match display error message
     if(m != other.rows() || n != other.columns()) Logger::logInvalidDimensions(fp, m, n, other.getFilePath(), other.rows(), other.columns());
-    // Initialize values grid for new matrix
-    std::vector<std::vector<double>> vals(m, std::vector<double>(n));
-    // Loop through all indices in output grid
-    for(int i = 0; i < m; i++)
-        for(int j = 0; j < n; j++)
-            // Each index is the subtraction of the two in the input
-            vals[i][j] = matrix[i][j] - other.access(i + 1, j + 1);
+    // Each index is the subtraction of the two in the input, row by row on the worker that owns it
+    std::vector<std::vector<double>> vals = buildRows(m, n, [this, &other](int i, double *row) {
+        for(int j = 0; j < n; j++) row[j] = matrix[i][j] - other.matrix[i][j];
+    });
     // Return the resulting matrix
-    return Matrix(fp, vals);
+    return Matrix(fp, std::move(vals));
 }
 
 //////////////////////////////////////////
 //  Functions for Matrix objects
 //////////////////////////////////////////
 
+void Matrix::rankOneUpdate(double alpha, Vector &x, Vector &y) {
+    // If dimensions don't match display error message
+    if(m != x.size() || n != y.size()) Logger::logInvalidDimensions(fp, m, n, x.getFilePath(), x.size(), y.size());
+    // Gather the row pointers for the kernel, splitting the rows from any copy
+    std::vector<std::vector<double>> &values = matrix.write();
+    std::vector<double*> rows(m);
+    for(int i = 0; i < m; i++) rows[i] = values[i].data();
+    // Add the scaled outer product into each row
+    ger(m, n, alpha, x.values.data(), y.values.data(), rows.data());
+    version = ++versions;
+}
+
+Matrix Matrix::transpose() {
+    std::vector<Matrix> values;
+    if(recall("transpose", values)) return values[0];
+    // Copy square tiles so the columns being read and the rows being written both stay in cache
+    TuningProfile profile = getTuningProfile();
+    int tile = profile.transposeBlock;
+    const std::vector<std::vector<double>> &rows = matrix.read();
+    std::vector<std::vector<double>> vals(n);
+    int grain = std::max(tile, profile.parallelValues / std::max(m, 1));
+    parallelFor(0, n, grain, [&](int lo, int hi) {
+        PlacementScope placement;
+        for(int j = lo; j < hi; j++) vals[j].resize(m);
+        for(int j0 = lo; j0 < hi; j0 += tile) {
+            int j1 = std::min(hi, j0 + tile);
+            for(int i0 = 0; i0 < m; i0 += tile) {
+                int i1 = std::min(m, i0 + tile);
+                for(int i = i0; i < i1; i++) {
+                    const double *row = rows[i].data();
+                    for(int j = j0; j < j1; j++) vals[j][i] = row[j];
+                }
+            }
+        }
+    });
+    return remember("transpose", {Matrix(fp, std::move(vals))})[0];
+}
+
+double Matrix::normFrobenius() {
+    std::vector<Matrix> values;
+    if(recall(reductionKind("normFrobenius"), values)) return values[0].matrix[0][0];
+    // Sum the squares of every value
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    double sum = reduceMatrix(m, n, rows.data(), REDUCE_SQUARES, 1);
+    double result = std::sqrt(sum);
+    // Squares that overflow or underflow are summed again scaled by the largest magnitude
+    if(m > 0 && n > 0 && (std::isinf(sum) || sum < std::numeric_limits<double>::min())) {
+        double largest = std::fmax(std::fabs(maximum()), std::fabs(minimum()));
+        if(largest > 0 && std::isfinite(largest) && std::isfinite(1 / largest))
+            result = largest * std::sqrt(reduceMatrix(m, n, rows.data(), REDUCE_SQUARES, 1 / largest));
+    }
+    return remember(reductionKind("normFrobenius"), {Matrix(fp, {{result}})})[0].matrix[0][0];
+}
+
+double Matrix::normOne() {
+    std::vector<Matrix> values;
+    if(recall(reductionKind("normOne"), values)) return values[0].matrix[0][0];
+    // Take the largest absolute column sum
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    std::vector<double> sums(n);
+    reduceColumns(m, n, rows.data(), REDUCE_ABSOLUTE, sums.data());
+    double result = n > 0 ? *std::max_element(sums.begin(), sums.end()) : 0;
+    return remember(reductionKind("normOne"), {Matrix(fp, {{result}})})[0].matrix[0][0];
+}
+
+double Matrix::normInfinity() {
+    std::vector<Matrix> values;
+    if(recall(reductionKind("normInfinity"), values)) return values[0].matrix[0][0];
+    // Take the largest absolute row sum
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    std::vector<double> sums(m);
+    reduceRows(m, n, rows.data(), REDUCE_ABSOLUTE, sums.data());
+    double result = m > 0 ? *std::max_element(sums.begin(), sums.end()) : 0;
+    return remember(reductionKind("normInfinity"), {Matrix(fp, {{result}})})[0].matrix[0][0];
+}
+
+double Matrix::sum() {
+    std::vector<Matrix> values;
+    if(recall(reductionKind("sum"), values)) return values[0].matrix[0][0];
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    double result = reduceMatrix(m, n, rows.data(), REDUCE_VALUES, 1);
+    return remember(reductionKind("sum"), {Matrix(fp, {{result}})})[0].matrix[0][0];
+}
+
+double Matrix::mean() {
+    return sum() / ((double) m * n);
+}
+
+double Matrix::trace() {
+    // Gather the diagonal so it sums with the same tree as a single row
+    std::vector<double> diagonal(std::min(m, n));
+    for(int i = 0; i < (int) diagonal.size(); i++) diagonal[i] = matrix[i][i];
+    const double *row = diagonal.data();
+    double result = 0;
+    reduceRows(1, (int) diagonal.size(), &row, REDUCE_VALUES, &result);
+    return result;
+}
+
+double Matrix::minimum() {
+    int row, column;
+    return minimum(row, column);
+}
+
+double Matrix::minimum(int &row, int &column) {
+    row = column = 0;
+    if(m == 0 || n == 0) return std::nan("");
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    findExtreme(m, n, rows.data(), false, row, column);
+    return matrix[row++][column++];
+}
+
+double Matrix::maximum() {
+    int row, column;
+    return maximum(row, column);
+}
+
+double Matrix::maximum(int &row, int &column) {
+    row = column = 0;
+    if(m == 0 || n == 0) return std::nan("");
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    findExtreme(m, n, rows.data(), true, row, column);
+    return matrix[row++][column++];
+}
+
+Vector Matrix::rowSums() {
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    std::vector<double> sums(m);
+    reduceRows(m, n, rows.data(), REDUCE_VALUES, sums.data());
+    return Vector(fp, sums);
+}
+
+Vector Matrix::columnSums() {
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    std::vector<double> sums(n);
+    reduceColumns(m, n, rows.data(), REDUCE_VALUES, sums.data());
+    return Vector(fp, sums);
+}
+
+Vector Matrix::rowMeans() {
+    Vector result = rowSums();
+    for(double &value : result.values) value /= n;
+    return result;
+}
+
+Vector Matrix::columnMeans() {
+    Vector result = columnSums();
+    for(double &value : result.values) value /= m;
+    return result;
+}
+
+Vector Matrix::rowNorms() {
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    std::vector<double> norms(m);
+    reduceRows(m, n, rows.data(), REDUCE_SQUARES, norms.data());
+    for(double &value : norms) value = std::sqrt(value);
+    return Vector(fp, norms);
+}
+
+Vector Matrix::columnNorms() {
+    std::vector<const double*> rows = rowPointers(matrix.read());
+    std::vector<double> norms(n);
+    reduceColumns(m, n, rows.data(), REDUCE_SQUARES, norms.data());
+    for(double &value : norms) value = std::sqrt(value);
+    return Vector(fp, norms);
+}
+
 double determinantHelper(std::vector<std::vector<double>> matrix, int n){
     // Initialize result to 0 and subMatrix of NxN dimensions
     int result = 0;
@@ -257,11 +546,17 @@ double determinantHelper(std::vector<std::vector<double>> matrix, int n){
 int Matrix::determinant(){
     // Check if dimensions are invalid and log if so
     if(m != n) Logger::logInvalidDeterminant(fp);
+    std::vector<Matrix> values;
+    if(recall("determinant", values)) return values[0].matrix[0][0];
     // Otherwise use recursive helper to calculate determinant
-    return determinantHelper(matrix, m);
+    int result = determinantHelper(matrix.read(), m);
+    remember("determinant", {Matrix(fp, {{(double) result}})});
+    return result;
 }
 
 Matrix Matrix::inverse() {
+    std::vector<Matrix> values;
+    if(recall("inverse", values)) return values[0];
     // Calculate the denominator for the resulting matrix
     float denominator;
     try {
@@ -287,7 +582,7 @@ Matrix Matrix::inverse() {
             // Mark position we are calculating
             vals[row][col] = 1;
             // Calculate numerator and store result
-            int numerator = Matrix(fp, vals).determinant();
+            int numerator = determinantHelper(vals, m);
             result[col][row] = numerator / denominator;
             // Unmark our position to move on
             vals[row][col] = 0;
@@ -296,7 +591,7 @@ Matrix Matrix::inverse() {
         for(int row = 0; row < this->rows(); row++) vals[row][col] = matrix[row][col];
     }
     // Return the resulting matrix
-    return Matrix(fp, result);
+    return remember("inverse", {Matrix(fp, std::move(result))})[0];
 }
 
 //////////////////////////////////////////
@@ -305,6 +600,8 @@ Matrix Matrix::inverse() {
 
 std::vector<Matrix> Matrix::decomposeLU(){
     if(m != n) Logger::logInvalidLUDecomposition(fp);
+    std::vector<Matrix> values;
+    if(recall("lu", values)) return values;
     // Initialize the result vector L and U for decomposing the Matrix into
     std::vector<std::vector<double>> L(m, std::vector<double>(n));
     std::vector<std::vector<double>> U(m, std::vector<double>(n));
@@ -342,5 +639,458 @@ std::vector<Matrix> Matrix::decomposeLU(){
         }
     }
     // Once done return the resulting Matrices
-    return {Matrix(fp, L), Matrix(fp, U)};
-}
\ No newline at end of file
+    return remember("lu", {Matrix(fp, L), Matrix(fp, U)});
+}
+
+std::vector<Matrix> Matrix::decomposeCholesky() {
+    // The matrix must be square and symmetric
+    if(m != n) Logger::logInvalidCholesky(fp);
+    std::vector<Matrix> values;
+    if(recall("cholesky", values)) return values;
+    std::vector<double> L = flatten();
+    if(!isSymmetric(n, L.data())) Logger::logInvalidCholesky(fp);
+    // Factor in place, failing at the first pivot that is not positive
+    if(!choleskyFactor(n, L.data())) Logger::logInvalidCholesky(fp);
+    // Build the upper factor as the transpose of the lower
+    std::vector<double> U((long long) n * n);
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j <= i; j++) U[(long long) j * n + i] = L[(long long) i * n + j];
+    return remember("cholesky", {Matrix(fp, n, n, L), Matrix(fp, n, n, U)});
+}
+
+std::vector<Matrix> Matrix::decomposeLDLT() {
+    // The matrix must be square and symmetric
+    if(m != n) Logger::logInvalidLDLT(fp);
+    std::vector<Matrix> values;
+    if(recall("ldlt", values)) return values;
+    std::vector<double> work = flatten();
+    if(!isSymmetric(n, work.data())) Logger::logInvalidLDLT(fp);
+    // Factor in place, failing if the matrix is singular
+    std::vector<int> perm(n), pivots(n);
+    if(!ldltFactor(n, work.data(), perm.data(), pivots.data())) Logger::logInvalidLDLT(fp);
+    // Split the factored matrix into L, D and P
+    std::vector<double> L((long long) n * n), D((long long) n * n), P((long long) n * n);
+    for(int i = 0; i < n; i++) {
+        L[(long long) i * n + i] = 1;
+        D[(long long) i * n + i] = work[(long long) i * n + i];
+        P[(long long) i * n + perm[i]] = 1;
+        for(int j = 0; j < i; j++) L[(long long) i * n + j] = work[(long long) i * n + j];
+    }
+    // The subdiagonal entry of each 2x2 block belongs to D rather than L
+    for(int k = 0; k < n; k += pivots[k]) {
+        if(pivots[k] != 2) continue;
+        double value = work[(long long) (k + 1) * n + k];
+        L[(long long) (k + 1) * n + k] = 0;
+        D[(long long) (k + 1) * n + k] = value;
+        D[(long long) k * n + k + 1] = value;
+    }
+    return remember("ldlt", {Matrix(fp, n, n, L), Matrix(fp, n, n, D), Matrix(fp, n, n, P)});
+}
+
+Matrix Matrix::solveCholesky(Matrix &b) {
+    // The right hand sides must have a row for each row of the matrix
+    if(m != n) Logger::logInvalidCholesky(fp);
+    if(b.rows() != n) Logger::logInvalidDimensions(fp, m, n, b.getFilePath(), b.rows(), b.columns());
+    // Reuse the factor of earlier solves against the same contents
+    std::vector<double> L = decomposeCholesky()[0].flatten();
+    // Solve against a copy of the right hand sides
+    std::vector<double> x = b.flatten();
+    choleskySolve(n, L.data(), b.columns(), x.data());
+    return Matrix(fp, n, b.columns(), x);
+}
+
+Matrix Matrix::solveLDLT(Matrix &b) {
+    // The right hand sides must have a row for each row of the matrix
+    if(m != n) Logger::logInvalidLDLT(fp);
+    if(b.rows() != n) Logger::logInvalidDimensions(fp, m, n, b.getFilePath(), b.rows(), b.columns());
+    std::vector<double> work = flatten();
+    if(!isSymmetric(n, work.data())) Logger::logInvalidLDLT(fp);
+    std::vector<int> perm(n), pivots(n);
+    if(!ldltFactor(n, work.data(), perm.data(), pivots.data())) Logger::logInvalidLDLT(fp);
+    // Solve against a copy of the right hand sides
+    std::vector<double> x = b.flatten();
+    ldltSolve(n, work.data(), perm.data(), pivots.data(), b.columns(), x.data());
+    return Matrix(fp, n, b.columns(), x);
+}
+
+Matrix Matrix::solveLU(Matrix &b) {
+    // The right hand sides must have a row for each row of the matrix
+    if(m != n) Logger::logInvalidSolve(fp);
+    if(b.rows() != n) Logger::logInvalidDimensions(fp, m, n, b.getFilePath(), b.rows(), b.columns());
+    std::vector<double> work = flatten();
+    std::vector<int> perm(n);
+    if(!luFactor(n, work.data(), perm.data())) Logger::logInvalidSolve(fp);
+    // Solve against a copy of the right hand sides
+    std::vector<double> x = b.flatten();
+    luSolve(n, work.data(), perm.data(), b.columns(), x.data());
+    return Matrix(fp, n, b.columns(), x);
+}
+
+Matrix Matrix::solveMixed(Matrix &b) {
+    int refinements;
+    return solveMixed(b, refinements);
+}
+
+/**
+ * @brief Stores the largest magnitude of each column of a row-major m x n matrix
+ */
+static void columnMaxima(int m, int n, const double *a, std::vector<double> &maxima) {
+    maxima.assign(n, 0);
+    for(int i = 0; i < m; i++)
+        for(int j = 0; j < n; j++) maxima[j] = std::fmax(maxima[j], std::fabs(a[(long long) i * n + j]));
+}
+
+Matrix Matrix::solveMixed(Matrix &b, int &refinements) {
+    // The right hand sides must have a row for each row of the matrix
+    if(m != n) Logger::logInvalidSolve(fp);
+    if(b.rows() != n) Logger::logInvalidDimensions(fp, m, n, b.getFilePath(), b.rows(), b.columns());
+    int r = b.columns();
+    std::vector<double> work = flatten();
+    std::vector<double> rhs = b.flatten();
+    std::vector<int> perm(n);
+    refinements = 0;
+    // Factor a single precision copy, where nearly all of the time goes
+    std::vector<float> low(work.begin(), work.end());
+    if(luFactor(n, low.data(), perm.data())) {
+        // Start from the single precision solution
+        std::vector<float> correction(rhs.begin(), rhs.end());
+        luSolve(n, low.data(), perm.data(), r, correction.data());
+        std::vector<double> x(correction.begin(), correction.end());
+        // A column is done once its residual is at the level of double precision rounding
+        double norm = 0;
+        for(int i = 0; i < n; i++) {
+            double sum = 0;
+            for(int j = 0; j < n; j++) sum += std::fabs(work[(long long) i * n + j]);
+            norm = std::fmax(norm, sum);
+        }
+        double threshold = std::sqrt((double) n) * norm * 1.1102230246251565e-16;
+        std::vector<double> residual(rhs.size()), residualNorms, solutionNorms, previous(r, INFINITY);
+        std::vector<const double*> rows(n);
+        for(int i = 0; i < n; i++) rows[i] = work.data() + (long long) i * n;
+        while(true) {
+            // Compute the residual R = B - A * X in double precision
+            std::fill(residual.begin(), residual.end(), 0);
+            if(r == 1) gemv(n, n, rows.data(), x.data(), residual.data());
+            else gemm(n, r, n, work.data(), n, x.data(), r, residual.data(), r, true);
+            for(long long i = 0; i < (long long) residual.size(); i++) residual[i] = rhs[i] - residual[i];
+            columnMaxima(n, r, residual.data(), residualNorms);
+            columnMaxima(n, r, x.data(), solutionNorms);
+            bool converged = true, stalled = false;
+            for(int j = 0; j < r; j++) {
+                if(residualNorms[j] <= threshold * solutionNorms[j]) continue;
+                converged = false;
+                // Refinement that fails to halve the residual will not reach double precision
+                if(!(residualNorms[j] <= 0.5 * previous[j])) stalled = true;
+            }
+            if(converged) return Matrix(fp, n, r, x);
+            if(stalled || refinements == REFINEMENT_STEPS) break;
+            previous = residualNorms;
+            // Solve for the correction with the single precision factors
+            std::copy(residual.begin(), residual.end(), correction.begin());
+            luSolve(n, low.data(), perm.data(), r, correction.data());
+            for(long long i = 0; i < (long long) x.size(); i++) x[i] += correction[i];
+            refinements++;
+        }
+    }
+    // Fall back to factoring in double precision
+    refinements = -1;
+    if(!luFactor(n, work.data(), perm.data())) Logger::logInvalidSolve(fp);
+    luSolve(n, work.data(), perm.data(), r, rhs.data());
+    return Matrix(fp, n, r, rhs);
+}
+
+/**
+ * @brief Returns whether an m x n problem is tall and skinny enough for TSQR to pay off
+ */
+static bool useTSQR(int m, int n) {
+    return getThreadCount() > 1 && m >= 8 * n && (long long) m * n >= (1 << 14);
+}
+
+std::vector<Matrix> Matrix::decomposeQR() {
+    std::vector<Matrix> values;
+    if(recall("qr", values)) return values;
+    int k = m < n ? m : n;
+    std::vector<double> work = flatten();
+    std::vector<double> Q((long long) m * k), R((long long) k * n);
+    // Tall and skinny matrices factor blocks of rows in parallel
+    if(useTSQR(m, n)) {
+        tsqr(m, n, work.data(), R.data(), Q.data(), 0, 0);
+        return remember("qr", {Matrix(fp, m, k, Q), Matrix(fp, k, n, R)});
+    }
+    // Otherwise use the blocked factorization and split out its factors
+    std::vector<double> tau(k);
+    qrFactor(m, n, work.data(), tau.data());
+    for(int i = 0; i < k; i++)
+        for(int j = i; j < n; j++) R[(long long) i * n + j] = work[(long long) i * n + j];
+    qrFormQ(m, n, work.data(), tau.data(), Q.data());
+    return remember("qr", {Matrix(fp, m, k, Q), Matrix(fp, k, n, R)});
+}
+
+std::vector<Matrix> Matrix::decomposeQRPivoted() {
+    std::vector<Matrix> values;
+    if(recall("qrpivoted", values)) return values;
+    int k = m < n ? m : n;
+    std::vector<double> work = flatten();
+    std::vector<double> tau(k);
+    std::vector<int> jpvt(n);
+    qrPivotedFactor(m, n, work.data(), tau.data(), jpvt.data());
+    // Split out the factors and the permutation
+    std::vector<double> Q((long long) m * k), R((long long) k * n), P((long long) n * n);
+    for(int i = 0; i < k; i++)
+        for(int j = i; j < n; j++) R[(long long) i * n + j] = work[(long long) i * n + j];
+    for(int j = 0; j < n; j++) P[(long long) jpvt[j] * n + j] = 1;
+    qrFormQ(m, n, work.data(), tau.data(), Q.data());
+    return remember("qrpivoted", {Matrix(fp, m, k, Q), Matrix(fp, k, n, R), Matrix(fp, n, n, P)});
+}
+
+int Matrix::rank() {
+    std::vector<Matrix> values;
+    if(recall("rank", values)) return values[0].matrix[0][0];
+    int k = m < n ? m : n;
+    std::vector<double> work = flatten();
+    std::vector<double> tau(k);
+    std::vector<int> jpvt(n);
+    qrPivotedFactor(m, n, work.data(), tau.data(), jpvt.data());
+    // Count the diagonal entries that stand above rounding relative to the largest
+    double threshold = (m > n ? m : n) * 2.220446049250313e-16 * (k > 0 ? std::fabs(work[0]) : 0);
+    int result = 0;
+    for(int i = 0; i < k; i++)
+        if(std::fabs(work[(long long) i * n + i]) > threshold) result++;
+    remember("rank", {Matrix(fp, {{(double) result}})});
+    return result;
+}
+
+Matrix Matrix::leastSquares(Matrix &b) {
+    // The problem must not be underdetermined and the right hand sides must match
+    if(m < n) Logger::logInvalidLeastSquares(fp);
+    if(b.rows() != m) Logger::logInvalidDimensions(fp, m, n, b.getFilePath(), b.rows(), b.columns());
+    int r = b.columns();
+    std::vector<double> work = flatten();
+    std::vector<double> x = b.flatten();
+    std::vector<double> R;
+    // Reduce the right hand sides to Q^T * B alongside the factorization
+    if(useTSQR(m, n)) {
+        R.assign((long long) n * n, 0);
+        tsqr(m, n, work.data(), R.data(), 0, r, x.data());
+    } else {
+        std::vector<double> tau(n);
+        qrFactor(m, n, work.data(), tau.data());
+        qrApplyTranspose(m, n, work.data(), tau.data(), r, x.data());
+        R.assign(work.begin(), work.begin() + (long long) n * n);
+    }
+    // A rank deficient R has no unique solution
+    double largest = 0;
+    for(int i = 0; i < n; i++) largest = std::fmax(largest, std::fabs(R[(long long) i * n + i]));
+    for(int i = 0; i < n; i++)
+        if(!(std::fabs(R[(long long) i * n + i]) > m * 2.220446049250313e-16 * largest)) Logger::logInvalidLeastSquares(fp);
+    // Back substitute R * X = (Q^T * B)[0:n]
+    x.resize((long long) n * r);
+    upperTriangularSolve(n, R.data(), n, r, x.data());
+    return Matrix(fp, n, r, x);
+}
+
+std::vector<Matrix> Matrix::eigenSymmetric() {
+    std::vector<Matrix> values;
+    if(recall("eigen", values)) return values;
+    // The matrix must be square and symmetric
+    std::vector<double> work = flatten();
+    if(m != n || !isSymmetric(n, work.data())) Logger::logInvalidEigen(fp);
+    // Reduce to tridiagonal form, solve, then rotate the eigenvectors back
+    std::vector<double> d(n), e(n), tau(n), z((long long) n * n);
+    tridiagonalize(n, work.data(), d.data(), e.data(), tau.data());
+    if(!tridiagonalEigen(n, d.data(), e.data(), z.data())) Logger::logInvalidEigen(fp);
+    tridiagonalApplyQ(n, work.data(), tau.data(), n, z.data());
+    return remember("eigen", {Matrix(fp, n, 1, d), Matrix(fp, n, n, z)});
+}
+
+std::vector<Matrix> Matrix::eigenSymmetric(int k) {
+    // The matrix must be square and symmetric with a sensible number of eigenpairs
+    std::vector<double> work = flatten();
+    if(m != n || k < 1 || k > n || !isSymmetric(n, work.data())) Logger::logInvalidEigen(fp);
+    // Only k vectors of the tridiagonal matrix are computed and rotated back
+    std::vector<double> d(n), e(n), tau(n), values(k), z((long long) n * k);
+    tridiagonalize(n, work.data(), d.data(), e.data(), tau.data());
+    tridiagonalLargest(n, d.data(), e.data(), k, values.data(), z.data());
+    tridiagonalApplyQ(n, work.data(), tau.data(), k, z.data());
+    return {Matrix(fp, k, 1, values), Matrix(fp, n, k, z)};
+}
+
+Matrix Matrix::eigenvaluesSymmetric() {
+    std::vector<Matrix> values;
+    if(recall("eigenvalues", values)) return values[0];
+    // The matrix must be square and symmetric
+    std::vector<double> work = flatten();
+    if(m != n || !isSymmetric(n, work.data())) Logger::logInvalidEigen(fp);
+    // The reflectors are not needed once the tridiagonal matrix is known
+    std::vector<double> d(n), e(n), tau(n);
+    tridiagonalize(n, work.data(), d.data(), e.data(), tau.data());
+    if(!tridiagonalEigen(n, d.data(), e.data(), 0)) Logger::logInvalidEigen(fp);
+    return remember("eigenvalues", {Matrix(fp, n, 1, d)})[0];
+}
+
+std::vector<Matrix> Matrix::truncatedSVD(MatrixStream &stream, int k, int oversampling, int powerIterations, double &error) {
+    // The rank must fit the matrix and the sampling parameters must make sense
+    int m = stream.rows(), n = stream.columns();
+    if(k < 1 || k > std::min(m, n) || oversampling < 0 || powerIterations < 0) Logger::logInvalidSVD(stream.getFilePath());
+    std::vector<double> u((long long) m * k), sigma(k), vt((long long) k * n);
+    randomizedSVD(stream, k, oversampling, powerIterations, u.data(), sigma.data(), vt.data(), error);
+    return {Matrix(stream.getFilePath(), m, k, u), Matrix(stream.getFilePath(), k, 1, sigma), Matrix(stream.getFilePath(), k, n, vt)};
+}
+
+std::vector<Matrix> Matrix::truncatedSVD(int k, int oversampling, int powerIterations, double &error) {
+    // Stream over a flat copy of the values
+    std::vector<double> values = flatten();
+    MemoryMatrixStream stream(fp, m, n, values.data());
+    return truncatedSVD(stream, k, oversampling, powerIterations, error);
+}
+
+/**
+ * @brief Finds the cheapest split of every run of a chain, returning the cost of the
+ * whole chain. split[i][j] is the last operand of the left side of run i..j
+ */
+static double planChain(std::vector<Matrix> &operands, std::vector<std::vector<int>> &split) {
+    int k = operands.size();
+    if(k == 0) Logger::logInvalidChain("an empty chain");
+    // Operand i is dims[i] x dims[i + 1]
+    std::vector<double> dims(k + 1);
+    dims[0] = operands[0].rows();
+    for(int i = 0; i < k; i++) {
+        if(i > 0 && operands[i - 1].columns() != operands[i].rows())
+            Logger::logInvalidDimensions(operands[i - 1].getFilePath(), operands[i - 1].rows(), operands[i - 1].columns(), operands[i].getFilePath(), operands[i].rows(), operands[i].columns());
+        dims[i + 1] = operands[i].columns();
+    }
+    // Cheapest cost of each run, built up from shorter runs
+    std::vector<std::vector<double>> cost(k, std::vector<double>(k, 0));
+    split.assign(k, std::vector<int>(k, 0));
+    for(int length = 2; length <= k; length++)
+        for(int i = 0; i + length <= k; i++) {
+            int j = i + length - 1;
+            cost[i][j] = -1;
+            for(int s = i; s < j; s++) {
+                double candidate = cost[i][s] + cost[s + 1][j] + dims[i] * dims[s + 1] * dims[j + 1];
+                if(cost[i][j] < 0 || candidate < cost[i][j]) {
+                    cost[i][j] = candidate;
+                    split[i][j] = s;
+                }
+            }
+        }
+    return cost[0][k - 1];
+}
+
+/**
+ * @brief Multiplies run i..j of a chain along the planned splits, both sides at once
+ */
+static Matrix multiplyRun(std::vector<Matrix> &operands, std::vector<std::vector<int>> &split, int i, int j) {
+    if(i == j) return operands[i];
+    std::vector<Matrix> sides(2, operands[i]);
+    parallelFor(0, 2, 1, [&](int lo, int hi) {
+        for(int side = lo; side < hi; side++)
+            sides[side] = side == 0 ? multiplyRun(operands, split, i, split[i][j]) : multiplyRun(operands, split, split[i][j] + 1, j);
+    });
+    return sides[0] * sides[1];
+}
+
+/**
+ * @brief Writes the planned parenthesization of run i..j
+ */
+static std::string describeRun(std::vector<std::vector<int>> &split, int i, int j) {
+    if(i == j) return std::to_string(i + 1);
+    return "(" + describeRun(split, i, split[i][j]) + "*" + describeRun(split, split[i][j] + 1, j) + ")";
+}
+
+Matrix Matrix::multiplyChain(std::vector<Matrix> &operands) {
+    std::vector<std::vector<int>> split;
+    planChain(operands, split);
+    return multiplyRun(operands, split, 0, operands.size() - 1);
+}
+
+std::string Matrix::chainOrder(std::vector<Matrix> &operands, double &cost) {
+    std::vector<std::vector<int>> split;
+    cost = planChain(operands, split);
+    return describeRun(split, 0, operands.size() - 1);
+}
+
+std::vector<Matrix> Matrix::truncatedSVD(std::string filepath, int k, int oversampling, int powerIterations, double &error) {
+    // Only one block of rows is held in memory at a time
+    FileMatrixStream stream(filepath);
+    return truncatedSVD(stream, k, oversampling, powerIterations, error);
+}
+
+/**
+ * @brief Returns the fastest of several timed runs of a benchmark, in seconds
+ */
+static double fastestRun(std::function<void()> run) {
+    double best = std::numeric_limits<double>::infinity();
+    for(int repeat = 0; repeat < TUNING_REPEATS; repeat++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+/**
+ * @brief Makes the candidate value of one parameter that times fastest the active one
+ */
+static void tuneParameter(TuningProfile &profile, int TuningProfile::*parameter, std::vector<int> candidates, std::function<void()> run) {
+    double best = std::numeric_limits<double>::infinity();
+    int winner = profile.*parameter;
+    for(int candidate : candidates) {
+        profile.*parameter = candidate;
+        setTuningProfile(profile);
+        double time = fastestRun(run);
+        if(time < best) {
+            best = time;
+            winner = candidate;
+        }
+    }
+    profile.*parameter = winner;
+    setTuningProfile(profile);
+}
+
+TuningProfile Matrix::autotune(int size, bool save) {
+    int n = std::max(size, 32);
+    // Diagonally dominant operands keep every LU pivot well away from zero
+    std::vector<std::vector<double>> values(n, std::vector<double>(n));
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++) values[i][j] = i == j ? 2 * n : std::sin(i * 0.7 + j * 1.3);
+    Matrix a("autotune", values), b = a.transpose();
+    std::vector<std::vector<double>> column(n, std::vector<double>(1, 1));
+    Matrix rhs("autotune", column);
+    TuningProfile profile = getTuningProfile();
+    bool strassen = getStrassenEnabled();
+    // The cache blocks of the classical multiply, searched together since they share the cache
+    setStrassenEnabled(false);
+    double best = std::numeric_limits<double>::infinity();
+    int depth = profile.depthBlock, width = profile.columnBlock;
+    for(int d : {64, 128, 256, 512})
+        for(int w : {128, 256, 512, 1024, 2048}) {
+            profile.depthBlock = d;
+            profile.columnBlock = w;
+            setTuningProfile(profile);
+            double time = fastestRun([&]() { a * b; });
+            if(time < best) {
+                best = time;
+                depth = d;
+                width = w;
+            }
+        }
+    profile.depthBlock = depth;
+    profile.columnBlock = width;
+    tuneParameter(profile, &TuningProfile::rowBlock, {16, 32, 64, 128}, [&]() { a * b; });
+    // The crossover is tuned for callers that opt in to Strassen-Winograd, and crossovers
+    // at or above the size leave the product to the classical kernel
+    setStrassenEnabled(true);
+    std::vector<int> crossovers;
+    for(int c = 64; c < n; c *= 2) crossovers.push_back(c);
+    crossovers.push_back(n);
+    tuneParameter(profile, &TuningProfile::strassenCrossover, crossovers, [&]() { a * b; });
+    setStrassenEnabled(strassen);
+    tuneParameter(profile, &TuningProfile::luBlock, {16, 32, 64, 128}, [&]() { a.solveLU(rhs); });
+    tuneParameter(profile, &TuningProfile::luTile, {128, 256, 512, 1024}, [&]() { a.solveLU(rhs); });
+    // Transposes are cached, so each run starts from a cleared cache
+    tuneParameter(profile, &TuningProfile::transposeBlock, {8, 16, 32, 64, 128}, [&]() { a.clearCache(); a.transpose(); });
+    tuneParameter(profile, &TuningProfile::parallelValues, {1 << 12, 1 << 13, 1 << 14, 1 << 15, 1 << 16, 1 << 17}, [&]() { a + b; });
+    if(save) saveTuningProfile(tuningProfilePath());
+    return getTuningProfile();
+}
@@ -1,14 +1,39 @@
 #include<string>
 #include<vector>
 #include"iohandler.hpp"
+#include"sharedrows.hpp"
+#include"matrixview.hpp"
+#include"tuning.hpp"
 #ifndef MATRIX_HPP
 #define MATRIX_HPP
 
+class Vector;
+class MatrixStream;
+
 /**
- * @brief A class representing a matrix object
+ * @brief A class representing a matrix object. Derived results such as
+ * factorizations, the inverse, the determinant, norms and the transpose are
+ * cached against the version of the contents they were computed from, so
+ * repeated calls on an unchanged matrix return without recomputing
  * 
  */
 class Matrix {
+    friend class MatrixBatch;
+    friend class Vector;
+    friend class MatrixServer;
+    friend class MatrixClient;
+    friend class DistributedMatrix;
+    friend class TriangularMatrix;
+    friend class SymmetricMatrix;
+    friend class BandedMatrix;
+    friend class TridiagonalMatrix;
+    friend class SparseMatrix;
+    friend class UpdatableInverse;
+    friend class UpdatableLU;
+    friend class UpdatableCholesky;
+    friend class UpdatableQR;
+    friend class QuantizedMatrix;
+
     private:
     /** Number of columns in the matrix */
     int m;
@@ -16,8 +41,10 @@ class Matrix {
     int n;
     /** Filepointer used as identifier for logging */
     std::string fp;
-    /** Underlying data structure for the matrix */
-    std::vector<std::vector<double>> matrix;
+    /** Underlying data structure for the matrix, shared between copies until one is written to */
+    SharedRows matrix;
+    /** Identifies the contents of the matrix, renewed on every mutation */
+    unsigned long long version;
 
     /**
      * @brief Special constructor for building a matrix from a given
@@ -28,6 +55,42 @@ class Matrix {
      */
     Matrix(std::string filepath, std::vector<std::vector<double>> vals);
 
+    /**
+     * @brief Special constructor for building a matrix from row-major
+     * contiguous values, as produced by the flat kernels
+     * 
+     * @param filepath filepath identifer for the matrix
+     * @param rows number of rows in the matrix
+     * @param columns number of columns in the matrix
+     * @param vals row-major values to populate matrix with
+     */
+    Matrix(std::string filepath, int rows, int columns, std::vector<double> &vals);
+
+    /**
+     * @brief Copies the matrix into a row-major contiguous buffer
+     * 
+     * @return std::vector<double> row-major values of the matrix
+     */
+    std::vector<double> flatten();
+
+    /**
+     * @brief Looks up a result derived from the current contents of the matrix
+     * 
+     * @param kind name of the derived result
+     * @param values receives the result if it was cached
+     * @return true if the result was cached
+     */
+    bool recall(std::string kind, std::vector<Matrix> &values);
+
+    /**
+     * @brief Caches a result derived from the current contents of the matrix
+     * 
+     * @param kind name of the derived result
+     * @param values the result
+     * @return std::vector<Matrix> the result, for returning directly
+     */
+    std::vector<Matrix> remember(std::string kind, std::vector<Matrix> values);
+
     public:
     /**
      * @brief Constructs a matrix from an input file
@@ -76,6 +139,102 @@ class Matrix {
      */
     double access(int row, int column);
 
+    /**
+     * @brief Returns the value at a given row and column in the matrix without the
+     * cost of access, checking the indices only when MATRIX_BOUNDS_CHECK is set
+     * 
+     * @param row row to access value from
+     * @param column column to access value from
+     * @return double value at the indices in the matrix
+     */
+    double operator()(int row, int column) const {
+#if MATRIX_BOUNDS_CHECK
+        if(row < 1 || row > m) Logger::logInvalidRow(row, fp);
+        if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+#endif
+        return matrix[row - 1][column - 1];
+    }
+
+    /**
+     * @brief Returns the values of a row as a contiguous array, valid until the
+     * matrix is written to or destroyed. The row is checked only when
+     * MATRIX_BOUNDS_CHECK is set
+     * 
+     * @param row row to return
+     * @return const double* first value of the row
+     */
+    const double *rowData(int row) const {
+#if MATRIX_BOUNDS_CHECK
+        if(row < 1 || row > m) Logger::logInvalidRow(row, fp);
+#endif
+        return matrix[row - 1].data();
+    }
+
+    /**
+     * @brief Returns a view of the values of a row, valid until the matrix is
+     * written to or destroyed. The row is checked only when MATRIX_BOUNDS_CHECK is set
+     * 
+     * @param row row to view
+     * @return MatrixSpan view of the row
+     */
+    MatrixSpan rowSpan(int row) const {
+        return MatrixSpan(rowData(row), n);
+    }
+
+    /**
+     * @brief Returns an iterator to the first value, walking the values row by row
+     * 
+     * @return MatrixIterator iterator at row 1 column 1
+     */
+    MatrixIterator begin() const {
+        return MatrixIterator(matrix.read().data(), 0, n);
+    }
+
+    /**
+     * @brief Returns the iterator one past the last value
+     * 
+     * @return MatrixIterator iterator past the last row
+     */
+    MatrixIterator end() const {
+        return MatrixIterator(matrix.read().data(), m, n);
+    }
+
+    /**
+     * @brief Returns an iterator to the top of a column, checked only when
+     * MATRIX_BOUNDS_CHECK is set
+     * 
+     * @param column column to walk
+     * @return ColumnIterator iterator at row 1 of the column
+     */
+    ColumnIterator columnBegin(int column) const {
+#if MATRIX_BOUNDS_CHECK
+        if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+#endif
+        return ColumnIterator(matrix.read().data(), 0, column - 1);
+    }
+
+    /**
+     * @brief Returns the iterator one past the bottom of a column
+     * 
+     * @param column column to walk
+     * @return ColumnIterator iterator past the last row of the column
+     */
+    ColumnIterator columnEnd(int column) const {
+#if MATRIX_BOUNDS_CHECK
+        if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+#endif
+        return ColumnIterator(matrix.read().data(), m, column - 1);
+    }
+
+    /**
+     * @brief Sets the value at a given row and column in the matrix
+     * 
+     * @param row row to set value in
+     * @param column column to set value in
+     * @param value value to store at the indices
+     */
+    void set(int row, int column, double value);
+
     /**
      * @brief Returns the number of rows for a given Matrix
      * 
@@ -98,13 +257,52 @@ class Matrix {
     std::string getFilePath();
 
     /**
-     * @brief Overload multiplication to multiply Matrix's
+     * @brief Returns the version of the matrix contents. Every mutation gives the
+     * matrix a new version, while copies share the version of their original
+     * 
+     * @return unsigned long long version of the contents
+     */
+    unsigned long long getVersion();
+
+    /**
+     * @brief Drops every cached result derived from the current contents of the
+     * matrix, see DerivedCache for the cache shared by all matrices
+     * 
+     */
+    void clearCache();
+
+    /**
+     * @brief Gives the matrix storage of its own. Copies share their values until
+     * one of them is written to, at which point the written one copies them, so
+     * detaching ahead of time moves that copy out of a later write
+     * 
+     */
+    void detach();
+
+    /**
+     * @brief Returns whether the matrix shares its values with a copy
+     * 
+     * @return true if another matrix refers to the same values
+     */
+    bool isShared();
+
+    /**
+     * @brief Overload multiplication to multiply Matrix's. Large square
+     * products use Strassen-Winograd only when enabled, see setStrassenEnabled
      * 
      * @param other matrix being multiplied
      * @return Matrix a matrix that is the result of the multiplication
      */
     Matrix operator*(Matrix &other);
 
+    /**
+     * @brief Overload multiplication to multiply a Matrix by a Vector
+     * 
+     * @param other vector with as many values as the matrix has columns
+     * @return Vector the product as a vector
+     */
+    Vector operator*(Vector &other);
+
     /**
      * @brief Overload multiplication to multiply Matrix by scalar value
      * 
@@ -194,6 +392,142 @@ class Matrix {
      */
     Matrix operator-(Matrix &other);
 
+    /**
+     * @brief Applies the rank one update A += alpha * x * y^T in place
+     * 
+     * @param alpha scale applied to the update
+     * @param x vector with as many values as the matrix has rows
+     * @param y vector with as many values as the matrix has columns
+     */
+    void rankOneUpdate(double alpha, Vector &x, Vector &y);
+
+    /**
+     * @brief Returns the transpose of the Matrix
+     * 
+     * @return Matrix the NxM transpose
+     */
+    Matrix transpose();
+
+    /**
+     * @brief Returns the Frobenius norm, the square root of the sum of squared values
+     * 
+     * @return double the Frobenius norm
+     */
+    double normFrobenius();
+
+    /**
+     * @brief Returns the one norm, the largest sum of absolute values in a column
+     * 
+     * @return double the one norm
+     */
+    double normOne();
+
+    /**
+     * @brief Returns the infinity norm, the largest sum of absolute values in a row
+     * 
+     * @return double the infinity norm
+     */
+    double normInfinity();
+
+    /**
+     * @brief Returns the sum of every value. Like every reduction of the Matrix it
+     * adds in a fixed tree, so the result is bitwise identical for any thread count,
+     * and it is compensated when setCompensatedSummation is on
+     *
+     * @return double the sum
+     */
+    double sum();
+
+    /**
+     * @brief Returns the mean of every value
+     *
+     * @return double the sum divided by M * N
+     */
+    double mean();
+
+    /**
+     * @brief Returns the trace, the sum of the values on the main diagonal
+     *
+     * @return double the sum of the first min(M, N) diagonal values
+     */
+    double trace();
+
+    /**
+     * @brief Returns the smallest value, skipping any that are not a number
+     *
+     * @return double the smallest value
+     */
+    double minimum();
+
+    /**
+     * @brief Returns the smallest value along with where it is, the first in
+     * row-major order when several are equal
+     *
+     * @param row receives the row of the value
+     * @param column receives the column of the value
+     * @return double the smallest value
+     */
+    double minimum(int &row, int &column);
+
+    /**
+     * @brief Returns the largest value, skipping any that are not a number
+     *
+     * @return double the largest value
+     */
+    double maximum();
+
+    /**
+     * @brief Returns the largest value along with where it is, the first in
+     * row-major order when several are equal
+     *
+     * @param row receives the row of the value
+     * @param column receives the column of the value
+     * @return double the largest value
+     */
+    double maximum(int &row, int &column);
+
+    /**
+     * @brief Returns the sum of each row
+     *
+     * @return Vector the M row sums
+     */
+    Vector rowSums();
+
+    /**
+     * @brief Returns the sum of each column
+     *
+     * @return Vector the N column sums
+     */
+    Vector columnSums();
+
+    /**
+     * @brief Returns the mean of each row
+     *
+     * @return Vector the M row means
+     */
+    Vector rowMeans();
+
+    /**
+     * @brief Returns the mean of each column
+     *
+     * @return Vector the N column means
+     */
+    Vector columnMeans();
+
+    /**
+     * @brief Returns the Euclidean norm of each row
+     *
+     * @return Vector the M row norms
+     */
+    Vector rowNorms();
+
+    /**
+     * @brief Returns the Euclidean norm of each column
+     *
+     * @return Vector the N column norms
+     */
+    Vector columnNorms();
+
     /**
      * @brief Computes the determinant of a Matrix using by recursively
      * breaking the matrix into submatrices until they become a 1x1 or
@@ -218,6 +552,201 @@ class Matrix {
      * @return std::vector<Matrix> Vector containing the Lower(index0) and Upper(index1) output matrices
      */
     std::vector<Matrix> decomposeLU();
+
+    /**
+     * @brief A function that decomposes a symmetric positive definite Matrix into
+     * a Lower matrix and its transpose using a blocked Cholesky factorization
+     * 
+     * @return std::vector<Matrix> Vector containing the Lower(index0) and Upper(index1) output matrices
+     */
+    std::vector<Matrix> decomposeCholesky();
+
+    /**
+     * @brief A function that decomposes a symmetric Matrix so that P * A * P^T = L * D * L^T
+     * using Bunch-Kaufman pivoting, where D is block diagonal with 1x1 and 2x2 blocks
+     * 
+     * @return std::vector<Matrix> Vector containing the Lower(index0), Diagonal(index1) and Permutation(index2) output matrices
+     */
+    std::vector<Matrix> decomposeLDLT();
+
+    /**
+     * @brief Solves A * X = B for a symmetric positive definite Matrix A using
+     * its Cholesky decomposition
+     * 
+     * @param b right hand sides with as many rows as the matrix
+     * @return Matrix the solution X
+     */
+    Matrix solveCholesky(Matrix &b);
+
+    /**
+     * @brief Solves A * X = B for a symmetric Matrix A using its LDL^T decomposition
+     * 
+     * @param b right hand sides with as many rows as the matrix
+     * @return Matrix the solution X
+     */
+    Matrix solveLDLT(Matrix &b);
+
+    /**
+     * @brief Solves A * X = B for an NxN Matrix A using its LU decomposition with
+     * partial pivoting
+     * 
+     * @param b right hand sides with as many rows as the matrix
+     * @return Matrix the solution X
+     */
+    Matrix solveLU(Matrix &b);
+
+    /**
+     * @brief Solves A * X = B by factoring A in single precision, which halves the
+     * memory traffic of the factorization, then refining the solution with residuals
+     * computed in double precision until it is as accurate as solveLU. If the
+     * refinement stalls, as it does for ill-conditioned matrices, the matrix is
+     * factored again in double precision instead
+     * 
+     * @param b right hand sides with as many rows as the matrix
+     * @return Matrix the solution X
+     */
+    Matrix solveMixed(Matrix &b);
+
+    /**
+     * @brief Solves A * X = B by factoring A in single precision and refining the
+     * solution in double precision, reporting how the solve went
+     * 
+     * @param b right hand sides with as many rows as the matrix
+     * @param refinements set to the number of refinement steps taken, or -1 if the
+     * solve fell back to a double precision factorization
+     * @return Matrix the solution X
+     */
+    Matrix solveMixed(Matrix &b, int &refinements);
+
+    /**
+     * @brief A function that decomposes the Matrix into an orthonormal and an upper
+     * triangular Matrix using blocked Householder reflections. Tall and skinny
+     * matrices are factored with the parallel TSQR scheme when threads are available
+     * 
+     * @return std::vector<Matrix> Vector containing the thin Orthonormal(index0) and Upper(index1) output matrices
+     */
+    std::vector<Matrix> decomposeQR();
+
+    /**
+     * @brief A function that decomposes the Matrix so that A * P = Q * R using
+     * Householder reflections with column pivoting, which orders the diagonal of R
+     * by decreasing magnitude
+     * 
+     * @return std::vector<Matrix> Vector containing the thin Orthonormal(index0), Upper(index1) and Permutation(index2) output matrices
+     */
+    std::vector<Matrix> decomposeQRPivoted();
+
+    /**
+     * @brief Returns the numerical rank of the Matrix from its column pivoted QR decomposition
+     * 
+     * @return int number of diagonal entries of R above the rounding threshold
+     */
+    int rank();
+
+    /**
+     * @brief Finds X minimizing the two norm of A * X - B using the QR decomposition,
+     * without forming A^T * A
+     * 
+     * @param b right hand sides with as many rows as the matrix
+     * @return Matrix the least squares solution X
+     */
+    Matrix leastSquares(Matrix &b);
+
+    /**
+     * @brief Computes every eigenvalue and eigenvector of a symmetric Matrix by
+     * blocked Householder tridiagonalization followed by divide and conquer
+     * 
+     * @return std::vector<Matrix> Vector containing the ascending Eigenvalues(index0) as an Nx1 matrix and the Eigenvectors(index1) as the matching columns of an NxN matrix
+     */
+    std::vector<Matrix> eigenSymmetric();
+
+    /**
+     * @brief Computes the k largest eigenvalues of a symmetric Matrix and their
+     * eigenvectors, doing far less work than the full decomposition when k is small
+     * 
+     * @param k number of eigenpairs, between 1 and N
+     * @return std::vector<Matrix> Vector containing the descending Eigenvalues(index0) as a kx1 matrix and the Eigenvectors(index1) as the matching columns of an Nxk matrix
+     */
+    std::vector<Matrix> eigenSymmetric(int k);
+
+    /**
+     * @brief Computes every eigenvalue of a symmetric Matrix without its eigenvectors
+     * 
+     * @return Matrix the eigenvalues in ascending order as an Nx1 matrix
+     */
+    Matrix eigenvaluesSymmetric();
+
+    /**
+     * @brief Computes a rank k approximation of the Matrix with the randomized SVD,
+     * at a cost proportional to k rather than the full decomposition
+     * 
+     * @param k rank of the approximation
+     * @param oversampling extra random samples beyond k, around 10 is typical
+     * @param powerIterations passes that sharpen slowly decaying spectra, 1 or 2 is typical
+     * @param error receives the Frobenius norm of the difference between the Matrix and the approximation
+     * @return std::vector<Matrix> Vector containing the Left(index0) singular vectors as an Mxk matrix, the descending Singular(index1) values as a kx1 matrix and the Right(index2) singular vectors transposed as a kxN matrix
+     */
+    std::vector<Matrix> truncatedSVD(int k, int oversampling, int powerIterations, double &error);
+
+    /**
+     * @brief Computes a rank k approximation of a matrix in an mtx file with the
+     * randomized SVD, streaming the file row by row a fixed number of times instead
+     * of loading it
+     * 
+     * @param filepath filepath to the mtx file
+     * @param k rank of the approximation
+     * @param oversampling extra random samples beyond k
+     * @param powerIterations passes that sharpen slowly decaying spectra
+     * @param error receives the Frobenius norm of the difference between the matrix and the approximation
+     * @return std::vector<Matrix> Vector containing the Left(index0), Singular(index1) and transposed Right(index2) factors
+     */
+    static std::vector<Matrix> truncatedSVD(std::string filepath, int k, int oversampling, int powerIterations, double &error);
+
+    /**
+     * @brief Computes a rank k approximation of any streamed matrix with the
+     * randomized SVD, reading it 2 * powerIterations + 2 times
+     * 
+     * @param stream stream over the matrix
+     * @param k rank of the approximation
+     * @param oversampling extra random samples beyond k
+     * @param powerIterations passes that sharpen slowly decaying spectra
+     * @param error receives the Frobenius norm of the difference between the matrix and the approximation
+     * @return std::vector<Matrix> Vector containing the Left(index0), Singular(index1) and transposed Right(index2) factors
+     */
+    static std::vector<Matrix> truncatedSVD(MatrixStream &stream, int k, int oversampling, int powerIterations, double &error);
+
+    /**
+     * @brief Multiplies a chain of matrices in the order that takes the fewest
+     * scalar multiplications, chosen by dynamic programming on their dimensions.
+     * The two sides of each split are independent and run in parallel
+     * 
+     * @param operands matrices to multiply, each with as many columns as the next has rows
+     * @return Matrix the product of the whole chain
+     */
+    static Matrix multiplyChain(std::vector<Matrix> &operands);
+
+    /**
+     * @brief Returns the order multiplyChain would use, numbering the operands from 1
+     * 
+     * @param operands matrices to multiply, each with as many columns as the next has rows
+     * @param cost receives the number of scalar multiplications of that order
+     * @return std::string the parenthesized chain, such as "((1*2)*3)"
+     */
+    static std::string chainOrder(std::vector<Matrix> &operands, double &cost);
+
+    /**
+     * @brief Benchmarks candidate values of each tuning parameter on this machine
+     * and makes the fastest ones the active profile. The multiply's cache blocks,
+     * rows per thread and Strassen-Winograd crossover are timed on products, the
+     * LU blocks on solves, the transpose tiles on transposes and the parallel
+     * threshold on sums, each search starting from the winners before it. Takes
+     * several seconds at the typical sizes
+     * 
+     * @param size rows and columns of the matrices timed, crossovers above it are not explored
+     * @param save whether to write the profile to tuningProfilePath(), whose directory must exist
+     * @return TuningProfile the tuned profile
+     */
+    static TuningProfile autotune(int size = 512, bool save = true);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include<cmath>
+#include<string>
+#include<vector>
+#include<utility>
+#include"matrixbatch.hpp"
+#include"parallel.hpp"
+
+// Number of matrices processed together as one set of SIMD lanes
+static const int TILE = 64;
+// Minimum number of matrices handed to a single thread
+static const int GRAIN = 1024;
+
+//////////////////////////////////////////
+//  Constructing MatrixBatch objects
+//////////////////////////////////////////
+
+MatrixBatch::MatrixBatch(int size, int rows, int columns) {
+    // Store the shape of the batch and zero the values
+    count = size;
+    m = rows;
+    n = columns;
+    fp = "batch";
+    data.assign((size_t) count * m * n, 0);
+}
+
+MatrixBatch::MatrixBatch(std::vector<Matrix> &matrices) {
+    // Take the shape and identifier from the first matrix
+    count = matrices.size();
+    m = count > 0 ? matrices[0].rows() : 0;
+    n = count > 0 ? matrices[0].columns() : 0;
+    fp = count > 0 ? matrices[0].getFilePath() : "batch";
+    data.assign((size_t) count * m * n, 0);
+    // Interleave the values of every matrix into the batch
+    for(int b = 0; b < count; b++) {
+        Matrix &current = matrices[b];
+        // Every matrix in the batch must share the same shape
+        if(current.rows() != m || current.columns() != n) Logger::logInvalidDimensions(fp, m, n, current.getFilePath(), current.rows(), current.columns());
+        for(int i = 0; i < m; i++)
+            for(int j = 0; j < n; j++)
+                data[(size_t) (i * n + j) * count + b] = current.matrix[i][j];
+    }
+}
+
+MatrixBatch::MatrixBatch(std::vector<std::string> filepaths) {
+    // Log the creation of the batch once rather than once per matrix
+    count = filepaths.size();
+    fp = count > 0 ? filepaths[0] : "batch";
+    Logger::getInstance()->log("Creating a MatrixBatch of " + std::to_string(count) + " matrices from the filepath: " + fp);
+    m = 0;
+    n = 0;
+    // Read each file straight into the interleaved layout
+    for(int b = 0; b < count; b++) {
+        int rows, columns;
+        std::vector<std::vector<double>> values;
+        readMtx(filepaths[b], rows, columns, values);
+        // The first file decides the shape of the batch
+        if(b == 0) {
+            m = rows;
+            n = columns;
+            data.assign((size_t) count * m * n, 0);
+        }
+        if(rows != m || columns != n) Logger::logInvalidDimensions(fp, m, n, filepaths[b], rows, columns);
+        for(int i = 0; i < m; i++)
+            for(int j = 0; j < n; j++)
+                data[(size_t) (i * n + j) * count + b] = values[i][j];
+    }
+}
+
+//////////////////////////////////////////
+//  Accessors for MatrixBatch objects
+//////////////////////////////////////////
+
+int MatrixBatch::size() {
+    // Return the number of matrices in the batch
+    return count;
+}
+
+int MatrixBatch::rows() {
+    // Return the number of rows in each matrix
+    return m;
+}
+
+int MatrixBatch::columns() {
+    // Return the number of columns in each matrix
+    return n;
+}
+
+double MatrixBatch::access(int index, int row, int column) {
+    // Check the bounds of the index, row and column
+    if(index < 1 || index > count) Logger::logInvalidBatchIndex(index, count, fp);
+    if(row < 1 || row > m) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Return the value from the interleaved layout
+    return data[(size_t) ((row - 1) * n + column - 1) * count + index - 1];
+}
+
+void MatrixBatch::set(int index, int row, int column, double value) {
+    // Check the bounds of the index, row and column
+    if(index < 1 || index > count) Logger::logInvalidBatchIndex(index, count, fp);
+    if(row < 1 || row > m) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Store the value in the interleaved layout
+    data[(size_t) ((row - 1) * n + column - 1) * count + index - 1] = value;
+}
+
+Matrix MatrixBatch::get(int index) {
+    // Check the bounds of the index
+    if(index < 1 || index > count) Logger::logInvalidBatchIndex(index, count, fp);
+    // Gather the values of the requested matrix
+    std::vector<std::vector<double>> vals(m, std::vector<double>(n));
+    for(int i = 0; i < m; i++)
+        for(int j = 0; j < n; j++)
+            vals[i][j] = data[(size_t) (i * n + j) * count + index - 1];
+    return Matrix(fp, std::move(vals));
+}
+
+//////////////////////////////////////////
+//  Lane kernels for MatrixBatch objects
+//////////////////////////////////////////
+
+/**
+ * @brief Copies lanes [lo, lo + w) of an interleaved array into a tile
+ */
+static void loadTile(std::vector<double> &data, int count, int elements, int lo, int w, double *tile) {
+    for(int e = 0; e < elements; e++)
+        for(int l = 0; l < w; l++)
+            tile[e * w + l] = data[(size_t) e * count + lo + l];
+}
+
+/**
+ * @brief Copies a tile back into lanes [lo, lo + w) of an interleaved array
+ */
+static void storeTile(std::vector<double> &data, int count, int elements, int lo, int w, double *tile) {
+    for(int e = 0; e < elements; e++)
+        for(int l = 0; l < w; l++)
+            data[(size_t) e * count + lo + l] = tile[e * w + l];
+}
+
+/**
+ * @brief Factors every lane of an n x n tile in place into L and U with partial
+ * pivoting. Pivot choices and row swaps are done with selects so that every lane
+ * follows the same instruction stream
+ *
+ * @param a tile holding element (i, j) of lane l at a[(i * n + j) * w + l]
+ * @param perm receives the original row index of each factored row
+ * @param det receives the determinant of each lane
+ */
+static void factorTile(double *a, double *perm, double *det, int n, int w) {
+    double best[TILE];
+    double pivot[TILE];
+    // Start from the identity permutation and a unit determinant
+    for(int i = 0; i < n; i++)
+        for(int l = 0; l < w; l++) perm[i * w + l] = i;
+    for(int l = 0; l < w; l++) det[l] = 1;
+    for(int k = 0; k < n; k++) {
+        // Find the row with the largest magnitude in this column for each lane
+        for(int l = 0; l < w; l++) {
+            best[l] = std::fabs(a[(k * n + k) * w + l]);
+            pivot[l] = k;
+        }
+        for(int i = k + 1; i < n; i++)
+            for(int l = 0; l < w; l++) {
+                double value = std::fabs(a[(i * n + k) * w + l]);
+                bool larger = value > best[l];
+                best[l] = larger ? value : best[l];
+                pivot[l] = larger ? i : pivot[l];
+            }
+        // Swap row k with the pivot row in the lanes that chose that row
+        for(int i = k + 1; i < n; i++) {
+            for(int j = 0; j < n; j++)
+                for(int l = 0; l < w; l++) {
+                    bool swap = pivot[l] == i;
+                    double top = a[(k * n + j) * w + l];
+                    double bottom = a[(i * n + j) * w + l];
+                    a[(k * n + j) * w + l] = swap ? bottom : top;
+                    a[(i * n + j) * w + l] = swap ? top : bottom;
+                }
+            for(int l = 0; l < w; l++) {
+                bool swap = pivot[l] == i;
+                double top = perm[k * w + l];
+                double bottom = perm[i * w + l];
+                perm[k * w + l] = swap ? bottom : top;
+                perm[i * w + l] = swap ? top : bottom;
+                det[l] = swap ? -det[l] : det[l];
+            }
+        }
+        // Accumulate the determinant and eliminate below the pivot
+        for(int l = 0; l < w; l++) {
+            double diagonal = a[(k * n + k) * w + l];
+            det[l] *= diagonal;
+            pivot[l] = diagonal != 0 ? 1 / diagonal : 0;
+        }
+        for(int i = k + 1; i < n; i++) {
+            for(int l = 0; l < w; l++) a[(i * n + k) * w + l] *= pivot[l];
+            for(int j = k + 1; j < n; j++)
+                for(int l = 0; l < w; l++)
+                    a[(i * n + j) * w + l] -= a[(i * n + k) * w + l] * a[(k * n + j) * w + l];
+        }
+    }
+}
+
+/**
+ * @brief Solves the factored tile against an n x r tile of right hand sides
+ *
+ * @param a tile factored by factorTile
+ * @param perm permutation produced by factorTile
+ * @param b right hand sides, overwritten with the solutions
+ * @param x workspace the size of b
+ */
+static void solveTile(double *a, double *perm, double *b, double *x, int n, int r, int w) {
+    // Apply the row permutation to the right hand sides
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < r; j++)
+            for(int l = 0; l < w; l++)
+                x[(i * r + j) * w + l] = b[((int) perm[i * w + l] * r + j) * w + l];
+    // Forward substitute through the unit lower factor
+    for(int i = 1; i < n; i++)
+        for(int k = 0; k < i; k++)
+            for(int j = 0; j < r; j++)
+                for(int l = 0; l < w; l++)
+                    x[(i * r + j) * w + l] -= a[(i * n + k) * w + l] * x[(k * r + j) * w + l];
+    // Back substitute through the upper factor
+    for(int i = n - 1; i >= 0; i--) {
+        for(int k = i + 1; k < n; k++)
+            for(int j = 0; j < r; j++)
+                for(int l = 0; l < w; l++)
+                    x[(i * r + j) * w + l] -= a[(i * n + k) * w + l] * x[(k * r + j) * w + l];
+        for(int j = 0; j < r; j++)
+            for(int l = 0; l < w; l++)
+                x[(i * r + j) * w + l] /= a[(i * n + i) * w + l];
+    }
+    // Copy the solutions back over the right hand sides
+    for(int e = 0; e < n * r * w; e++) b[e] = x[e];
+}
+
+//////////////////////////////////////////
+//  Operations for MatrixBatch objects
+//////////////////////////////////////////
+
+MatrixBatch MatrixBatch::operator*(MatrixBatch &other) {
+    // If dimensions or batch sizes don't match display error message
+    if(n != other.m || count != other.count) Logger::logInvalidDimensions(fp, m, n, other.fp, other.m, other.n);
+    MatrixBatch result(count, m, other.n);
+    result.fp = fp;
+    int p = other.n;
+    double *a = data.data();
+    double *b = other.data.data();
+    double *c = result.data.data();
+    size_t stride = count;
+    // Each thread multiplies a contiguous range of lanes
+    parallelFor(0, count, GRAIN, [=](int lo, int hi) {
+        for(int i = 0; i < m; i++)
+            for(int j = 0; j < p; j++) {
+                double *out = c + (i * p + j) * stride;
+                // Accumulate the row x column products one lane per element
+                for(int k = 0; k < n; k++) {
+                    double *left = a + (i * n + k) * stride;
+                    double *right = b + (k * p + j) * stride;
+                    for(int l = lo; l < hi; l++) out[l] += left[l] * right[l];
+                }
+            }
+    });
+    return result;
+}
+
+std::vector<double> MatrixBatch::determinant() {
+    // Check if dimensions are invalid and log if so
+    if(m != n) Logger::logInvalidDeterminant(fp);
+    std::vector<double> result(count);
+    // Each thread factors a contiguous range of lanes one tile at a time
+    parallelFor(0, count, GRAIN, [&](int lo, int hi) {
+        std::vector<double> tile(n * n * TILE), perm(n * TILE);
+        for(int start = lo; start < hi; start += TILE) {
+            int w = hi - start < TILE ? hi - start : TILE;
+            loadTile(data, count, n * n, start, w, tile.data());
+            factorTile(tile.data(), perm.data(), result.data() + start, n, w);
+        }
+    });
+    return result;
+}
+
+std::vector<MatrixBatch> MatrixBatch::decomposeLU() {
+    if(m != n) Logger::logInvalidLUDecomposition(fp);
+    // Initialize the output batches
+    MatrixBatch L(count, n, n), U(count, n, n), P(count, n, n);
+    L.fp = fp;
+    U.fp = fp;
+    P.fp = fp;
+    parallelFor(0, count, GRAIN, [&](int lo, int hi) {
+        std::vector<double> tile(n * n * TILE), perm(n * TILE), det(TILE);
+        for(int start = lo; start < hi; start += TILE) {
+            int w = hi - start < TILE ? hi - start : TILE;
+            loadTile(data, count, n * n, start, w, tile.data());
+            factorTile(tile.data(), perm.data(), det.data(), n, w);
+            // Split the packed factors into their own batches
+            for(int i = 0; i < n; i++)
+                for(int j = 0; j < n; j++)
+                    for(int l = 0; l < w; l++) {
+                        size_t at = (size_t) (i * n + j) * count + start + l;
+                        double value = tile[(i * n + j) * w + l];
+                        L.data[at] = i > j ? value : (i == j ? 1 : 0);
+                        U.data[at] = i <= j ? value : 0;
+                        P.data[at] = perm[i * w + l] == j ? 1 : 0;
+                    }
+        }
+    });
+    return {L, U, P};
+}
+
+MatrixBatch MatrixBatch::solve(MatrixBatch &b) {
+    // The system must be square with matching right hand sides
+    if(m != n || b.m != n || b.count != count) Logger::logInvalidSolve(fp);
+    MatrixBatch result = b;
+    int r = b.n;
+    parallelFor(0, count, GRAIN, [&](int lo, int hi) {
+        std::vector<double> tile(n * n * TILE), perm(n * TILE), det(TILE);
+        std::vector<double> rhs(n * r * TILE), work(n * r * TILE);
+        for(int start = lo; start < hi; start += TILE) {
+            int w = hi - start < TILE ? hi - start : TILE;
+            loadTile(data, count, n * n, start, w, tile.data());
+            factorTile(tile.data(), perm.data(), det.data(), n, w);
+            // A singular lane has no solution
+            for(int l = 0; l < w; l++)
+                if(det[l] == 0) Logger::logInvalidSolve(fp + "[" + std::to_string(start + l + 1) + "]");
+            loadTile(result.data, count, n * r, start, w, rhs.data());
+            solveTile(tile.data(), perm.data(), rhs.data(), work.data(), n, r, w);
+            storeTile(result.data, count, n * r, start, w, rhs.data());
+        }
+    });
+    return result;
+}
+
+MatrixBatch MatrixBatch::inverse() {
+    // Check if dimensions are invalid and log if so
+    if(m != n) Logger::logInvalidInverse(fp);
+    // The inverse solves against a batch of identity matrices
+    MatrixBatch identity(count, n, n);
+    identity.fp = fp;
+    for(int i = 0; i < n; i++)
+        for(int b = 0; b < count; b++) identity.data[(size_t) (i * n + i) * count + b] = 1;
+    try {
+        return solve(identity);
+    } catch(std::runtime_error error) {
+        // Report a singular member as an invalid inverse
+        Logger::logInvalidInverse(fp);
+    }
+    return identity;
+}
@@ -0,0 +1,141 @@
+#include<string>
+#include<vector>
+#include"matrix.hpp"
+#ifndef MATRIXBATCH_HPP
+#define MATRIXBATCH_HPP
+
+/**
+ * @brief A class holding many independent matrices of the same shape in an
+ * interleaved structure-of-arrays layout. Element (row, column) of every matrix
+ * in the batch is stored contiguously, so each operation walks the batch one
+ * matrix per SIMD lane instead of one matrix at a time
+ *
+ */
+class MatrixBatch {
+    private:
+    /** Number of matrices in the batch */
+    int count;
+    /** Number of rows in each matrix */
+    int m;
+    /** Number of columns in each matrix */
+    int n;
+    /** Identifier used for logging */
+    std::string fp;
+    /** Element (i, j) of matrix b is stored at data[(i * n + j) * count + b] */
+    std::vector<double> data;
+
+    public:
+    /**
+     * @brief Constructs a batch of zero matrices
+     *
+     * @param size number of matrices in the batch
+     * @param rows number of rows in each matrix
+     * @param columns number of columns in each matrix
+     */
+    MatrixBatch(int size, int rows, int columns);
+
+    /**
+     * @brief Constructs a batch from a list of matrices sharing the same shape
+     *
+     * @param matrices matrices to copy into the batch
+     */
+    MatrixBatch(std::vector<Matrix> &matrices);
+
+    /**
+     * @brief Constructs a batch by reading each of the provided mtx files directly
+     * into the batch, without building intermediate Matrix objects
+     *
+     * @param filepaths filepaths of the mtx files, all of the same shape
+     */
+    MatrixBatch(std::vector<std::string> filepaths);
+
+    /**
+     * @brief Returns the number of matrices in the batch
+     *
+     * @return int number of matrices
+     */
+    int size();
+
+    /**
+     * @brief Returns the number of rows of each matrix in the batch
+     *
+     * @return int number of rows
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of columns of each matrix in the batch
+     *
+     * @return int number of columns
+     */
+    int columns();
+
+    /**
+     * @brief Returns a value from one matrix in the batch
+     *
+     * @param index index of the matrix in the batch
+     * @param row row to access value from
+     * @param column column to access value from
+     * @return double value at the indices
+     */
+    double access(int index, int row, int column);
+
+    /**
+     * @brief Sets a value in one matrix of the batch
+     *
+     * @param index index of the matrix in the batch
+     * @param row row of the value
+     * @param column column of the value
+     * @param value value to store
+     */
+    void set(int index, int row, int column, double value);
+
+    /**
+     * @brief Copies one matrix of the batch out into a Matrix
+     *
+     * @param index index of the matrix in the batch
+     * @return Matrix a copy of the matrix
+     */
+    Matrix get(int index);
+
+    /**
+     * @brief Multiplies every matrix in the batch by its counterpart in other
+     *
+     * @param other batch of right hand operands
+     * @return MatrixBatch batch of the products
+     */
+    MatrixBatch operator*(MatrixBatch &other);
+
+    /**
+     * @brief Computes the determinant of every matrix in the batch using
+     * LU factorization with partial pivoting
+     *
+     * @return std::vector<double> determinants in batch order
+     */
+    std::vector<double> determinant();
+
+    /**
+     * @brief Returns the inverse of every matrix in the batch
+     *
+     * @return MatrixBatch batch of the inverses
+     */
+    MatrixBatch inverse();
+
+    /**
+     * @brief Decomposes every matrix in the batch so that P * A = L * U using
+     * partial pivoting within each matrix
+     *
+     * @return std::vector<MatrixBatch> Lower(index0), Upper(index1) and Permutation(index2) batches
+     */
+    std::vector<MatrixBatch> decomposeLU();
+
+    /**
+     * @brief Solves A * X = B for every matrix A in the batch
+     *
+     * @param b batch of right hand sides with as many rows as A
+     * @return MatrixBatch batch of solutions X
+     */
+    MatrixBatch solve(MatrixBatch &b);
+};
+
+#endif
@@ -0,0 +1,29 @@
+#include<string>
+#include<iostream>
+#include<csignal>
+#include<pthread.h>
+#include"matrixdaemon.hpp"
+
+/**
+ * @brief Runs a MatrixServer until interrupted or terminated
+ *
+ * @param argc number of arguments
+ * @param argv the socket filepath, /tmp/matrixd.sock if not given
+ * @return int exit code
+ */
+int main(int argc, char **argv) {
+    std::string socketPath = argc > 1 ? argv[1] : "/tmp/matrixd.sock";
+    // Block the stop signals so every thread leaves them to sigwait
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, 0);
+    MatrixServer server(socketPath);
+    server.start();
+    std::cout << "Serving matrices on " << socketPath << "\n";
+    int received;
+    sigwait(&signals, &received);
+    server.stop();
+    return 0;
+}
@@ -0,0 +1,570 @@
+#include<map>
+#include<mutex>
+#include<atomic>
+#include<memory>
+#include<string>
+#include<thread>
+#include<vector>
+#include<sstream>
+#include<cstring>
+#include<cerrno>
+#include<chrono>
+#include<algorithm>
+#include<exception>
+#include<stdexcept>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<sys/socket.h>
+#include<sys/un.h>
+#include"matrixdaemon.hpp"
+#include"logger.hpp"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Backlog of connections waiting to be accepted
+static const int LISTEN_BACKLOG = 16;
+// Longest wait in milliseconds before accepting again after running out of descriptors
+static const int ACCEPT_BACKOFF = 1000;
+
+// Counter making the names of segments put by clients unique
+static std::atomic<long long> clientSegments(0);
+
+namespace {
+
+/**
+ * @brief Layout at the start of every segment, followed by the row-major values
+ */
+struct SegmentHeader {
+    long long rows;
+    long long columns;
+};
+
+bool sendAll(int socket, const std::string &data) {
+    for(size_t sent = 0; sent < data.size();) {
+        ssize_t count = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if(count <= 0) return false;
+        sent += count;
+    }
+    return true;
+}
+
+/**
+ * @brief Receives into pending until it holds at least count bytes
+ */
+bool receive(int socket, std::string &pending, size_t count) {
+    char buffer[4096];
+    while(pending.size() < count) {
+        ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+        if(received <= 0) return false;
+        pending.append(buffer, received);
+    }
+    return true;
+}
+
+bool readLine(int socket, std::string &pending, std::string &line) {
+    size_t end;
+    while((end = pending.find('\n')) == std::string::npos)
+        if(!receive(socket, pending, pending.size() + 1)) return false;
+    line = pending.substr(0, end);
+    pending.erase(0, end + 1);
+    return true;
+}
+
+bool readBytes(int socket, std::string &pending, size_t count, std::string &bytes) {
+    if(!receive(socket, pending, count)) return false;
+    bytes = pending.substr(0, count);
+    pending.erase(0, count);
+    return true;
+}
+
+std::vector<std::string> split(std::string line) {
+    std::vector<std::string> tokens;
+    std::stringstream stream(line);
+    std::string token;
+    while(stream >> token) tokens.push_back(token);
+    return tokens;
+}
+
+/**
+ * @brief Creates a segment holding a row-major matrix
+ */
+bool writeSegment(std::string name, int rows, int columns, const double *values) {
+    int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(descriptor < 0) return false;
+    size_t bytes = sizeof(SegmentHeader) + (size_t) rows * columns * sizeof(double);
+    void *address = ftruncate(descriptor, bytes) == 0 ? mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0) : MAP_FAILED;
+    close(descriptor);
+    if(address == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+    SegmentHeader header = {rows, columns};
+    std::memcpy(address, &header, sizeof(header));
+    std::memcpy((char*) address + sizeof(header), values, bytes - sizeof(header));
+    munmap(address, bytes);
+    return true;
+}
+
+/**
+ * @brief Maps a segment read-only, checking its header against its size
+ */
+bool mapSegment(std::string name, void *&address, size_t &bytes, int &rows, int &columns) {
+    int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+    if(descriptor < 0) return false;
+    struct stat info;
+    void *mapped = fstat(descriptor, &info) == 0 && info.st_size >= (off_t) sizeof(SegmentHeader) ? mmap(0, info.st_size, PROT_READ, MAP_SHARED, descriptor, 0) : MAP_FAILED;
+    close(descriptor);
+    if(mapped == MAP_FAILED) return false;
+    // The header must agree with the size of the segment
+    SegmentHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    bool valid = header.rows > 0 && header.columns > 0 && sizeof(header) + header.rows * header.columns * sizeof(double) == (size_t) info.st_size;
+    if(!valid) {
+        munmap(mapped, info.st_size);
+        return false;
+    }
+    address = mapped;
+    bytes = info.st_size;
+    rows = header.rows;
+    columns = header.columns;
+    return true;
+}
+
+/**
+ * @brief Copies the row-major matrix out of a segment
+ */
+bool readSegment(std::string name, int &rows, int &columns, std::vector<double> &values) {
+    void *address;
+    size_t bytes;
+    if(!mapSegment(name, address, bytes, rows, columns)) return false;
+    const double *start = (const double*) ((char*) address + sizeof(SegmentHeader));
+    values.assign(start, start + (long long) rows * columns);
+    munmap(address, bytes);
+    return true;
+}
+
+}
+
+//////////////////////////////////////////
+//  Running the server
+//////////////////////////////////////////
+
+MatrixServer::MatrixServer(std::string socketPath) {
+    fp = socketPath;
+    listener = -1;
+    active = 0;
+    running = false;
+    segments = 0;
+    // Built in operations, whose results on resident operands are cached by version
+    registerOperation("multiply", 2, [](std::vector<Matrix> &in) { return std::vector<Matrix>{in[0] * in[1]}; });
+    registerOperation("add", 2, [](std::vector<Matrix> &in) { return std::vector<Matrix>{in[0] + in[1]}; });
+    registerOperation("subtract", 2, [](std::vector<Matrix> &in) { return std::vector<Matrix>{in[0] - in[1]}; });
+    registerOperation("inverse", 1, [](std::vector<Matrix> &in) { return std::vector<Matrix>{in[0].inverse()}; });
+    registerOperation("transpose", 1, [](std::vector<Matrix> &in) { return std::vector<Matrix>{in[0].transpose()}; });
+    registerOperation("determinant", 1, [](std::vector<Matrix> &in) {
+        std::vector<double> value(1, in[0].determinant());
+        return std::vector<Matrix>{Matrix(in[0].getFilePath(), 1, 1, value)};
+    });
+    registerOperation("lu", 1, [](std::vector<Matrix> &in) { return in[0].decomposeLU(); });
+    registerOperation("cholesky", 1, [](std::vector<Matrix> &in) { return in[0].decomposeCholesky(); });
+    registerOperation("ldlt", 1, [](std::vector<Matrix> &in) { return in[0].decomposeLDLT(); });
+    registerOperation("qr", 1, [](std::vector<Matrix> &in) { return in[0].decomposeQR(); });
+    registerOperation("eigen", 1, [](std::vector<Matrix> &in) { return in[0].eigenSymmetric(); });
+    registerOperation("solvecholesky", 2, [](std::vector<Matrix> &in) { return std::vector<Matrix>{in[0].solveCholesky(in[1])}; });
+    registerOperation("leastsquares", 2, [](std::vector<Matrix> &in) { return std::vector<Matrix>{in[0].leastSquares(in[1])}; });
+}
+
+MatrixServer::~MatrixServer() {
+    stop();
+}
+
+void MatrixServer::registerOperation(std::string name, int arity, std::function<std::vector<Matrix>(std::vector<Matrix>&)> operation) {
+    std::lock_guard<std::mutex> guard(lock);
+    arities[name] = arity;
+    functions[name] = operation;
+}
+
+void MatrixServer::start() {
+    if(running) return;
+    // Log the start of the server with its socket identifier
+    Logger::getInstance()->log("Starting a MatrixServer on the socket: " + fp);
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(fp.size() >= sizeof(address.sun_path)) Logger::logInvalidDaemon(fp, "start");
+    std::strcpy(address.sun_path, fp.c_str());
+    // Replace any socket left behind by a server that did not stop cleanly
+    unlink(fp.c_str());
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0 || bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(listener, LISTEN_BACKLOG) != 0) {
+        if(listener >= 0) close(listener);
+        listener = -1;
+        Logger::logInvalidDaemon(fp, "start");
+    }
+    running = true;
+    acceptor = std::thread([this]() {
+        int backoff = 1;
+        while(running) {
+            int connection = accept(listener, 0, 0);
+            if(connection < 0) {
+                if(!running) break;
+                // A connection dropped while queued leaves the listener usable
+                if(errno == EINTR || errno == ECONNABORTED || errno == EPROTO) continue;
+                // Running out of descriptors or memory passes once connections close
+                if(errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+                    backoff = std::min(2 * backoff, ACCEPT_BACKOFF);
+                    continue;
+                }
+                // Anything else means the listener itself is broken
+                Logger::getInstance()->log("MatrixServer stopped accepting on the socket: " + fp + " (" + std::strerror(errno) + ")");
+                break;
+            }
+            backoff = 1;
+            std::lock_guard<std::mutex> guard(lock);
+            if(!running) {
+                close(connection);
+                break;
+            }
+            connections.push_back(connection);
+            active++;
+            std::thread(&MatrixServer::serve, this, connection).detach();
+        }
+    });
+}
+
+void MatrixServer::stop() {
+    if(!running) return;
+    // Wake the acceptor, then every connection blocked on a request
+    running = false;
+    shutdown(listener, SHUT_RDWR);
+    acceptor.join();
+    close(listener);
+    listener = -1;
+    std::unique_lock<std::mutex> guard(lock);
+    for(int i = 0; i < connections.size(); i++) shutdown(connections[i], SHUT_RDWR);
+    idle.wait(guard, [this]() { return active == 0; });
+    // Resident matrices go away with the server
+    for(std::map<std::string, Resident>::iterator it = residents.begin(); it != residents.end(); it++) shm_unlink(it->second.segment.c_str());
+    residents.clear();
+    unlink(fp.c_str());
+}
+
+int MatrixServer::size() {
+    std::lock_guard<std::mutex> guard(lock);
+    return residents.size();
+}
+
+void MatrixServer::serve(int connection) {
+    std::string pending, line;
+    std::vector<std::string> published;
+    while(readLine(connection, pending, line)) {
+        // The client reads a reply before sending its next request, so the results of
+        // the last one are gone unless it died first
+        for(int i = 0; i < published.size(); i++) shm_unlink(published[i].c_str());
+        published.clear();
+        std::vector<std::string> tokens = split(line);
+        if(!sendAll(connection, handle(tokens, published))) break;
+    }
+    // Remove results a client that hung up never read
+    for(int i = 0; i < published.size(); i++) shm_unlink(published[i].c_str());
+    // Closing under the lock keeps stop() from shutting down a reused descriptor
+    std::lock_guard<std::mutex> guard(lock);
+    for(int i = 0; i < connections.size(); i++)
+        if(connections[i] == connection) connections.erase(connections.begin() + i);
+    close(connection);
+    active--;
+    idle.notify_all();
+}
+
+//////////////////////////////////////////
+//  Serving requests
+//////////////////////////////////////////
+
+std::string MatrixServer::publish(Matrix &matrix) {
+    std::string name = "/matrixd." + std::to_string(getpid()) + "." + std::to_string(++segments);
+    std::vector<double> values = matrix.flatten();
+    if(!writeSegment(name, matrix.rows(), matrix.columns(), values.data())) Logger::logInvalidDaemon(fp, "publish " + matrix.getFilePath());
+    return name;
+}
+
+MatrixServer::Resident MatrixServer::keep(std::string name, Matrix matrix) {
+    Resident resident;
+    resident.matrix = std::make_shared<Matrix>(matrix);
+    resident.segment = publish(matrix);
+    std::lock_guard<std::mutex> guard(lock);
+    if(residents.count(name)) shm_unlink(residents[name].segment.c_str());
+    residents[name] = resident;
+    return resident;
+}
+
+std::string MatrixServer::handle(std::vector<std::string> &tokens, std::vector<std::string> &published) {
+    std::string request;
+    for(int i = 0; i < tokens.size(); i++) request += (i > 0 ? " " : "") + tokens[i];
+    try {
+        std::string operation = tokens.empty() ? "" : tokens[0];
+        if(operation == "load" && tokens.size() == 3) {
+            keep(tokens[1], Matrix(tokens[2]));
+            return "OK 0\n";
+        }
+        if(operation == "put" && tokens.size() == 3) {
+            int rows, columns;
+            std::vector<double> values;
+            if(!readSegment(tokens[2], rows, columns, values)) Logger::logInvalidDaemon(fp, request);
+            keep(tokens[1], Matrix(tokens[1], rows, columns, values));
+            return "OK 0\n";
+        }
+        if(operation == "get" && tokens.size() == 2) {
+            std::lock_guard<std::mutex> guard(lock);
+            if(!residents.count(tokens[1])) Logger::logInvalidDaemon(fp, request);
+            Resident &resident = residents[tokens[1]];
+            return "OK 1\n" + resident.segment + " " + std::to_string(resident.matrix->rows()) + " " + std::to_string(resident.matrix->columns()) + "\n";
+        }
+        if(operation == "drop" && tokens.size() == 2) {
+            std::lock_guard<std::mutex> guard(lock);
+            if(!residents.count(tokens[1])) Logger::logInvalidDaemon(fp, request);
+            shm_unlink(residents[tokens[1]].segment.c_str());
+            residents.erase(tokens[1]);
+            return "OK 0\n";
+        }
+        // Anything else runs a registered operation on resident operands
+        std::function<std::vector<Matrix>(std::vector<Matrix>&)> function;
+        std::vector<std::shared_ptr<Matrix>> resident;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if(tokens.size() < 2 || !arities.count(operation) || arities[operation] != tokens.size() - 2) Logger::logInvalidDaemon(fp, request);
+            function = functions[operation];
+            for(int i = 2; i < tokens.size(); i++) {
+                if(!residents.count(tokens[i])) Logger::logInvalidDaemon(fp, request);
+                resident.push_back(residents[tokens[i]].matrix);
+            }
+        }
+        // Copies keep the version of the resident matrix, and so its cached results
+        std::vector<Matrix> operands;
+        for(int i = 0; i < resident.size(); i++) operands.push_back(*resident[i]);
+        std::vector<Matrix> results = function(operands);
+        if(tokens[1] != "-" && !results.empty()) keep(tokens[1], results[0]);
+        std::string reply = "OK " + std::to_string(results.size()) + "\n";
+        for(int i = 0; i < results.size(); i++) {
+            published.push_back(publish(results[i]));
+            reply += published.back() + " " + std::to_string(results[i].rows()) + " " + std::to_string(results[i].columns()) + "\n";
+        }
+        return reply;
+    } catch(std::exception &error) {
+        // Errors travel back to the client with their message intact
+        std::string message = error.what();
+        return "ERR " + std::to_string(message.size()) + "\n" + message;
+    }
+}
+
+//////////////////////////////////////////
+//  Viewing resident matrices
+//////////////////////////////////////////
+
+ResidentView::ResidentView(std::string name) {
+    fp = name;
+    address = NULL;
+    bytes = 0;
+    m = n = 0;
+}
+
+ResidentView::ResidentView(ResidentView &&other) noexcept {
+    fp = std::move(other.fp);
+    address = other.address;
+    bytes = other.bytes;
+    m = other.m;
+    n = other.n;
+    other.address = NULL;
+}
+
+ResidentView &ResidentView::operator=(ResidentView &&other) noexcept {
+    if(this != &other) {
+        std::swap(fp, other.fp);
+        std::swap(address, other.address);
+        std::swap(bytes, other.bytes);
+        std::swap(m, other.m);
+        std::swap(n, other.n);
+    }
+    return *this;
+}
+
+ResidentView::~ResidentView() {
+    if(address != NULL) munmap(address, bytes);
+}
+
+int ResidentView::rows() {
+    return m;
+}
+
+int ResidentView::columns() {
+    return n;
+}
+
+double ResidentView::access(int row, int column) {
+    // Check the bounds of the row and column
+    if(row < 1 || row > m) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    return data()[(long long) (row - 1) * n + column - 1];
+}
+
+const double *ResidentView::data() {
+    return (const double*) ((const char*) address + sizeof(SegmentHeader));
+}
+
+//////////////////////////////////////////
+//  Connecting as a client
+//////////////////////////////////////////
+
+MatrixClient::MatrixClient(std::string socketPath) {
+    fp = socketPath;
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(fp.size() >= sizeof(address.sun_path)) Logger::logInvalidDaemon(fp, "connect");
+    std::strcpy(address.sun_path, fp.c_str());
+    connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(connection < 0 || connect(connection, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        if(connection >= 0) close(connection);
+        Logger::logInvalidDaemon(fp, "connect");
+    }
+}
+
+MatrixClient::~MatrixClient() {
+    close(connection);
+}
+
+std::vector<std::string> MatrixClient::exchange(std::string request) {
+    std::lock_guard<std::mutex> guard(lock);
+    std::string line;
+    if(!sendAll(connection, request + "\n") || !readLine(connection, pending, line)) Logger::logInvalidDaemon(fp, request);
+    std::vector<std::string> status = split(line);
+    if(status.size() != 2) Logger::logInvalidDaemon(fp, request);
+    // Rethrow errors raised by the server
+    if(status[0] == "ERR") {
+        std::string message;
+        if(!readBytes(connection, pending, std::stoul(status[1]), message)) Logger::logInvalidDaemon(fp, request);
+        throw std::runtime_error(message);
+    }
+    // Collect the name of each result's segment
+    std::vector<std::string> segments;
+    int count = std::stoi(status[1]);
+    for(int i = 0; i < count; i++) {
+        if(!readLine(connection, pending, line)) Logger::logInvalidDaemon(fp, request);
+        std::vector<std::string> segment = split(line);
+        if(segment.size() != 3) Logger::logInvalidDaemon(fp, request);
+        segments.push_back(segment[0]);
+    }
+    return segments;
+}
+
+std::vector<Matrix> MatrixClient::call(std::string request, bool unlink) {
+    std::vector<std::string> segments = exchange(request);
+    // Copy each result out of its segment into storage of its own
+    std::vector<Matrix> results;
+    for(int i = 0; i < segments.size(); i++) {
+        int rows, columns;
+        std::vector<double> values;
+        bool read = readSegment(segments[i], rows, columns, values);
+        if(unlink) shm_unlink(segments[i].c_str());
+        if(!read) Logger::logInvalidDaemon(fp, request);
+        results.push_back(Matrix(fp, rows, columns, values));
+    }
+    return results;
+}
+
+void MatrixClient::load(std::string name, std::string filepath) {
+    call("load " + name + " " + filepath, true);
+}
+
+void MatrixClient::put(std::string name, Matrix &matrix) {
+    // Hand the values over in a segment of our own, removed once the server has copied it
+    std::string segment = "/matrixc." + std::to_string(getpid()) + "." + std::to_string(++clientSegments);
+    std::vector<double> values = matrix.flatten();
+    if(!writeSegment(segment, matrix.rows(), matrix.columns(), values.data())) Logger::logInvalidDaemon(fp, "put " + name);
+    try {
+        call("put " + name + " " + segment, true);
+    } catch(...) {
+        shm_unlink(segment.c_str());
+        throw;
+    }
+    shm_unlink(segment.c_str());
+}
+
+Matrix MatrixClient::get(std::string name) {
+    // The segment of a resident matrix is shared by every client and outlives the call
+    return call("get " + name, false)[0];
+}
+
+ResidentView MatrixClient::attach(std::string name) {
+    std::string request = "get " + name;
+    std::vector<std::string> segments = exchange(request);
+    ResidentView view(name);
+    if(segments.size() != 1 || !mapSegment(segments[0], view.address, view.bytes, view.m, view.n)) Logger::logInvalidDaemon(fp, request);
+    return view;
+}
+
+void MatrixClient::drop(std::string name) {
+    call("drop " + name, true);
+}
+
+std::vector<Matrix> MatrixClient::apply(std::string operation, std::vector<std::string> operands, std::string keep) {
+    std::string request = operation + " " + (keep.empty() ? "-" : keep);
+    for(int i = 0; i < operands.size(); i++) request += " " + operands[i];
+    return call(request, true);
+}
+
+Matrix MatrixClient::multiply(std::string a, std::string b, std::string keep) {
+    return apply("multiply", {a, b}, keep)[0];
+}
+
+Matrix MatrixClient::add(std::string a, std::string b, std::string keep) {
+    return apply("add", {a, b}, keep)[0];
+}
+
+Matrix MatrixClient::subtract(std::string a, std::string b, std::string keep) {
+    return apply("subtract", {a, b}, keep)[0];
+}
+
+Matrix MatrixClient::inverse(std::string a, std::string keep) {
+    return apply("inverse", {a}, keep)[0];
+}
+
+Matrix MatrixClient::transpose(std::string a, std::string keep) {
+    return apply("transpose", {a}, keep)[0];
+}
+
+int MatrixClient::determinant(std::string a) {
+    return apply("determinant", {a})[0].access(1, 1);
+}
+
+std::vector<Matrix> MatrixClient::decomposeLU(std::string a) {
+    return apply("lu", {a});
+}
+
+std::vector<Matrix> MatrixClient::decomposeCholesky(std::string a) {
+    return apply("cholesky", {a});
+}
+
+std::vector<Matrix> MatrixClient::decomposeLDLT(std::string a) {
+    return apply("ldlt", {a});
+}
+
+std::vector<Matrix> MatrixClient::decomposeQR(std::string a) {
+    return apply("qr", {a});
+}
+
+std::vector<Matrix> MatrixClient::eigenSymmetric(std::string a) {
+    return apply("eigen", {a});
+}
+
+Matrix MatrixClient::solveCholesky(std::string a, std::string b, std::string keep) {
+    return apply("solvecholesky", {a, b}, keep)[0];
+}
+
+Matrix MatrixClient::leastSquares(std::string a, std::string b, std::string keep) {
+    return apply("leastsquares", {a, b}, keep)[0];
+}
@@ -0,0 +1,364 @@
+#include<map>
+#include<mutex>
+#include<atomic>
+#include<memory>
+#include<string>
+#include<thread>
+#include<vector>
+#include<functional>
+#include<condition_variable>
+#include"matrix.hpp"
+#ifndef MATRIXDAEMON_HPP
+#define MATRIXDAEMON_HPP
+
+/**
+ * @brief A local server keeping named matrices resident for every process on
+ * the machine. Requests arrive over a Unix domain socket, one line each, and
+ * results leave through POSIX shared memory segments so only their names pass
+ * through the socket. Resident matrices keep their version while loaded, so
+ * factorizations of them are cached once for every client
+ *
+ * Requests are whitespace separated tokens, so names and filepaths may not
+ * contain whitespace:
+ *   load name filepath       loads an mtx file as a resident matrix
+ *   put name segment         copies a client's segment into a resident matrix
+ *   get name                 returns the segment published for a resident matrix
+ *   drop name                forgets a resident matrix
+ *   operation keep names...  runs an operation, keeping its first result
+ *                            resident as keep unless keep is -
+ * Replies are OK count followed by a line of segment rows columns per result,
+ * or ERR length followed by that many bytes of error message
+ *
+ */
+class MatrixServer {
+    private:
+    /**
+     * @brief A resident matrix with the segment published for it
+     *
+     */
+    struct Resident {
+        std::shared_ptr<Matrix> matrix;
+        std::string segment;
+    };
+
+    /** Filepath of the socket */
+    std::string fp;
+    /** Resident matrices by name */
+    std::map<std::string, Resident> residents;
+    /** Number of operands each known operation takes */
+    std::map<std::string, int> arities;
+    /** Function computing each known operation */
+    std::map<std::string, std::function<std::vector<Matrix>(std::vector<Matrix>&)>> functions;
+    /** Guards residents, the operations and the connections */
+    std::mutex lock;
+    /** Listening socket, -1 while stopped */
+    int listener;
+    /** Thread accepting connections */
+    std::thread acceptor;
+    /** Sockets of open connections */
+    std::vector<int> connections;
+    /** Threads still serving a connection */
+    int active;
+    /** Signalled when a connection closes */
+    std::condition_variable idle;
+    /** Whether the server is accepting connections */
+    std::atomic<bool> running;
+    /** Counter making segment names unique */
+    std::atomic<long long> segments;
+
+    /**
+     * @brief Serves requests on one connection until the client hangs up or the
+     * server stops, then closes it and removes any result segments left unread
+     *
+     * @param connection connected socket
+     */
+    void serve(int connection);
+
+    /**
+     * @brief Runs one request
+     *
+     * @param tokens the request split on whitespace
+     * @param published receives the segments published for the results, which the
+     * connection removes if its client never does
+     * @return std::string the reply
+     */
+    std::string handle(std::vector<std::string> &tokens, std::vector<std::string> &published);
+
+    /**
+     * @brief Makes a matrix resident under a name, publishing its segment and
+     * dropping any matrix the name held before
+     *
+     * @param name name of the matrix
+     * @param matrix the matrix
+     * @return Resident the resident matrix
+     */
+    Resident keep(std::string name, Matrix matrix);
+
+    /**
+     * @brief Copies a matrix into a new shared memory segment
+     *
+     * @param matrix the matrix
+     * @return std::string name of the segment
+     */
+    std::string publish(Matrix &matrix);
+
+    public:
+    /**
+     * @brief Creates a stopped server, registering the built in operations multiply,
+     * add, subtract, inverse, transpose, determinant, lu, cholesky, ldlt, qr,
+     * eigen, solvecholesky and leastsquares
+     *
+     * @param socketPath filepath the socket will listen on
+     */
+    MatrixServer(std::string socketPath);
+
+    /**
+     * @brief Stops the server if it is running
+     *
+     */
+    ~MatrixServer();
+
+    /**
+     * @brief Registers an operation requests may name, replacing any with the same name
+     *
+     * @param name name used in requests
+     * @param arity number of resident operands the operation takes
+     * @param operation function computing the results from the operands
+     */
+    void registerOperation(std::string name, int arity, std::function<std::vector<Matrix>(std::vector<Matrix>&)> operation);
+
+    /**
+     * @brief Listens on the socket, serving each connection on its own thread
+     *
+     */
+    void start();
+
+    /**
+     * @brief Closes every connection, waits for their requests to finish and
+     * removes the socket and the segments of resident matrices
+     *
+     */
+    void stop();
+
+    /**
+     * @brief Returns the number of resident matrices
+     *
+     * @return int number of resident matrices
+     */
+    int size();
+};
+
+/**
+ * @brief A read-only view of a resident matrix, mapping the shared memory segment
+ * the server published for it. Every client attached to the same matrix reads
+ * the same pages, so attaching costs a round trip and a mapping whatever the
+ * size of the matrix. The values stay valid while the view lives, even after
+ * the server drops or replaces the matrix, since the server never writes to a
+ * published segment
+ *
+ */
+class ResidentView {
+    friend class MatrixClient;
+
+    private:
+    /** Name of the resident matrix, used for logging */
+    std::string fp;
+    /** Start and length of the mapping, the header followed by the row-major values */
+    void *address;
+    size_t bytes;
+    /** Number of rows and columns */
+    int m, n;
+
+    /**
+     * @brief Creates a view mapping nothing yet
+     *
+     * @param name name of the resident matrix
+     */
+    ResidentView(std::string name);
+
+    public:
+    ResidentView(ResidentView &&other) noexcept;
+    ResidentView &operator=(ResidentView &&other) noexcept;
+    ResidentView(const ResidentView &other) = delete;
+    ResidentView &operator=(const ResidentView &other) = delete;
+
+    /**
+     * @brief Unmaps the segment
+     *
+     */
+    ~ResidentView();
+
+    /**
+     * @brief Returns the number of rows
+     *
+     * @return int number of rows
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of columns
+     *
+     * @return int number of columns
+     */
+    int columns();
+
+    /**
+     * @brief Returns a value of the matrix, 1-indexed like Matrix::access
+     *
+     * @param row row of the value
+     * @param column column of the value
+     * @return double the value
+     */
+    double access(int row, int column);
+
+    /**
+     * @brief Returns the row-major values in the shared pages
+     *
+     * @return const double* the first value
+     */
+    const double *data();
+};
+
+/**
+ * @brief A connection to a MatrixServer whose methods mirror those of Matrix,
+ * naming resident matrices instead of holding them. Results are read from the
+ * shared memory segments the server replies with, and errors raised by the
+ * server are thrown again with the same message. Methods returning a Matrix copy
+ * the values out of the segment, since a Matrix owns rows it may write to and
+ * cannot be built over shared read-only pages. attach shares the server's copy
+ * of a resident matrix without copying it
+ *
+ */
+class MatrixClient {
+    private:
+    /** Filepath of the socket, used for logging */
+    std::string fp;
+    /** Connected socket */
+    int connection;
+    /** Reply bytes received but not yet parsed */
+    std::string pending;
+    /** Keeps requests and replies of different threads apart */
+    std::mutex lock;
+
+    /**
+     * @brief Sends a request and reads the matrices of the reply
+     *
+     * @param request the request line
+     * @param unlink whether the segments are single use and removed once read
+     * @return std::vector<Matrix> the results
+     */
+    std::vector<Matrix> call(std::string request, bool unlink);
+
+    /**
+     * @brief Sends a request and reads the names of the reply's segments
+     *
+     * @param request the request line
+     * @return std::vector<std::string> name of the segment of each result
+     */
+    std::vector<std::string> exchange(std::string request);
+
+    public:
+    /**
+     * @brief Connects to a running server
+     *
+     * @param socketPath filepath the server listens on
+     */
+    MatrixClient(std::string socketPath);
+
+    /**
+     * @brief Closes the connection
+     *
+     */
+    ~MatrixClient();
+
+    /**
+     * @brief Has the server load an mtx file as a resident matrix
+     *
+     * @param name name of the resident matrix
+     * @param filepath filepath to the mtx file, as seen by the server
+     */
+    void load(std::string name, std::string filepath);
+
+    /**
+     * @brief Makes a copy of a matrix resident on the server
+     *
+     * @param name name of the resident matrix
+     * @param matrix the matrix
+     */
+    void put(std::string name, Matrix &matrix);
+
+    /**
+     * @brief Returns a copy of a resident matrix
+     *
+     * @param name name of the resident matrix
+     * @return Matrix the matrix
+     */
+    Matrix get(std::string name);
+
+    /**
+     * @brief Maps a resident matrix read-only without copying it, sharing the
+     * pages every other client attached to it reads
+     *
+     * @param name name of the resident matrix
+     * @return ResidentView view of the matrix
+     */
+    ResidentView attach(std::string name);
+
+    /**
+     * @brief Has the server forget a resident matrix
+     *
+     * @param name name of the resident matrix
+     */
+    void drop(std::string name);
+
+    /**
+     * @brief Runs any registered operation on resident matrices
+     *
+     * @param operation name of the operation
+     * @param operands names of the resident operands
+     * @param keep name to keep the first result resident as, empty to not keep it
+     * @return std::vector<Matrix> the results
+     */
+    std::vector<Matrix> apply(std::string operation, std::vector<std::string> operands, std::string keep = "");
+
+    /** @brief See Matrix::operator* */
+    Matrix multiply(std::string a, std::string b, std::string keep = "");
+
+    /** @brief See Matrix::operator+ */
+    Matrix add(std::string a, std::string b, std::string keep = "");
+
+    /** @brief See Matrix::operator- */
+    Matrix subtract(std::string a, std::string b, std::string keep = "");
+
+    /** @brief See Matrix::inverse */
+    Matrix inverse(std::string a, std::string keep = "");
+
+    /** @brief See Matrix::transpose */
+    Matrix transpose(std::string a, std::string keep = "");
+
+    /** @brief See Matrix::determinant */
+    int determinant(std::string a);
+
+    /** @brief See Matrix::decomposeLU */
+    std::vector<Matrix> decomposeLU(std::string a);
+
+    /** @brief See Matrix::decomposeCholesky */
+    std::vector<Matrix> decomposeCholesky(std::string a);
+
+    /** @brief See Matrix::decomposeLDLT */
+    std::vector<Matrix> decomposeLDLT(std::string a);
+
+    /** @brief See Matrix::decomposeQR */
+    std::vector<Matrix> decomposeQR(std::string a);
+
+    /** @brief See Matrix::eigenSymmetric */
+    std::vector<Matrix> eigenSymmetric(std::string a);
+
+    /** @brief See Matrix::solveCholesky */
+    Matrix solveCholesky(std::string a, std::string b, std::string keep = "");
+
+    /** @brief See Matrix::leastSquares */
+    Matrix leastSquares(std::string a, std::string b, std::string keep = "");
+};
+
+#endif
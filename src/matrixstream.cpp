@@ -0,0 +1,95 @@
+#include<string>
+#include<vector>
+#include<algorithm>
+#include"matrixstream.hpp"
+#include"iohandler.hpp"
+
+//////////////////////////////////////////
+//  Streams over matrices in memory
+//////////////////////////////////////////
+
+MemoryMatrixStream::MemoryMatrixStream(std::string filepath, int rows, int columns, const double *values) {
+    fp = filepath;
+    m = rows;
+    n = columns;
+    data = values;
+    position = 0;
+}
+
+int MemoryMatrixStream::rows() {
+    return m;
+}
+
+int MemoryMatrixStream::columns() {
+    return n;
+}
+
+std::string MemoryMatrixStream::getFilePath() {
+    return fp;
+}
+
+void MemoryMatrixStream::rewind() {
+    position = 0;
+}
+
+int MemoryMatrixStream::read(int count, double *block) {
+    // Copy as many of the remaining rows as fit
+    int available = std::min(count, m - position);
+    std::copy(data + (long long) position * n, data + (long long) (position + available) * n, block);
+    position += available;
+    return available;
+}
+
+//////////////////////////////////////////
+//  Streams over mtx files
+//////////////////////////////////////////
+
+FileMatrixStream::FileMatrixStream(std::string filepath) {
+    // Log the creation of the stream with its filepath identifier
+    Logger::getInstance()->log("Creating a FileMatrixStream from the filepath: " + filepath);
+    fp = filepath;
+    // Check for the proper file type and read the dimensions
+    if(!endsWith(fp, ".mtx")) Logger::logInvalidInput(fp);
+    file.open(fp);
+    std::string line;
+    if(!std::getline(file, line)) Logger::logInvalidInput(fp);
+    readHeader(line, fp, m, n);
+    position = 0;
+}
+
+int FileMatrixStream::rows() {
+    return m;
+}
+
+int FileMatrixStream::columns() {
+    return n;
+}
+
+std::string FileMatrixStream::getFilePath() {
+    return fp;
+}
+
+void FileMatrixStream::rewind() {
+    // Reopen the file and skip the header
+    file.close();
+    file.clear();
+    file.open(fp);
+    std::string line;
+    std::getline(file, line);
+    position = 0;
+}
+
+int FileMatrixStream::read(int count, double *block) {
+    int available = std::min(count, m - position);
+    std::string line;
+    std::vector<std::vector<double>> row;
+    for(int i = 0; i < available; i++) {
+        // The header promised more rows than the file holds
+        if(!std::getline(file, line)) Logger::logInvalidInput(fp);
+        row.clear();
+        readRow(line, row, fp, n);
+        std::copy(row[0].begin(), row[0].end(), block + (long long) i * n);
+    }
+    position += available;
+    return available;
+}
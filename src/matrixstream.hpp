@@ -0,0 +1,122 @@
+#include<string>
+#include<vector>
+#include<fstream>
+#ifndef MATRIXSTREAM_HPP
+#define MATRIXSTREAM_HPP
+
+/**
+ * @brief An interface for reading a matrix as consecutive blocks of rows, so
+ * algorithms that only need a fixed number of passes over their input never
+ * have to hold it in memory
+ *
+ */
+class MatrixStream {
+    public:
+    virtual ~MatrixStream() {}
+
+    /**
+     * @brief Returns the number of rows in the streamed matrix
+     *
+     * @return int number of rows
+     */
+    virtual int rows() = 0;
+
+    /**
+     * @brief Returns the number of columns in the streamed matrix
+     *
+     * @return int number of columns
+     */
+    virtual int columns() = 0;
+
+    /**
+     * @brief Returns the identifier used for logging
+     *
+     * @return std::string identifier of the streamed matrix
+     */
+    virtual std::string getFilePath() = 0;
+
+    /**
+     * @brief Starts a new pass from the first row
+     *
+     */
+    virtual void rewind() = 0;
+
+    /**
+     * @brief Reads the next rows of the current pass
+     *
+     * @param count largest number of rows to read
+     * @param block pointer to a row-major buffer of count x columns() values
+     * @return int number of rows read, zero once the pass is over
+     */
+    virtual int read(int count, double *block) = 0;
+};
+
+/**
+ * @brief A stream over a row-major matrix already held in memory
+ *
+ */
+class MemoryMatrixStream : public MatrixStream {
+    private:
+    /** Identifier used for logging */
+    std::string fp;
+    /** Number of rows */
+    int m;
+    /** Number of columns */
+    int n;
+    /** Row-major values, owned by the caller */
+    const double *data;
+    /** Next row of the current pass */
+    int position;
+
+    public:
+    /**
+     * @brief Constructs a stream over the values of a matrix
+     *
+     * @param filepath identifier used for logging
+     * @param rows number of rows
+     * @param columns number of columns
+     * @param values pointer to the row-major values, which must outlive the stream
+     */
+    MemoryMatrixStream(std::string filepath, int rows, int columns, const double *values);
+
+    int rows();
+    int columns();
+    std::string getFilePath();
+    void rewind();
+    int read(int count, double *block);
+};
+
+/**
+ * @brief A stream reading an mtx file one row at a time, holding only the rows
+ * of the block being read
+ *
+ */
+class FileMatrixStream : public MatrixStream {
+    private:
+    /** Filepath of the mtx file */
+    std::string fp;
+    /** Number of rows from the header */
+    int m;
+    /** Number of columns from the header */
+    int n;
+    /** Next row of the current pass */
+    int position;
+    /** Open file positioned after the last row read */
+    std::ifstream file;
+
+    public:
+    /**
+     * @brief Opens an mtx file and reads its header
+     *
+     * @param filepath filepath to the mtx file
+     */
+    FileMatrixStream(std::string filepath);
+
+    int rows();
+    int columns();
+    std::string getFilePath();
+    void rewind();
+    int read(int count, double *block);
+};
+
+#endif
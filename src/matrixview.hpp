@@ -0,0 +1,135 @@
+#include<vector>
+#include<cstddef>
+#include<iterator>
+#ifndef MATRIXVIEW_HPP
+#define MATRIXVIEW_HPP
+
+/**
+ * @brief Whether the unchecked accessors of Matrix check their indices anyway.
+ * Defaults to checking unless NDEBUG is defined, and can be set explicitly with
+ * -DMATRIX_BOUNDS_CHECK=0 or -DMATRIX_BOUNDS_CHECK=1
+ */
+#ifndef MATRIX_BOUNDS_CHECK
+#ifdef NDEBUG
+#define MATRIX_BOUNDS_CHECK 0
+#else
+#define MATRIX_BOUNDS_CHECK 1
+#endif
+#endif
+
+/**
+ * @brief A read-only view of consecutive values of a matrix, such as one row.
+ * Indexed from 0 like the standard containers, and valid until the matrix it
+ * views is written to or destroyed
+ *
+ */
+class MatrixSpan {
+    private:
+    /** First value of the view */
+    const double *first;
+    /** Number of values in the view */
+    int count;
+
+    public:
+    MatrixSpan(const double *data, int size) : first(data), count(size) {}
+
+    const double *data() const { return first; }
+    int size() const { return count; }
+    const double &operator[](int index) const { return first[index]; }
+    const double *begin() const { return first; }
+    const double *end() const { return first + count; }
+};
+
+/**
+ * @brief Walks the values of a matrix row by row. Valid until the matrix it
+ * walks is written to or destroyed
+ *
+ */
+class MatrixIterator {
+    private:
+    /** Rows of the matrix */
+    const std::vector<double> *rows;
+    /** Position of the iterator */
+    int row, column;
+    /** Number of columns of the matrix */
+    int n;
+
+    public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef double value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const double *pointer;
+    typedef const double &reference;
+
+    MatrixIterator() : rows(NULL), row(0), column(0), n(0) {}
+    MatrixIterator(const std::vector<double> *values, int startRow, int columns) : rows(values), row(startRow), column(0), n(columns) {}
+
+    reference operator*() const { return rows[row][column]; }
+    pointer operator->() const { return &rows[row][column]; }
+
+    MatrixIterator &operator++() {
+        if(++column == n) {
+            column = 0;
+            row++;
+        }
+        return *this;
+    }
+
+    MatrixIterator operator++(int) {
+        MatrixIterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool operator==(const MatrixIterator &other) const { return row == other.row && column == other.column && rows == other.rows; }
+    bool operator!=(const MatrixIterator &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Walks down one column of a matrix. Valid until the matrix it walks is
+ * written to or destroyed
+ *
+ */
+class ColumnIterator {
+    private:
+    /** Rows of the matrix */
+    const std::vector<double> *rows;
+    /** Row the iterator is at */
+    std::ptrdiff_t row;
+    /** Column the iterator walks, indexed from 0 */
+    int column;
+
+    public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef double value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const double *pointer;
+    typedef const double &reference;
+
+    ColumnIterator() : rows(NULL), row(0), column(0) {}
+    ColumnIterator(const std::vector<double> *values, std::ptrdiff_t startRow, int index) : rows(values), row(startRow), column(index) {}
+
+    reference operator*() const { return rows[row][column]; }
+    pointer operator->() const { return &rows[row][column]; }
+    reference operator[](difference_type offset) const { return rows[row + offset][column]; }
+
+    ColumnIterator &operator++() { row++; return *this; }
+    ColumnIterator &operator--() { row--; return *this; }
+    ColumnIterator operator++(int) { ColumnIterator previous = *this; row++; return previous; }
+    ColumnIterator operator--(int) { ColumnIterator previous = *this; row--; return previous; }
+    ColumnIterator &operator+=(difference_type offset) { row += offset; return *this; }
+    ColumnIterator &operator-=(difference_type offset) { row -= offset; return *this; }
+    ColumnIterator operator+(difference_type offset) const { return ColumnIterator(rows, row + offset, column); }
+    ColumnIterator operator-(difference_type offset) const { return ColumnIterator(rows, row - offset, column); }
+    friend ColumnIterator operator+(difference_type offset, const ColumnIterator &iterator) { return iterator + offset; }
+    difference_type operator-(const ColumnIterator &other) const { return row - other.row; }
+
+    bool operator==(const ColumnIterator &other) const { return row == other.row && column == other.column && rows == other.rows; }
+    bool operator!=(const ColumnIterator &other) const { return !(*this == other); }
+    bool operator<(const ColumnIterator &other) const { return row < other.row; }
+    bool operator>(const ColumnIterator &other) const { return row > other.row; }
+    bool operator<=(const ColumnIterator &other) const { return row <= other.row; }
+    bool operator>=(const ColumnIterator &other) const { return row >= other.row; }
+};
+
+#endif
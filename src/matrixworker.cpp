@@ -0,0 +1,12 @@
+#include"distributed.hpp"
+
+/**
+ * @brief Runs one rank of a distributed operation, started by SocketTransport::launch
+ *
+ * @param argc number of arguments
+ * @param argv the rank, the group size, a socket per rank and the operation
+ * @return int exit code
+ */
+int main(int argc, char **argv) {
+    return DistributedMatrix::work(argc, argv);
+}
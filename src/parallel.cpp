@@ -0,0 +1,269 @@
+#include<mutex>
+#include<chrono>
+#include<algorithm>
+#include<deque>
+#include<atomic>
+#include<thread>
+#include<vector>
+#include<exception>
+#include<condition_variable>
+#include"parallel.hpp"
+#include"topology.hpp"
+
+// Number of threads kernels may use, 0 means use the hardware concurrency
+static std::atomic<int> threadCount(0);
+// Most worker threads the pool will ever start
+static const int MAX_WORKERS = 255;
+// Whether workers are pinned, and how many times that has been changed
+static std::atomic<bool> pinning(false);
+static std::atomic<int> pinningChanges(0);
+
+void setThreadCount(int threads) {
+    // Store the requested count, anything below 1 falls back to the hardware
+    threadCount = threads < 1 ? 0 : threads;
+}
+
+int getThreadCount() {
+    // Use the explicit count if one was set
+    if(threadCount > 0) return threadCount;
+    // Otherwise ask the hardware, which may report 0 when unknown
+    int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+void setThreadPinning(bool pinned) {
+    pinning = pinned;
+    pinningChanges++;
+}
+
+bool getThreadPinning() {
+    return pinning;
+}
+
+//////////////////////////////////////////
+//  Work-stealing scheduler
+//////////////////////////////////////////
+
+namespace {
+
+/**
+ * @brief Tasks queued by one thread. The owner pushes and pops at the back so it
+ * works on what it queued most recently, thieves take from the front
+ */
+struct TaskQueue {
+    std::mutex lock;
+    std::deque<std::function<void()>> tasks;
+};
+
+/**
+ * @brief A pool of worker threads, each with its own queue, plus one shared queue
+ * for threads outside the pool. A thread out of work steals from the other
+ * queues, and a thread waiting on tasks runs queued tasks instead of blocking,
+ * so nested parallel regions reuse the same threads rather than starting more
+ */
+class Scheduler {
+    public:
+    Scheduler() : started(0), queued(0), stopping(false) {}
+
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(int t = 0; t < workers.size(); t++) workers[t].join();
+    }
+
+    /**
+     * @brief Starts workers until there is one per thread beyond the caller's
+     */
+    void grow() {
+        int wanted = std::min(getThreadCount() - 1, MAX_WORKERS);
+        if(started.load() >= wanted) return;
+        std::lock_guard<std::mutex> guard(growLock);
+        while(started.load() < wanted) {
+            int index = started.load() + 1;
+            workers.push_back(std::thread(&Scheduler::work, this, index));
+            started.store(index);
+        }
+    }
+
+    /**
+     * @brief Queues a task on the given worker's queue, or by default on the
+     * calling worker's queue or the shared queue
+     */
+    void push(std::function<void()> task, int target = -1) {
+        grow();
+        if(target < 0 || target > started.load()) target = current < 0 ? 0 : current;
+        TaskQueue &queue = queues[target];
+        {
+            std::lock_guard<std::mutex> guard(queue.lock);
+            queue.tasks.push_back(std::move(task));
+        }
+        queued++;
+        // Take the sleep lock so a worker checking for work cannot miss the wakeup
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+        }
+        // A task meant for one worker must reach it rather than whichever worker wakes first
+        if(target == (current < 0 ? 0 : current)) wake.notify_one();
+        else wake.notify_all();
+    }
+
+    /**
+     * @brief Takes a task from the caller's own queue, or steals one from another
+     */
+    bool take(std::function<void()> &task) {
+        if(queued.load() == 0) return false;
+        int own = current < 0 ? 0 : current;
+        {
+            std::lock_guard<std::mutex> guard(queues[own].lock);
+            if(!queues[own].tasks.empty()) {
+                task = std::move(queues[own].tasks.back());
+                queues[own].tasks.pop_back();
+                queued--;
+                return true;
+            }
+        }
+        int count = started.load() + 1;
+        for(int offset = 1; offset < count; offset++) {
+            TaskQueue &victim = queues[(own + offset) % count];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if(!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Runs queued tasks on the calling thread until pending returns false
+     */
+    void help(std::function<bool()> &pending) {
+        std::function<void()> task;
+        while(pending()) {
+            if(take(task)) task();
+            else std::this_thread::yield();
+        }
+    }
+
+    private:
+    /** Index of the calling thread's queue, -1 outside the pool */
+    static thread_local int current;
+    /** Queue 0 is shared by outside threads, queue i belongs to worker i */
+    TaskQueue queues[MAX_WORKERS + 1];
+    std::vector<std::thread> workers;
+    std::atomic<int> started;
+    std::atomic<int> queued;
+    std::mutex growLock;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    bool stopping;
+
+    /**
+     * @brief Ties a worker to its core, walking the cores node by node, or frees it
+     */
+    void pin(int index) {
+        if(!pinning) {
+            unpinThread();
+            return;
+        }
+        std::vector<NumaNode> nodes = getTopology();
+        std::vector<int> cores;
+        for(int i = 0; i < nodes.size(); i++) cores.insert(cores.end(), nodes[i].cpus.begin(), nodes[i].cpus.end());
+        pinThread(cores[index % cores.size()]);
+    }
+
+    /**
+     * @brief Worker loop, sleeping whenever there is nothing to run. Workers beyond
+     * the current thread count stay asleep so lowering it takes effect
+     */
+    void work(int index) {
+        current = index;
+        std::function<void()> task;
+        int pinned = 0;
+        while(true) {
+            if(pinned != pinningChanges.load()) {
+                pinned = pinningChanges.load();
+                pin(index);
+            }
+            if(index < getThreadCount() && take(task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(sleepLock);
+            if(stopping) return;
+            wake.wait_for(guard, std::chrono::milliseconds(10), [this, index]() {
+                return stopping || (queued.load() > 0 && index < getThreadCount());
+            });
+            if(stopping) return;
+        }
+    }
+};
+
+thread_local int Scheduler::current = -1;
+
+Scheduler &scheduler() {
+    static Scheduler instance;
+    return instance;
+}
+
+}
+
+void spawn(std::function<void()> task) {
+    scheduler().push(std::move(task));
+}
+
+/**
+ * @brief Queues a task on one worker's queue, where it runs unless another thread runs dry first
+ */
+static void spawnOn(int worker, std::function<void()> task) {
+    scheduler().push(std::move(task), worker);
+}
+
+void helpWhile(std::function<bool()> pending) {
+    scheduler().help(pending);
+}
+
+void parallelFor(int begin, int end, int grain, std::function<void(int, int)> body) {
+    // Nothing to do for an empty range
+    if(end <= begin) return;
+    if(grain < 1) grain = 1;
+    // Split the range into as many chunks as threads allow without going below grain
+    int total = end - begin;
+    int chunks = (total + grain - 1) / grain;
+    if(chunks > getThreadCount()) chunks = getThreadCount();
+    // Small ranges are run inline to avoid scheduling cost
+    if(chunks <= 1) {
+        body(begin, end);
+        return;
+    }
+    // Queue every chunk but the first on its own worker, recording any exception thrown
+    std::vector<std::exception_ptr> errors(chunks);
+    std::atomic<int> remaining(chunks - 1);
+    for(int c = 1; c < chunks; c++) {
+        int lo = begin + (long long) total * c / chunks;
+        int hi = begin + (long long) total * (c + 1) / chunks;
+        spawnOn(c, [&body, &errors, &remaining, c, lo, hi]() {
+            try {
+                body(lo, hi);
+            } catch(...) {
+                errors[c] = std::current_exception();
+            }
+            remaining--;
+        });
+    }
+    // Run the first chunk on the calling thread
+    try {
+        body(begin, begin + total / chunks);
+    } catch(...) {
+        errors[0] = std::current_exception();
+    }
+    // Help with queued work until the other chunks finish, then rethrow the first failure
+    helpWhile([&remaining]() { return remaining.load() > 0; });
+    for(int c = 0; c < chunks; c++)
+        if(errors[c]) std::rethrow_exception(errors[c]);
+}
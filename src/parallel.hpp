@@ -0,0 +1,71 @@
+#include<functional>
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+/**
+ * @brief Sets the number of threads parallel kernels are allowed to use
+ *
+ * @param threads number of threads to use, values below 1 reset to the hardware concurrency
+ */
+void setThreadCount(int threads);
+
+/**
+ * @brief Returns the number of threads parallel kernels are allowed to use
+ *
+ * @return int number of threads
+ */
+int getThreadCount();
+
+/**
+ * @brief Turns pinning of the pool's workers to cores on or off. Pinned workers
+ * are tied to one core each, filling the cores of one NUMA node before moving on
+ * to the next, so neighbouring chunks of a parallelFor share a node. Workers
+ * already running pick up the change when they next look for work
+ *
+ * @param pinned whether workers should be pinned, off by default
+ */
+void setThreadPinning(bool pinned);
+
+/**
+ * @brief Returns whether the pool's workers are pinned to cores
+ *
+ * @return bool true if workers are pinned
+ */
+bool getThreadPinning();
+
+/**
+ * @brief Queues a task on the shared work-stealing thread pool. The pool starts
+ * one worker per thread beyond the caller's on first use, and workers steal from
+ * each other's queues when their own runs dry
+ *
+ * @param task function to run, which must not let exceptions escape
+ */
+void spawn(std::function<void()> task);
+
+/**
+ * @brief Runs queued tasks on the calling thread for as long as pending returns
+ * true, so a thread waiting on other tasks keeps its core busy instead of
+ * blocking or starting more threads
+ *
+ * @param pending function returning whether the caller still has to wait
+ */
+void helpWhile(std::function<bool()> pending);
+
+/**
+ * @brief Splits the range [begin, end) into contiguous chunks of at least grain
+ * iterations and runs the body on each chunk, possibly concurrently. Chunks are
+ * queued on the shared pool and the caller helps run them, so nested calls from
+ * inside a chunk or an asynchronous task never oversubscribe the machine. Chunk c
+ * is queued on worker c, so every loop over the same range hands each worker the
+ * same rows, keeping them in its cache and on its node when the rows were first
+ * written by that worker. Returns once every chunk has finished and rethrows the
+ * first exception raised by a chunk
+ *
+ * @param begin first index of the range
+ * @param end one past the last index of the range
+ * @param grain minimum number of iterations worth handing to a thread
+ * @param body function called with the [begin, end) bounds of each chunk
+ */
+void parallelFor(int begin, int end, int grain, std::function<void(int, int)> body);
+
+#endif
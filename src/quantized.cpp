@@ -0,0 +1,234 @@
+#include<cmath>
+#include<vector>
+#include<cstdint>
+#include<algorithm>
+#include"quantized.hpp"
+#include"parallel.hpp"
+#include"topology.hpp"
+#if defined(__AVX2__)
+#include<immintrin.h>
+#elif defined(__SSE2__)
+#include<emmintrin.h>
+#endif
+
+// Fewest values worth handing to another thread
+static const int PARALLEL_VALUES = 1 << 15;
+// int8 values summed in 32 bits before widening, far below the count that could overflow them
+static const int INT8_SPAN = 1 << 16;
+// Bytes of the right operand's columns kept in cache while the rows of the left pass over them
+static const int TILE_BYTES = 1 << 18;
+
+//////////////////////////////////////////
+//  Integer dot products
+//////////////////////////////////////////
+
+/**
+ * @brief Sums the products of count int8 values, sign extending them to int16 so
+ * each pair of products is one multiply-add into a 32-bit lane
+ */
+static long long dot(const std::int8_t *a, const std::int8_t *b, int count) {
+    long long total = 0;
+    for(int start = 0; start < count; start += INT8_SPAN) {
+        int end = std::min(count, start + INT8_SPAN);
+        int p = start;
+        std::int32_t sum = 0;
+#if defined(__AVX2__)
+        __m256i acc = _mm256_setzero_si256();
+        for(; p + 16 <= end; p += 16) {
+            __m256i x = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a + p)));
+            __m256i y = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (b + p)));
+#if defined(__AVXVNNI__)
+            acc = _mm256_dpwssd_avx_epi32(acc, x, y);
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+            acc = _mm256_dpwssd_epi32(acc, x, y);
+#else
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, y));
+#endif
+        }
+        std::int32_t lanes[8];
+        _mm256_storeu_si256((__m256i*) lanes, acc);
+        for(int l = 0; l < 8; l++) sum += lanes[l];
+#elif defined(__SSE2__)
+        __m128i acc = _mm_setzero_si128(), zero = _mm_setzero_si128();
+        for(; p + 16 <= end; p += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*) (a + p));
+            __m128i y = _mm_loadu_si128((const __m128i*) (b + p));
+            // Interleaving with the sign bytes sign extends each half to int16
+            __m128i xs = _mm_cmpgt_epi8(zero, x), ys = _mm_cmpgt_epi8(zero, y);
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(x, xs), _mm_unpacklo_epi8(y, ys)));
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(x, xs), _mm_unpackhi_epi8(y, ys)));
+        }
+        std::int32_t lanes[4];
+        _mm_storeu_si128((__m128i*) lanes, acc);
+        for(int l = 0; l < 4; l++) sum += lanes[l];
+#endif
+        for(; p < end; p++) sum += (std::int32_t) a[p] * b[p];
+        total += sum;
+    }
+    return total;
+}
+
+/**
+ * @brief Sums the products of count int16 values. Each multiply-add of a pair
+ * fits 32 bits but the next could overflow them, so the pairs are widened to
+ * 64 bits before they are added
+ */
+static long long dot(const std::int16_t *a, const std::int16_t *b, int count) {
+    long long total = 0;
+    int p = 0;
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for(; p + 16 <= count; p += 16) {
+        __m256i pairs = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*) (a + p)), _mm256_loadu_si256((const __m256i*) (b + p)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+    }
+    long long lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, acc);
+    for(int l = 0; l < 4; l++) total += lanes[l];
+#elif defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for(; p + 8 <= count; p += 8) {
+        __m128i pairs = _mm_madd_epi16(_mm_loadu_si128((const __m128i*) (a + p)), _mm_loadu_si128((const __m128i*) (b + p)));
+        // Interleaving with the sign of each lane sign extends it to 64 bits
+        __m128i sign = _mm_srai_epi32(pairs, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pairs, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pairs, sign));
+    }
+    long long lanes[2];
+    _mm_storeu_si128((__m128i*) lanes, acc);
+    total += lanes[0] + lanes[1];
+#endif
+    for(; p < count; p++) total += (std::int32_t) a[p] * b[p];
+    return total;
+}
+
+//////////////////////////////////////////
+//  Quantizing and dequantizing
+//////////////////////////////////////////
+
+/**
+ * @brief Rounds each of the lines of a matrix to integers of its own scale, reading
+ * value q of line l through at(l, q). Returns the squared rounding error of each line
+ */
+template<typename T, typename F>
+static std::vector<double> quantize(int lines, int length, int largest, F at, std::vector<T> &values, std::vector<double> &scales) {
+    values.resize((long long) lines * length);
+    scales.resize(lines);
+    std::vector<double> squares(lines);
+    parallelFor(0, lines, std::max(1, PARALLEL_VALUES / std::max(length, 1)), [&](int lo, int hi) {
+        for(int l = lo; l < hi; l++) {
+            double magnitude = 0;
+            for(int q = 0; q < length; q++) magnitude = std::fmax(magnitude, std::fabs(at(l, q)));
+            // A line of zeros keeps a scale of one so it dequantizes to zeros
+            double scale = magnitude > 0 ? magnitude / largest : 1;
+            double inverse = 1 / scale, square = 0;
+            T *line = values.data() + (long long) l * length;
+            for(int q = 0; q < length; q++) {
+                double value = at(l, q);
+                double rounded = std::min((double) largest, std::max((double) -largest, std::nearbyint(value * inverse)));
+                line[q] = (T) rounded;
+                square += (value - rounded * scale) * (value - rounded * scale);
+            }
+            scales[l] = scale;
+            squares[l] = square;
+        }
+    });
+    return squares;
+}
+
+QuantizedMatrix::QuantizedMatrix(Matrix &matrix, QuantizedType integers, QuantizedScaling scaled) {
+    fp = matrix.getFilePath();
+    m = matrix.rows();
+    n = matrix.columns();
+    type = integers;
+    scaling = scaled;
+    norm = matrix.normFrobenius();
+    const std::vector<std::vector<double>> &rows = matrix.matrix.read();
+    // Each row or column is stored contiguously, so dot products run along both operands
+    int lines = scaling == ROW_SCALES ? m : n, length = scaling == ROW_SCALES ? n : m;
+    std::vector<double> squares;
+    if(scaling == ROW_SCALES) {
+        auto at = [&rows](int l, int q) { return rows[l][q]; };
+        squares = type == QUANTIZE_INT8 ? quantize(lines, length, 127, at, narrow, scales) : quantize(lines, length, 32767, at, wide, scales);
+    } else {
+        auto at = [&rows](int l, int q) { return rows[q][l]; };
+        squares = type == QUANTIZE_INT8 ? quantize(lines, length, 127, at, narrow, scales) : quantize(lines, length, 32767, at, wide, scales);
+    }
+    // Add the lines' errors in order so the result does not depend on the thread count
+    double total = 0;
+    for(int l = 0; l < lines; l++) total += squares[l];
+    rounding = std::sqrt(total);
+}
+
+int QuantizedMatrix::rows() {
+    return m;
+}
+
+int QuantizedMatrix::columns() {
+    return n;
+}
+
+long long QuantizedMatrix::bytes() {
+    return (long long) narrow.size() * sizeof(std::int8_t) + (long long) wide.size() * sizeof(std::int16_t) + (long long) scales.size() * sizeof(double);
+}
+
+double QuantizedMatrix::error() {
+    return rounding;
+}
+
+Matrix QuantizedMatrix::dequantize() {
+    std::vector<std::vector<double>> vals(m, std::vector<double>(n));
+    int length = scaling == ROW_SCALES ? n : m;
+    for(int i = 0; i < m; i++)
+        for(int j = 0; j < n; j++) {
+            int l = scaling == ROW_SCALES ? i : j, q = scaling == ROW_SCALES ? j : i;
+            long long at = (long long) l * length + q;
+            double value = type == QUANTIZE_INT8 ? narrow[at] : wide[at];
+            vals[i][j] = value * scales[l];
+        }
+    return Matrix(fp, vals);
+}
+
+//////////////////////////////////////////
+//  Quantized products
+//////////////////////////////////////////
+
+/**
+ * @brief Computes every dot product of a row of the left operand with a column of
+ * the right one and scales it back, row blocks in parallel over cached tiles of columns
+ */
+template<typename T>
+static std::vector<std::vector<double>> product(int m, int n, int k, const T *a, const std::vector<double> &rowScales, const T *b, const std::vector<double> &columnScales) {
+    std::vector<std::vector<double>> rows(m);
+    int tile = std::max(1, TILE_BYTES / std::max(1, k * (int) sizeof(T)));
+    long long work = (long long) n * std::max(k, 1);
+    parallelFor(0, m, (int) std::max(1LL, PARALLEL_VALUES / work), [&](int lo, int hi) {
+        PlacementScope placement;
+        for(int i = lo; i < hi; i++) rows[i].resize(n);
+        for(int j0 = 0; j0 < n; j0 += tile) {
+            int j1 = std::min(n, j0 + tile);
+            for(int i = lo; i < hi; i++) {
+                const T *row = a + (long long) i * k;
+                double *out = rows[i].data();
+                for(int j = j0; j < j1; j++) out[j] = rowScales[i] * columnScales[j] * (double) dot(row, b + (long long) j * k, k);
+            }
+        }
+    });
+    return rows;
+}
+
+Matrix QuantizedMatrix::operator*(QuantizedMatrix &other) {
+    if(scaling != ROW_SCALES || other.scaling != COLUMN_SCALES || type != other.type) Logger::logInvalidQuantization(fp);
+    if(n != other.m) Logger::logInvalidDimensions(fp, m, n, other.fp, other.m, other.n);
+    if(type == QUANTIZE_INT8) return Matrix(fp, product(m, other.n, n, narrow.data(), scales, other.narrow.data(), other.scales));
+    return Matrix(fp, product(m, other.n, n, wide.data(), scales, other.wide.data(), other.scales));
+}
+
+Matrix QuantizedMatrix::multiply(Matrix &a, Matrix &b, QuantizedType integers, double &error) {
+    if(a.columns() != b.rows()) Logger::logInvalidDimensions(a.getFilePath(), a.rows(), a.columns(), b.getFilePath(), b.rows(), b.columns());
+    QuantizedMatrix left(a, integers, ROW_SCALES), right(b, integers, COLUMN_SCALES);
+    // The norm of Aq is at most |A| + |A - Aq|, and the integer products are exact
+    error = left.rounding * right.norm + (left.norm + left.rounding) * right.rounding;
+    return left * right;
+}
@@ -0,0 +1,128 @@
+#include<string>
+#include<vector>
+#include<cstdint>
+#include"matrix.hpp"
+#ifndef QUANTIZED_HPP
+#define QUANTIZED_HPP
+
+/**
+ * @brief Integer type a quantized matrix stores its values in
+ */
+enum QuantizedType {
+    /** Values from -127 to 127, an eighth of the memory of doubles */
+    QUANTIZE_INT8,
+    /** Values from -32767 to 32767, a quarter of the memory of doubles */
+    QUANTIZE_INT16
+};
+
+/**
+ * @brief Whether each row or each column of a quantized matrix has its own scale
+ */
+enum QuantizedScaling {
+    /** One scale per row, the layout of a left operand */
+    ROW_SCALES,
+    /** One scale per column, the layout of a right operand */
+    COLUMN_SCALES
+};
+
+/**
+ * @brief A Matrix stored as small integers with one scale per row or column,
+ * each value rounded to the nearest multiple of its scale. Products of a row
+ * scaled left operand and a column scaled right operand run on integer dot
+ * products (pmaddwd, or vpdpwssd where AVX-VNNI is enabled) and are scaled back
+ * to doubles, for work that tolerates the precision
+ *
+ */
+class QuantizedMatrix {
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int m, n;
+    /** Integer type of the values */
+    QuantizedType type;
+    /** Whether the scales belong to rows or columns */
+    QuantizedScaling scaling;
+    /** Values of each scaled row or column in turn, in the chosen type */
+    std::vector<std::int8_t> narrow;
+    std::vector<std::int16_t> wide;
+    /** Scale of each row or column, the value its integer 1 stands for */
+    std::vector<double> scales;
+    /** Frobenius norms of the original matrix and of its rounding error */
+    double norm, rounding;
+
+    public:
+    /**
+     * @brief Quantizes a matrix, scaling each row or column so its largest
+     * magnitude maps to the largest integer of the type
+     *
+     * @param matrix matrix to quantize
+     * @param integers integer type to store the values in
+     * @param scaled whether each row or each column gets a scale
+     */
+    QuantizedMatrix(Matrix &matrix, QuantizedType integers, QuantizedScaling scaled);
+
+    /**
+     * @brief Returns the number of rows
+     *
+     * @return int number of rows
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of columns
+     *
+     * @return int number of columns
+     */
+    int columns();
+
+    /**
+     * @brief Returns the memory held by the values and scales
+     *
+     * @return long long size in bytes
+     */
+    long long bytes();
+
+    /**
+     * @brief Returns the Frobenius norm of the difference between the original
+     * matrix and the quantized one
+     *
+     * @return double the quantization error
+     */
+    double error();
+
+    /**
+     * @brief Converts the values back to doubles
+     *
+     * @return Matrix the quantized matrix as doubles
+     */
+    Matrix dequantize();
+
+    /**
+     * @brief Multiplies with integer dot products accumulated in 32 bits. int16
+     * products are widened to 64 bits after each pair is summed, since two of
+     * them can already fill 32 bits
+     *
+     * @param other right operand with a scale per column and the same integer type
+     * @return Matrix the product scaled back to doubles
+     */
+    Matrix operator*(QuantizedMatrix &other);
+
+    /**
+     * @brief Quantizes two matrices and multiplies them, bounding the error
+     * against the product of the originals by
+     *
+     *     |A * B - Aq * Bq| <= |A - Aq| * |B| + |Aq| * |B - Bq|
+     *
+     * in the Frobenius norm
+     *
+     * @param a left operand, quantized with a scale per row
+     * @param b right operand, quantized with a scale per column
+     * @param integers integer type to quantize to
+     * @param error receives the bound on the Frobenius norm of the product's error
+     * @return Matrix the product scaled back to doubles
+     */
+    static Matrix multiply(Matrix &a, Matrix &b, QuantizedType integers, double &error);
+};
+
+#endif
@@ -0,0 +1,299 @@
+#include<cmath>
+#include<atomic>
+#include<vector>
+#include<limits>
+#include<algorithm>
+#include"reductions.hpp"
+#include"parallel.hpp"
+
+// Values summed by one leaf of the tree, fixed so the tree only depends on the data's shape
+static const int LEAF = 4096;
+// Independent accumulators within a leaf so it vectorizes without reassociation
+static const int LANES = 8;
+// Rows summed straight down the columns by one block of a column reduction
+static const int COLUMN_ROWS = 128;
+// Fewest values worth handing to another thread
+static const int PARALLEL_VALUES = 1 << 15;
+
+// Whether sums carry their rounding error along with them
+static std::atomic<bool> compensated(false);
+
+void setCompensatedSummation(bool enabled) {
+    compensated = enabled;
+}
+
+bool getCompensatedSummation() {
+    return compensated;
+}
+
+//////////////////////////////////////////
+//  Summation building blocks
+//////////////////////////////////////////
+
+// A sum together with the rounding error lost while forming it
+struct Partial {
+    double sum;
+    double error;
+};
+
+// Transforms applied to each value before it is added
+struct Identity {
+    double operator()(double value) const { return value; }
+};
+
+struct Absolute {
+    double operator()(double value) const { return std::fabs(value); }
+};
+
+struct Square {
+    double scale;
+    Square(double s) : scale(s) {}
+    double operator()(double value) const { double scaled = value * scale; return scaled * scaled; }
+};
+
+/**
+ * @brief Adds a value to a sum, with Neumaier's compensation collecting the low
+ * order bits the addition rounds away
+ */
+template<bool COMPENSATED>
+static inline void add(double &sum, double &error, double value) {
+    if(!COMPENSATED) {
+        sum += value;
+        return;
+    }
+    double total = sum + value;
+    error += std::fabs(sum) >= std::fabs(value) ? (sum - total) + value : (value - total) + sum;
+    sum = total;
+}
+
+/**
+ * @brief Adds two partial sums, the node of every summation tree
+ */
+template<bool COMPENSATED>
+static inline Partial combine(Partial a, Partial b) {
+    Partial result = {a.sum, a.error + b.error};
+    add<COMPENSATED>(result.sum, result.error, b.sum);
+    return result;
+}
+
+/**
+ * @brief Adds count values into the lanes, each run of LANES values spread one to
+ * a lane and a short tail starting again from the first lane
+ */
+template<bool COMPENSATED, typename F>
+static inline void accumulate(double *sums, double *errors, const double *x, int count, F f) {
+    int i = 0;
+    for(; i + LANES <= count; i += LANES)
+        for(int l = 0; l < LANES; l++) add<COMPENSATED>(sums[l], errors[l], f(x[i + l]));
+    for(int l = 0; i < count; i++, l++) add<COMPENSATED>(sums[l], errors[l], f(x[i]));
+}
+
+/**
+ * @brief Adds count partial sums in a balanced binary tree, always splitting at
+ * half the count
+ */
+template<bool COMPENSATED>
+static Partial pairwise(const Partial *partials, long long count) {
+    if(count == 1) return partials[0];
+    long long half = count / 2;
+    return combine<COMPENSATED>(pairwise<COMPENSATED>(partials, half), pairwise<COMPENSATED>(partials + half, count - half));
+}
+
+/**
+ * @brief Folds the lanes of a leaf into one partial sum with the same fixed tree
+ */
+template<bool COMPENSATED>
+static Partial foldLanes(const double *sums, const double *errors) {
+    Partial lanes[LANES];
+    for(int l = 0; l < LANES; l++) lanes[l] = {sums[l], errors[l]};
+    return pairwise<COMPENSATED>(lanes, LANES);
+}
+
+/**
+ * @brief Sums count contiguous values with the leaves and tree of reduceMatrix,
+ * splitting at half the number of leaves so a single row sums exactly like a
+ * matrix with one row
+ */
+template<bool COMPENSATED, typename F>
+static Partial sumRange(const double *x, int count, F f) {
+    int leaves = (count + LEAF - 1) / LEAF;
+    if(leaves <= 1) {
+        double sums[LANES] = {0}, errors[LANES] = {0};
+        accumulate<COMPENSATED>(sums, errors, x, count, f);
+        return foldLanes<COMPENSATED>(sums, errors);
+    }
+    int half = leaves / 2 * LEAF;
+    return combine<COMPENSATED>(sumRange<COMPENSATED>(x, half, f), sumRange<COMPENSATED>(x + half, count - half, f));
+}
+
+//////////////////////////////////////////
+//  Reductions over every value
+//////////////////////////////////////////
+
+template<bool COMPENSATED, typename F>
+static double sumMatrix(int m, int n, const double *const *rows, F f) {
+    long long total = (long long) m * n;
+    if(total == 0) return 0;
+    // Each leaf takes the next LEAF values in row-major order, crossing rows where it must
+    long long leaves = (total + LEAF - 1) / LEAF;
+    std::vector<Partial> partials(leaves);
+    parallelFor(0, (int) leaves, std::max(1, PARALLEL_VALUES / LEAF), [&](int lo, int hi) {
+        for(int leaf = lo; leaf < hi; leaf++) {
+            double sums[LANES] = {0}, errors[LANES] = {0};
+            long long start = (long long) leaf * LEAF, end = std::min(total, start + LEAF);
+            while(start < end) {
+                int i = (int) (start / n), j = (int) (start % n);
+                int count = (int) std::min<long long>(n - j, end - start);
+                accumulate<COMPENSATED>(sums, errors, rows[i] + j, count, f);
+                start += count;
+            }
+            partials[leaf] = foldLanes<COMPENSATED>(sums, errors);
+        }
+    });
+    // The leaves are combined on this thread in a tree fixed by their number alone
+    Partial result = pairwise<COMPENSATED>(partials.data(), leaves);
+    return result.sum + result.error;
+}
+
+template<typename F>
+static double sumMatrix(int m, int n, const double *const *rows, F f, bool compensate) {
+    return compensate ? sumMatrix<true>(m, n, rows, f) : sumMatrix<false>(m, n, rows, f);
+}
+
+double reduceMatrix(int m, int n, const double *const *rows, Reduction kind, double scale) {
+    // Read the mode once so a call never mixes plain and compensated sums
+    bool compensate = compensated;
+    if(kind == REDUCE_ABSOLUTE) return sumMatrix(m, n, rows, Absolute(), compensate);
+    if(kind == REDUCE_SQUARES) return sumMatrix(m, n, rows, Square(scale), compensate);
+    return sumMatrix(m, n, rows, Identity(), compensate);
+}
+
+//////////////////////////////////////////
+//  Reductions along rows and columns
+//////////////////////////////////////////
+
+template<bool COMPENSATED, typename F>
+static void sumRows(int m, int n, const double *const *rows, F f, double *out) {
+    parallelFor(0, m, std::max(1, PARALLEL_VALUES / std::max(n, 1)), [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++) {
+            Partial row = n > 0 ? sumRange<COMPENSATED>(rows[i], n, f) : Partial{0, 0};
+            out[i] = row.sum + row.error;
+        }
+    });
+}
+
+template<typename F>
+static void sumRows(int m, int n, const double *const *rows, F f, double *out, bool compensate) {
+    if(compensate) sumRows<true>(m, n, rows, f, out);
+    else sumRows<false>(m, n, rows, f, out);
+}
+
+void reduceRows(int m, int n, const double *const *rows, Reduction kind, double *sums) {
+    bool compensate = compensated;
+    if(kind == REDUCE_ABSOLUTE) sumRows(m, n, rows, Absolute(), sums, compensate);
+    else if(kind == REDUCE_SQUARES) sumRows(m, n, rows, Square(1), sums, compensate);
+    else sumRows(m, n, rows, Identity(), sums, compensate);
+}
+
+/**
+ * @brief Adds the column sums of blocks [first, first + count) into block first,
+ * splitting at half the count like pairwise
+ */
+template<bool COMPENSATED>
+static void mergeBlocks(double *sums, double *errors, int n, int first, int count) {
+    if(count == 1) return;
+    int half = count / 2;
+    mergeBlocks<COMPENSATED>(sums, errors, n, first, half);
+    mergeBlocks<COMPENSATED>(sums, errors, n, first + half, count - half);
+    double *s = sums + (long long) first * n, *e = errors + (long long) first * n;
+    const double *t = sums + (long long) (first + half) * n, *u = errors + (long long) (first + half) * n;
+    for(int j = 0; j < n; j++) {
+        e[j] += u[j];
+        add<COMPENSATED>(s[j], e[j], t[j]);
+    }
+}
+
+template<bool COMPENSATED, typename F>
+static void sumColumns(int m, int n, const double *const *rows, F f, double *out) {
+    int blocks = (m + COLUMN_ROWS - 1) / COLUMN_ROWS;
+    if(blocks == 0) {
+        std::fill(out, out + n, 0.0);
+        return;
+    }
+    // Each block of rows runs straight down the columns, one accumulator per column
+    std::vector<double> sums((long long) blocks * n, 0), errors((long long) blocks * n, 0);
+    long long blockValues = (long long) COLUMN_ROWS * std::max(n, 1);
+    parallelFor(0, blocks, (int) std::max(1LL, PARALLEL_VALUES / blockValues), [&](int lo, int hi) {
+        for(int b = lo; b < hi; b++) {
+            double *s = sums.data() + (long long) b * n, *e = errors.data() + (long long) b * n;
+            for(int i = b * COLUMN_ROWS; i < std::min(m, (b + 1) * COLUMN_ROWS); i++) {
+                const double *x = rows[i];
+                for(int j = 0; j < n; j++) add<COMPENSATED>(s[j], e[j], f(x[j]));
+            }
+        }
+    });
+    // The blocks are combined in a tree fixed by their number alone
+    mergeBlocks<COMPENSATED>(sums.data(), errors.data(), n, 0, blocks);
+    for(int j = 0; j < n; j++) out[j] = sums[j] + errors[j];
+}
+
+template<typename F>
+static void sumColumns(int m, int n, const double *const *rows, F f, double *out, bool compensate) {
+    if(compensate) sumColumns<true>(m, n, rows, f, out);
+    else sumColumns<false>(m, n, rows, f, out);
+}
+
+void reduceColumns(int m, int n, const double *const *rows, Reduction kind, double *sums) {
+    bool compensate = compensated;
+    if(kind == REDUCE_ABSOLUTE) sumColumns(m, n, rows, Absolute(), sums, compensate);
+    else if(kind == REDUCE_SQUARES) sumColumns(m, n, rows, Square(1), sums, compensate);
+    else sumColumns(m, n, rows, Identity(), sums, compensate);
+}
+
+//////////////////////////////////////////
+//  Smallest and largest values
+//////////////////////////////////////////
+
+void findExtreme(int m, int n, const double *const *rows, bool largest, int &row, int &column) {
+    double worst = largest ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    // Find each row's extreme in parallel, -1 marking a row holding nothing but NaN
+    std::vector<double> best(m);
+    std::vector<int> where(m);
+    parallelFor(0, m, std::max(1, PARALLEL_VALUES / std::max(n, 1)), [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++) {
+            const double *x = rows[i];
+            // Comparisons with NaN are false, so NaN never replaces a lane's value
+            double lanes[LANES];
+            for(int l = 0; l < LANES; l++) lanes[l] = worst;
+            int j = 0;
+            if(largest) {
+                for(; j + LANES <= n; j += LANES)
+                    for(int l = 0; l < LANES; l++) lanes[l] = x[j + l] > lanes[l] ? x[j + l] : lanes[l];
+                for(int l = 0; j < n; j++, l++) lanes[l] = x[j] > lanes[l] ? x[j] : lanes[l];
+            } else {
+                for(; j + LANES <= n; j += LANES)
+                    for(int l = 0; l < LANES; l++) lanes[l] = x[j + l] < lanes[l] ? x[j + l] : lanes[l];
+                for(int l = 0; j < n; j++, l++) lanes[l] = x[j] < lanes[l] ? x[j] : lanes[l];
+            }
+            double value = lanes[0];
+            for(int l = 1; l < LANES; l++) value = largest ? std::max(value, lanes[l]) : std::min(value, lanes[l]);
+            // The first value equal to the extreme is its position
+            int found = -1;
+            for(j = 0; j < n && found < 0; j++) if(x[j] == value) found = j;
+            best[i] = value;
+            where[i] = found;
+        }
+    });
+    // Pick the first row holding the extreme, which no chunking can change
+    row = 0;
+    column = 0;
+    bool any = false;
+    for(int i = 0; i < m; i++) {
+        if(where[i] < 0) continue;
+        if(!any || (largest ? best[i] > best[row] : best[i] < best[row])) {
+            row = i;
+            column = where[i];
+            any = true;
+        }
+    }
+}
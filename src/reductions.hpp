@@ -0,0 +1,89 @@
+#ifndef REDUCTIONS_HPP
+#define REDUCTIONS_HPP
+
+/**
+ * @brief What a reduction adds up for each value
+ */
+enum Reduction {
+    /** The values themselves */
+    REDUCE_VALUES,
+    /** Their absolute values */
+    REDUCE_ABSOLUTE,
+    /** Their squares after multiplying by a scale */
+    REDUCE_SQUARES
+};
+
+/**
+ * @brief Turns compensated summation on or off for every reduction. Compensated
+ * sums carry the rounding error of each addition along with the sum (Neumaier's
+ * variant of Kahan summation), so their error no longer grows with the number of
+ * values, at roughly twice the cost
+ *
+ * @param enabled whether to compensate, off by default
+ */
+void setCompensatedSummation(bool enabled);
+
+/**
+ * @brief Returns whether reductions use compensated summation
+ *
+ * @return true if sums are compensated
+ */
+bool getCompensatedSummation();
+
+/**
+ * @brief Sums every value of a matrix where row i starts at rows[i]. The values
+ * are taken in row-major order and split into leaves of a fixed size, each summed
+ * across fixed SIMD lanes, and the leaves are added up in a fixed pairwise tree.
+ * The shape of the tree depends only on the matrix's dimensions, so the result is
+ * bitwise identical whatever the number of threads computing the leaves
+ *
+ * @param m rows of the matrix
+ * @param n columns of the matrix
+ * @param rows pointers to the start of each row
+ * @param kind what to add up for each value
+ * @param scale scale applied before squaring, ignored by the other kinds
+ * @return double the sum
+ */
+double reduceMatrix(int m, int n, const double *const *rows, Reduction kind, double scale);
+
+/**
+ * @brief Sums each row of a matrix with the same fixed tree as reduceMatrix, rows
+ * running in parallel
+ *
+ * @param m rows of the matrix
+ * @param n columns of the matrix
+ * @param rows pointers to the start of each row
+ * @param kind what to add up for each value
+ * @param sums receives the m sums
+ */
+void reduceRows(int m, int n, const double *const *rows, Reduction kind, double *sums);
+
+/**
+ * @brief Sums each column of a matrix. Fixed blocks of rows are summed in parallel
+ * straight down the columns, which vectorizes across them, and the blocks are then
+ * added up in a fixed pairwise tree, so the result does not depend on the number
+ * of threads
+ *
+ * @param m rows of the matrix
+ * @param n columns of the matrix
+ * @param rows pointers to the start of each row
+ * @param kind what to add up for each value
+ * @param sums receives the n sums
+ */
+void reduceColumns(int m, int n, const double *const *rows, Reduction kind, double *sums);
+
+/**
+ * @brief Finds the smallest or largest value of a matrix, the first in row-major
+ * order when several are equal. Values that are not a number are skipped unless
+ * every value is one
+ *
+ * @param m rows of the matrix, at least 1
+ * @param n columns of the matrix, at least 1
+ * @param rows pointers to the start of each row
+ * @param largest whether to find the largest rather than the smallest value
+ * @param row receives the row of the value, indexed from 0
+ * @param column receives the column of the value, indexed from 0
+ */
+void findExtreme(int m, int n, const double *const *rows, bool largest, int &row, int &column);
+
+#endif
@@ -0,0 +1,75 @@
+#include<atomic>
+#include<vector>
+#include<utility>
+#include"sharedrows.hpp"
+
+const std::vector<std::vector<double>> SharedRows::empty;
+
+SharedRows::SharedRows() {
+    block = nullptr;
+}
+
+SharedRows::SharedRows(std::vector<std::vector<double>> rows) {
+    block = new Block();
+    block->references = 1;
+    block->rows.swap(rows);
+}
+
+SharedRows::SharedRows(const SharedRows &other) {
+    // A new reference is only ever taken from a live one, so no ordering is needed
+    block = other.block;
+    if(block) block->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+SharedRows::SharedRows(SharedRows &&other) noexcept {
+    // Leave the moved-from handle referring to no rows
+    block = other.block;
+    other.block = nullptr;
+}
+
+SharedRows &SharedRows::operator=(const SharedRows &other) {
+    if(block == other.block) return *this;
+    if(other.block) other.block->references.fetch_add(1, std::memory_order_relaxed);
+    release();
+    block = other.block;
+    return *this;
+}
+
+SharedRows &SharedRows::operator=(SharedRows &&other) noexcept {
+    if(this != &other) std::swap(block, other.block);
+    return *this;
+}
+
+SharedRows::~SharedRows() {
+    release();
+}
+
+void SharedRows::release() {
+    // Writes through every other handle happen before the rows are freed
+    if(block && block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete block;
+}
+
+std::vector<std::vector<double>> &SharedRows::write() {
+    // A handle to no rows gets an empty block of its own on its first write
+    if(!block) {
+        block = new Block();
+        block->references = 1;
+    }
+    detach();
+    return block->rows;
+}
+
+void SharedRows::detach() {
+    // The acquire pairs with the release of the last other handle, so its reads
+    // are finished before this handle writes to rows it now owns alone
+    if(!block || block->references.load(std::memory_order_acquire) == 1) return;
+    Block *copy = new Block();
+    copy->references = 1;
+    copy->rows = block->rows;
+    release();
+    block = copy;
+}
+
+bool SharedRows::shared() const {
+    return block && block->references.load(std::memory_order_acquire) > 1;
+}
@@ -0,0 +1,100 @@
+#include<atomic>
+#include<vector>
+#ifndef SHAREDROWS_HPP
+#define SHAREDROWS_HPP
+
+/**
+ * @brief Reference counted rows of a matrix shared between copies. Copying only
+ * takes a reference, and the first write through rows that are shared splits
+ * off a private copy, so copies that are never written to never copy a value.
+ * Distinct handles may be copied, read and written from different threads, while
+ * one handle follows the rules of a standard container
+ *
+ */
+class SharedRows {
+    private:
+    /**
+     * @brief The rows with the number of handles referring to them
+     *
+     */
+    struct Block {
+        std::atomic<long> references;
+        std::vector<std::vector<double>> rows;
+    };
+
+    /** Rows this handle refers to, null while it refers to no rows */
+    Block *block;
+
+    /** Rows read through every handle that refers to none */
+    static const std::vector<std::vector<double>> empty;
+
+    /**
+     * @brief Drops this handle's reference, freeing the rows after the last one
+     */
+    void release();
+
+    public:
+    /**
+     * @brief Creates a handle to no rows, which allocates nothing until written to
+     *
+     */
+    SharedRows();
+
+    /**
+     * @brief Takes over the given rows
+     *
+     * @param rows rows to hold
+     */
+    SharedRows(std::vector<std::vector<double>> rows);
+
+    SharedRows(const SharedRows &other);
+    SharedRows(SharedRows &&other) noexcept;
+    SharedRows &operator=(const SharedRows &other);
+    SharedRows &operator=(SharedRows &&other) noexcept;
+    ~SharedRows();
+
+    /**
+     * @brief Returns a row for reading, which never copies
+     *
+     * @param row index of the row
+     * @return const std::vector<double>& the row
+     */
+    const std::vector<double> &operator[](int row) const { return read()[row]; }
+
+    /**
+     * @brief Returns the rows for reading, which never copies
+     *
+     * @return const std::vector<std::vector<double>>& the rows
+     */
+    const std::vector<std::vector<double>> &read() const { return block ? block->rows : empty; }
+
+    /**
+     * @brief Returns the number of rows
+     *
+     * @return int number of rows
+     */
+    int size() const { return block ? block->rows.size() : 0; }
+
+    /**
+     * @brief Returns the rows for writing, first copying them if another handle
+     * refers to them too
+     *
+     * @return std::vector<std::vector<double>>& rows owned by this handle alone
+     */
+    std::vector<std::vector<double>> &write();
+
+    /**
+     * @brief Gives this handle rows of its own if they are shared
+     *
+     */
+    void detach();
+
+    /**
+     * @brief Returns whether another handle refers to the same rows
+     *
+     * @return true if the rows are shared
+     */
+    bool shared() const;
+};
+
+#endif
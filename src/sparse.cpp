@@ -0,0 +1,126 @@
+#include<string>
+#include<vector>
+#include<utility>
+#include<algorithm>
+#include"sparse.hpp"
+#include"parallel.hpp"
+
+// Fewest nonzeros worth handing to another thread
+static const int PARALLEL_VALUES = 1 << 14;
+
+//////////////////////////////////////////
+//  Building sparse matrices
+//////////////////////////////////////////
+
+SparseMatrix::SparseMatrix(Matrix &matrix) {
+    fp = matrix.fp;
+    m = matrix.m;
+    n = matrix.n;
+    rowStart.reserve(m + 1);
+    for(int i = 0; i < m; i++) {
+        rowStart.push_back(values.size());
+        const std::vector<double> &row = matrix.matrix[i];
+        for(int j = 0; j < n; j++)
+            if(row[j] != 0) {
+                columnIndex.push_back(j);
+                values.push_back(row[j]);
+            }
+    }
+    rowStart.push_back(values.size());
+}
+
+SparseMatrix::SparseMatrix(int rows, int columns, std::vector<int> &rowIndices, std::vector<int> &columnIndices, std::vector<double> &vals) {
+    fp = "sparse";
+    m = rows;
+    n = columns;
+    // Every value needs both of its indices
+    if(rowIndices.size() != vals.size() || columnIndices.size() != vals.size())
+        Logger::logInvalidDimensions(fp, rowIndices.size(), columnIndices.size(), fp, vals.size(), 1);
+    for(int k = 0; k < vals.size(); k++) {
+        if(rowIndices[k] < 1 || rowIndices[k] > m) Logger::logInvalidRow(rowIndices[k], fp);
+        if(columnIndices[k] < 1 || columnIndices[k] > n) Logger::logInvalidColumn(columnIndices[k], fp);
+    }
+    // Bucket the triplets by row with a counting sort
+    std::vector<int> count(m + 1, 0);
+    for(int k = 0; k < vals.size(); k++) count[rowIndices[k]]++;
+    for(int i = 0; i < m; i++) count[i + 1] += count[i];
+    std::vector<std::pair<int, double>> entries(vals.size());
+    std::vector<int> next(count.begin(), count.end() - 1);
+    for(int k = 0; k < vals.size(); k++) entries[next[rowIndices[k] - 1]++] = std::make_pair(columnIndices[k] - 1, vals[k]);
+    // Sort each row by column and sum repeated positions
+    rowStart.reserve(m + 1);
+    for(int i = 0; i < m; i++) {
+        rowStart.push_back(values.size());
+        std::sort(entries.begin() + count[i], entries.begin() + count[i + 1]);
+        for(int k = count[i]; k < count[i + 1]; k++) {
+            if(values.size() > rowStart[i] && columnIndex.back() == entries[k].first) values.back() += entries[k].second;
+            else {
+                columnIndex.push_back(entries[k].first);
+                values.push_back(entries[k].second);
+            }
+        }
+    }
+    rowStart.push_back(values.size());
+}
+
+//////////////////////////////////////////
+//  Accessors for sparse matrices
+//////////////////////////////////////////
+
+int SparseMatrix::rows() {
+    return m;
+}
+
+int SparseMatrix::columns() {
+    return n;
+}
+
+long long SparseMatrix::nonZeros() {
+    return values.size();
+}
+
+double SparseMatrix::access(int row, int column) {
+    if(row < 1 || row > m) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Columns ascend within a row, so search for the column
+    std::vector<int>::iterator first = columnIndex.begin() + rowStart[row - 1];
+    std::vector<int>::iterator last = columnIndex.begin() + rowStart[row];
+    std::vector<int>::iterator found = std::lower_bound(first, last, column - 1);
+    if(found == last || *found != column - 1) return 0;
+    return values[found - columnIndex.begin()];
+}
+
+std::string SparseMatrix::getFilePath() {
+    return fp;
+}
+
+Matrix SparseMatrix::toMatrix() {
+    std::vector<std::vector<double>> vals(m, std::vector<double>(n, 0));
+    for(int i = 0; i < m; i++)
+        for(int k = rowStart[i]; k < rowStart[i + 1]; k++) vals[i][columnIndex[k]] = values[k];
+    return Matrix(fp, std::move(vals));
+}
+
+//////////////////////////////////////////
+//  Operations for sparse matrices
+//////////////////////////////////////////
+
+void SparseMatrix::multiply(const double *x, double *y) {
+    // Each output is an independent sparse dot product, so split the rows across threads
+    int grain = std::max(1LL, PARALLEL_VALUES * (long long) m / std::max(1LL, (long long) values.size()));
+    parallelFor(0, m, grain, [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++) {
+            double sum = 0;
+            for(int k = rowStart[i]; k < rowStart[i + 1]; k++) sum += values[k] * x[columnIndex[k]];
+            y[i] = sum;
+        }
+    });
+}
+
+Vector SparseMatrix::operator*(Vector &other) {
+    // If dimensions don't match display error message
+    if(n != other.size()) Logger::logInvalidDimensions(fp, m, n, other.getFilePath(), other.size(), 1);
+    std::vector<double> y(m);
+    multiply(other.values.data(), y.data());
+    return Vector(fp, std::move(y));
+}
@@ -0,0 +1,109 @@
+#include<string>
+#include<vector>
+#include"matrix.hpp"
+#include"vector.hpp"
+#ifndef SPARSE_HPP
+#define SPARSE_HPP
+
+/**
+ * @brief An MxN matrix holding only its nonzero values in compressed sparse
+ * row form, for systems far too large to ever store densely
+ *
+ */
+class SparseMatrix {
+    friend class SparseOperator;
+    friend class JacobiPreconditioner;
+    friend class IncompleteLU;
+    friend class IncompleteCholesky;
+
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int m, n;
+    /** Position in columnIndex and values where each row starts, followed by the number of nonzeros */
+    std::vector<int> rowStart;
+    /** Column of each nonzero, indexed from 0 and ascending within each row */
+    std::vector<int> columnIndex;
+    /** Nonzero values row by row */
+    std::vector<double> values;
+
+    /**
+     * @brief Computes y = A * x for contiguous vectors, running blocks of rows in parallel
+     */
+    void multiply(const double *x, double *y);
+
+    public:
+    /**
+     * @brief Copies the nonzero values of a dense matrix
+     *
+     * @param matrix matrix to copy
+     */
+    SparseMatrix(Matrix &matrix);
+
+    /**
+     * @brief Builds a matrix from (row, column, value) triplets in any order,
+     * summing the values of repeated positions
+     *
+     * @param rows number of rows
+     * @param columns number of columns
+     * @param rowIndices row of each value, starting from 1
+     * @param columnIndices column of each value, starting from 1
+     * @param vals values to store
+     */
+    SparseMatrix(int rows, int columns, std::vector<int> &rowIndices, std::vector<int> &columnIndices, std::vector<double> &vals);
+
+    /**
+     * @brief Returns the number of rows
+     *
+     * @return int number of rows
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of columns
+     *
+     * @return int number of columns
+     */
+    int columns();
+
+    /**
+     * @brief Returns the number of values stored
+     *
+     * @return long long number of nonzeros
+     */
+    long long nonZeros();
+
+    /**
+     * @brief Returns the value at a given row and column, 0 where nothing is stored
+     *
+     * @param row row to access value from
+     * @param column column to access value from
+     * @return double value at the indices in the matrix
+     */
+    double access(int row, int column);
+
+    /**
+     * @brief Returns the filepath identifer of the matrix
+     *
+     * @return std::string containing the filepath
+     */
+    std::string getFilePath();
+
+    /**
+     * @brief Returns the matrix as a dense Matrix, zeros included
+     *
+     * @return Matrix the MxN matrix
+     */
+    Matrix toMatrix();
+
+    /**
+     * @brief Multiplies the matrix with a vector
+     *
+     * @param other vector with N values
+     * @return Vector the product
+     */
+    Vector operator*(Vector &other);
+};
+
+#endif
@@ -0,0 +1,586 @@
+#include<cmath>
+#include<string>
+#include<vector>
+#include<utility>
+#include<algorithm>
+#include"structured.hpp"
+#include"kernels.hpp"
+#include"parallel.hpp"
+
+// Fewest values worth handing to another thread
+static const int PARALLEL_VALUES = 1 << 14;
+
+/**
+ * @brief Returns a grain of rows or columns holding enough values to be worth a thread
+ */
+static int grainFor(long long valuesEach) {
+    return std::max(1LL, PARALLEL_VALUES / std::max(1LL, valuesEach));
+}
+
+//////////////////////////////////////////
+//  Triangular matrices
+//////////////////////////////////////////
+
+TriangularMatrix::TriangularMatrix(std::string filepath, int size, bool isLower, std::vector<double> vals) {
+    fp = filepath;
+    n = size;
+    lower = isLower;
+    packed.swap(vals);
+}
+
+TriangularMatrix::TriangularMatrix(Matrix &matrix, bool isLower) {
+    if(matrix.m != matrix.n) Logger::logInvalidStructure(matrix.fp);
+    fp = matrix.fp;
+    n = matrix.n;
+    lower = isLower;
+    packed.reserve((long long) n * (n + 1) / 2);
+    for(int i = 0; i < n; i++) {
+        const std::vector<double> &row = matrix.matrix[i];
+        if(lower) packed.insert(packed.end(), row.begin(), row.begin() + i + 1);
+        else packed.insert(packed.end(), row.begin() + i, row.end());
+    }
+}
+
+long long TriangularMatrix::offset(int row, int column) {
+    // Lower rows grow by one value each, upper rows shrink by one
+    if(lower) return (long long) row * (row + 1) / 2 + column;
+    return (long long) row * n - (long long) row * (row - 1) / 2 + column - row;
+}
+
+int TriangularMatrix::rows() {
+    return n;
+}
+
+int TriangularMatrix::columns() {
+    return n;
+}
+
+bool TriangularMatrix::isLower() {
+    return lower;
+}
+
+double TriangularMatrix::access(int row, int column) {
+    // Check the bounds of the row and column
+    if(row < 1 || row > n) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Values outside the triangle are zero
+    if(lower ? column > row : column < row) return 0;
+    return packed[offset(row - 1, column - 1)];
+}
+
+std::string TriangularMatrix::getFilePath() {
+    return fp;
+}
+
+Matrix TriangularMatrix::toMatrix() {
+    std::vector<std::vector<double>> vals(n, std::vector<double>(n, 0));
+    for(int i = 0; i < n; i++) {
+        const double *row = packed.data() + offset(i, lower ? 0 : i);
+        if(lower) std::copy(row, row + i + 1, vals[i].begin());
+        else std::copy(row, row + n - i, vals[i].begin() + i);
+    }
+    return Matrix(fp, std::move(vals));
+}
+
+TriangularMatrix TriangularMatrix::transpose() {
+    TriangularMatrix result(fp, n, !lower, std::vector<double>(packed.size()));
+    for(int i = 0; i < n; i++)
+        for(int j = lower ? 0 : i; j <= (lower ? i : n - 1); j++)
+            result.packed[result.offset(j, i)] = packed[offset(i, j)];
+    return result;
+}
+
+Matrix TriangularMatrix::operator*(Matrix &other) {
+    // If dimensions don't match display error message
+    if(n != other.rows()) Logger::logInvalidDimensions(fp, n, n, other.getFilePath(), other.rows(), other.columns());
+    int r = other.columns();
+    std::vector<double> b = other.flatten();
+    std::vector<double> c((long long) n * r, 0);
+    // Each row of the product only gathers the rows of B inside the triangle
+    parallelFor(0, n, grainFor((long long) n * r / 2), [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++) {
+            int first = lower ? 0 : i, last = lower ? i : n - 1;
+            const double *row = packed.data() + offset(i, first);
+            for(int k = first; k <= last; k++) vectorAxpy(r, row[k - first], b.data() + (long long) k * r, c.data() + (long long) i * r);
+        }
+    });
+    return Matrix(fp, n, r, c);
+}
+
+Matrix TriangularMatrix::solve(Matrix &b) {
+    // The system must be square with a nonzero diagonal
+    if(b.rows() != n) Logger::logInvalidSolve(fp);
+    for(int i = 0; i < n; i++)
+        if(packed[offset(i, i)] == 0) Logger::logInvalidSolve(fp);
+    int r = b.columns();
+    std::vector<double> x = b.flatten();
+    // Substitution runs down (or up) the rows, so the columns are split between threads instead
+    parallelFor(0, r, grainFor((long long) n * n / 2), [&](int lo, int hi) {
+        int width = hi - lo;
+        for(int step = 0; step < n; step++) {
+            int i = lower ? step : n - 1 - step;
+            double *target = x.data() + (long long) i * r + lo;
+            int first = lower ? 0 : i + 1, last = lower ? i - 1 : n - 1;
+            for(int k = first; k <= last; k++) vectorAxpy(width, -packed[offset(i, k)], x.data() + (long long) k * r + lo, target);
+            vectorScale(width, 1 / packed[offset(i, i)], target);
+        }
+    });
+    return Matrix(fp, n, r, x);
+}
+
+std::vector<TriangularMatrix> TriangularMatrix::decomposeLU(Matrix &matrix) {
+    // Pack the dense factors, which are cached against the matrix
+    std::vector<Matrix> factors = matrix.decomposeLU();
+    return {TriangularMatrix(factors[0], true), TriangularMatrix(factors[1], false)};
+}
+
+//////////////////////////////////////////
+//  Symmetric matrices
+//////////////////////////////////////////
+
+SymmetricMatrix::SymmetricMatrix(Matrix &matrix) {
+    if(matrix.m != matrix.n) Logger::logInvalidStructure(matrix.fp);
+    fp = matrix.fp;
+    n = matrix.n;
+    packed.reserve((long long) n * (n + 1) / 2);
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j <= i; j++) {
+            if(matrix.matrix[i][j] != matrix.matrix[j][i]) Logger::logInvalidStructure(fp);
+            packed.push_back(matrix.matrix[i][j]);
+        }
+}
+
+int SymmetricMatrix::rows() {
+    return n;
+}
+
+int SymmetricMatrix::columns() {
+    return n;
+}
+
+double SymmetricMatrix::access(int row, int column) {
+    // Check the bounds of the row and column
+    if(row < 1 || row > n) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Values above the diagonal mirror those below
+    if(column > row) std::swap(row, column);
+    return packed[(long long) (row - 1) * row / 2 + column - 1];
+}
+
+std::string SymmetricMatrix::getFilePath() {
+    return fp;
+}
+
+Matrix SymmetricMatrix::toMatrix() {
+    std::vector<std::vector<double>> vals(n, std::vector<double>(n));
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j <= i; j++) vals[i][j] = vals[j][i] = packed[(long long) i * (i + 1) / 2 + j];
+    return Matrix(fp, std::move(vals));
+}
+
+Matrix SymmetricMatrix::operator*(Matrix &other) {
+    // If dimensions don't match display error message
+    if(n != other.rows()) Logger::logInvalidDimensions(fp, n, n, other.getFilePath(), other.rows(), other.columns());
+    int r = other.columns();
+    std::vector<double> b = other.flatten();
+    std::vector<double> c((long long) n * r, 0);
+    // Row i of S is row i of the packed triangle, then column i of the rows below
+    parallelFor(0, n, grainFor((long long) n * r), [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++) {
+            double *target = c.data() + (long long) i * r;
+            const double *row = packed.data() + (long long) i * (i + 1) / 2;
+            for(int k = 0; k <= i; k++) vectorAxpy(r, row[k], b.data() + (long long) k * r, target);
+            for(int k = i + 1; k < n; k++) vectorAxpy(r, packed[(long long) k * (k + 1) / 2 + i], b.data() + (long long) k * r, target);
+        }
+    });
+    return Matrix(fp, n, r, c);
+}
+
+TriangularMatrix SymmetricMatrix::decomposeCholesky() {
+    // Rows of L are contiguous in the packed layout, so each value is one dot product
+    std::vector<double> l(packed.size());
+    for(int i = 0; i < n; i++) {
+        double *rowI = l.data() + (long long) i * (i + 1) / 2;
+        for(int j = 0; j <= i; j++) {
+            const double *rowJ = l.data() + (long long) j * (j + 1) / 2;
+            double sum = packed[(long long) i * (i + 1) / 2 + j] - vectorDot(j, rowI, rowJ);
+            if(i == j) {
+                if(!(sum > 0)) Logger::logInvalidCholesky(fp);
+                rowI[i] = std::sqrt(sum);
+            } else rowI[j] = sum / rowJ[j];
+        }
+    }
+    return TriangularMatrix(fp, n, true, std::move(l));
+}
+
+Matrix SymmetricMatrix::solve(Matrix &b) {
+    if(b.rows() != n) Logger::logInvalidSolve(fp);
+    // L * L^T * X = B, solved as L * Y = B then L^T * X = Y
+    TriangularMatrix factor = decomposeCholesky();
+    Matrix y = factor.solve(b);
+    TriangularMatrix upper = factor.transpose();
+    return upper.solve(y);
+}
+
+//////////////////////////////////////////
+//  Banded matrices
+//////////////////////////////////////////
+
+BandedMatrix::BandedMatrix(int size, int lowerBandwidth, int upperBandwidth) {
+    if(size < 1 || lowerBandwidth < 0 || upperBandwidth < 0) Logger::logInvalidStructure("banded");
+    fp = "banded";
+    n = size;
+    kl = std::min(lowerBandwidth, n - 1);
+    ku = std::min(upperBandwidth, n - 1);
+    band.assign((long long) n * (kl + ku + 1), 0);
+}
+
+BandedMatrix::BandedMatrix(Matrix &matrix, int lowerBandwidth, int upperBandwidth) {
+    if(matrix.m != matrix.n || lowerBandwidth < 0 || upperBandwidth < 0) Logger::logInvalidStructure(matrix.fp);
+    fp = matrix.fp;
+    n = matrix.n;
+    kl = std::min(lowerBandwidth, std::max(n - 1, 0));
+    ku = std::min(upperBandwidth, std::max(n - 1, 0));
+    int width = kl + ku + 1;
+    band.assign((long long) n * width, 0);
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++) {
+            double value = matrix.matrix[i][j];
+            if(j >= i - kl && j <= i + ku) band[(long long) i * width + j - i + kl] = value;
+            else if(value != 0) Logger::logInvalidStructure(fp);
+        }
+}
+
+int BandedMatrix::rows() {
+    return n;
+}
+
+int BandedMatrix::columns() {
+    return n;
+}
+
+int BandedMatrix::lowerBandwidth() {
+    return kl;
+}
+
+int BandedMatrix::upperBandwidth() {
+    return ku;
+}
+
+double BandedMatrix::access(int row, int column) {
+    // Check the bounds of the row and column
+    if(row < 1 || row > n) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Values outside the band are zero
+    if(column - row > ku || row - column > kl) return 0;
+    return band[(long long) (row - 1) * (kl + ku + 1) + column - row + kl];
+}
+
+void BandedMatrix::set(int row, int column, double value) {
+    // Check the bounds of the row and column
+    if(row < 1 || row > n) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    // Only values inside the band can be stored
+    if(column - row > ku || row - column > kl) Logger::logInvalidStructure(fp);
+    band[(long long) (row - 1) * (kl + ku + 1) + column - row + kl] = value;
+}
+
+std::string BandedMatrix::getFilePath() {
+    return fp;
+}
+
+Matrix BandedMatrix::toMatrix() {
+    std::vector<std::vector<double>> vals(n, std::vector<double>(n, 0));
+    for(int i = 0; i < n; i++)
+        for(int j = std::max(0, i - kl); j <= std::min(n - 1, i + ku); j++) vals[i][j] = band[(long long) i * (kl + ku + 1) + j - i + kl];
+    return Matrix(fp, std::move(vals));
+}
+
+Matrix BandedMatrix::operator*(Matrix &other) {
+    // If dimensions don't match display error message
+    if(n != other.rows()) Logger::logInvalidDimensions(fp, n, n, other.getFilePath(), other.rows(), other.columns());
+    int r = other.columns();
+    std::vector<double> b = other.flatten();
+    std::vector<double> c((long long) n * r, 0);
+    // Each row of the product gathers only the rows of B inside its band
+    parallelFor(0, n, grainFor((long long) (kl + ku + 1) * r), [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++)
+            for(int j = std::max(0, i - kl); j <= std::min(n - 1, i + ku); j++)
+                vectorAxpy(r, band[(long long) i * (kl + ku + 1) + j - i + kl], b.data() + (long long) j * r, c.data() + (long long) i * r);
+    });
+    return Matrix(fp, n, r, c);
+}
+
+Matrix BandedMatrix::solve(Matrix &b) {
+    if(b.rows() != n) Logger::logInvalidSolve(fp);
+    std::vector<double> x = b.flatten();
+    solveInPlace(b.columns(), x);
+    return Matrix(fp, n, b.columns(), x);
+}
+
+Vector BandedMatrix::solve(Vector &b) {
+    if(b.size() != n) Logger::logInvalidSolve(fp);
+    std::vector<double> x = b.values;
+    solveInPlace(1, x);
+    return Vector(fp, std::move(x));
+}
+
+void BandedMatrix::solveInPlace(int r, std::vector<double> &x) {
+    // Row swaps widen the upper factor by kl diagonals, so each row gets room for them
+    int width = 2 * kl + ku + 1;
+    std::vector<double> lu((long long) n * width, 0);
+    for(int i = 0; i < n; i++)
+        std::copy(band.begin() + (long long) i * (kl + ku + 1), band.begin() + (long long) (i + 1) * (kl + ku + 1), lu.begin() + (long long) i * width);
+    // Value (i, j) of the working rows, for j from i - kl to i + kl + ku
+    auto at = [&lu, width, this](int i, int j) -> double& { return lu[(long long) i * width + j - i + kl]; };
+    for(int k = 0; k < n; k++) {
+        int last = std::min(n - 1, k + kl);
+        int right = std::min(n - 1, k + kl + ku);
+        // Pivot on the largest value of the column within the band
+        int pivot = k;
+        for(int i = k + 1; i <= last; i++)
+            if(std::fabs(at(i, k)) > std::fabs(at(pivot, k))) pivot = i;
+        if(at(pivot, k) == 0) Logger::logInvalidSolve(fp);
+        if(pivot != k) {
+            for(int j = k; j <= right; j++) std::swap(at(k, j), at(pivot, j));
+            std::swap_ranges(x.begin() + (long long) k * r, x.begin() + (long long) (k + 1) * r, x.begin() + (long long) pivot * r);
+        }
+        // Eliminate below the pivot, carrying the right hand sides along
+        for(int i = k + 1; i <= last; i++) {
+            double factor = at(i, k) / at(k, k);
+            if(factor == 0) continue;
+            at(i, k) = 0;
+            for(int j = k + 1; j <= right; j++) at(i, j) -= factor * at(k, j);
+            vectorAxpy(r, -factor, x.data() + (long long) k * r, x.data() + (long long) i * r);
+        }
+    }
+    // Back substitution through the widened upper factor
+    for(int i = n - 1; i >= 0; i--) {
+        double *target = x.data() + (long long) i * r;
+        for(int j = i + 1; j <= std::min(n - 1, i + kl + ku); j++) vectorAxpy(r, -at(i, j), x.data() + (long long) j * r, target);
+        vectorScale(r, 1 / at(i, i), target);
+    }
+}
+
+//////////////////////////////////////////
+//  Tridiagonal matrices
+//////////////////////////////////////////
+
+// Fewest rows each block of the parallel solve should get
+static const int SPIKE_BLOCK = 4096;
+// Systems interleaved together by the batched solve
+static const int BATCH_GROUP = 32;
+
+/**
+ * @brief Solves a tridiagonal system in place with the Thomas algorithm for r
+ * right hand sides stored row by row, returning false on a zero pivot. lower[i]
+ * couples row i + 1 to row i and upper[i] couples row i to row i + 1
+ */
+static bool thomas(int n, const double *lower, const double *diagonal, const double *upper, int r, double *d, std::vector<double> &scratch) {
+    scratch.resize(n);
+    // Forward sweep, scaling each row so its pivot becomes one
+    for(int i = 0; i < n; i++) {
+        double pivot = diagonal[i] - (i > 0 ? lower[i - 1] * scratch[i - 1] : 0);
+        if(pivot == 0) return false;
+        double inverse = 1 / pivot;
+        scratch[i] = i < n - 1 ? upper[i] * inverse : 0;
+        // Rows hold only a few right hand sides, so the loops stay inline rather than calling the kernels
+        double *row = d + (long long) i * r;
+        double coupling = i > 0 ? lower[i - 1] : 0;
+        for(int j = 0; j < r; j++) row[j] = (row[j] - (i > 0 ? coupling * row[j - r] : 0)) * inverse;
+    }
+    // Back substitution
+    for(int i = n - 2; i >= 0; i--) {
+        double *row = d + (long long) i * r;
+        for(int j = 0; j < r; j++) row[j] -= scratch[i] * row[j + r];
+    }
+    return true;
+}
+
+TridiagonalMatrix::TridiagonalMatrix(Vector &below, Vector &main, Vector &above) {
+    fp = main.getFilePath();
+    n = main.size();
+    if(n < 1 || below.size() != n - 1 || above.size() != n - 1) Logger::logInvalidStructure(fp);
+    lower = below.values;
+    diagonal = main.values;
+    upper = above.values;
+}
+
+TridiagonalMatrix::TridiagonalMatrix(Matrix &matrix) {
+    if(matrix.m != matrix.n) Logger::logInvalidStructure(matrix.fp);
+    fp = matrix.fp;
+    n = matrix.n;
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++) {
+            double value = matrix.matrix[i][j];
+            if(j == i) diagonal.push_back(value);
+            else if(j == i - 1) lower.push_back(value);
+            else if(j == i + 1) upper.push_back(value);
+            else if(value != 0) Logger::logInvalidStructure(fp);
+        }
+}
+
+int TridiagonalMatrix::rows() {
+    return n;
+}
+
+int TridiagonalMatrix::columns() {
+    return n;
+}
+
+double TridiagonalMatrix::access(int row, int column) {
+    // Check the bounds of the row and column
+    if(row < 1 || row > n) Logger::logInvalidRow(row, fp);
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    if(column == row) return diagonal[row - 1];
+    if(column == row - 1) return lower[column - 1];
+    if(column == row + 1) return upper[row - 1];
+    return 0;
+}
+
+std::string TridiagonalMatrix::getFilePath() {
+    return fp;
+}
+
+Matrix TridiagonalMatrix::toMatrix() {
+    std::vector<std::vector<double>> vals(n, std::vector<double>(n, 0));
+    for(int i = 0; i < n; i++) {
+        vals[i][i] = diagonal[i];
+        if(i > 0) vals[i][i - 1] = lower[i - 1];
+        if(i < n - 1) vals[i][i + 1] = upper[i];
+    }
+    return Matrix(fp, std::move(vals));
+}
+
+Vector TridiagonalMatrix::operator*(Vector &other) {
+    // If dimensions don't match display error message
+    if(n != other.size()) Logger::logInvalidDimensions(fp, n, n, other.getFilePath(), other.size(), 1);
+    const std::vector<double> &x = other.values;
+    std::vector<double> y(n);
+    parallelFor(0, n, PARALLEL_VALUES, [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++)
+            y[i] = diagonal[i] * x[i] + (i > 0 ? lower[i - 1] * x[i - 1] : 0) + (i < n - 1 ? upper[i] * x[i + 1] : 0);
+    });
+    return Vector(fp, std::move(y));
+}
+
+Vector TridiagonalMatrix::solve(Vector &b) {
+    if(b.size() != n) Logger::logInvalidSolve(fp);
+    std::vector<double> x = b.values;
+    std::vector<double> scratch;
+    if(!thomas(n, lower.data(), diagonal.data(), upper.data(), 1, x.data(), scratch)) Logger::logInvalidSolve(fp);
+    return Vector(fp, std::move(x));
+}
+
+Vector TridiagonalMatrix::solveParallel(Vector &b) {
+    if(b.size() != n) Logger::logInvalidSolve(fp);
+    int blocks = std::min(getThreadCount(), n / SPIKE_BLOCK);
+    if(blocks < 2) return solve(b);
+    // Each block solves for its right hand side and the two spikes, the columns of
+    // the block times the values coupling it to the last row before it and the first row after it
+    std::vector<std::vector<double>> local(blocks);
+    std::vector<char> solved(blocks, 1);
+    parallelFor(0, blocks, 1, [&](int lo, int hi) {
+        std::vector<double> scratch;
+        for(int k = lo; k < hi; k++) {
+            int first = (long long) n * k / blocks, last = (long long) n * (k + 1) / blocks;
+            int size = last - first;
+            std::vector<double> &d = local[k];
+            d.assign((long long) size * 3, 0);
+            for(int i = 0; i < size; i++) d[(long long) i * 3] = b.values[first + i];
+            if(k > 0) d[1] = lower[first - 1];
+            if(k < blocks - 1) d[(long long) (size - 1) * 3 + 2] = upper[last - 1];
+            solved[k] = thomas(size, lower.data() + first, diagonal.data() + first, upper.data() + first, 3, d.data(), scratch);
+        }
+    });
+    for(int k = 0; k < blocks; k++)
+        if(!solved[k]) Logger::logInvalidSolve(fp);
+    // The first and last unknown of every block form a small banded system, with
+    // x[first] + left[first] * x[first - 1] + right[first] * x[last] = y[first] and likewise for x[last - 1]
+    BandedMatrix boundary(2 * blocks, 2, 2);
+    std::vector<double> ends(2 * blocks);
+    for(int k = 0; k < blocks; k++) {
+        int size = (long long) n * (k + 1) / blocks - (long long) n * k / blocks;
+        const double *top = local[k].data(), *bottom = local[k].data() + (long long) (size - 1) * 3;
+        boundary.set(2 * k + 1, 2 * k + 1, 1);
+        boundary.set(2 * k + 2, 2 * k + 2, 1);
+        if(k > 0) {
+            boundary.set(2 * k + 1, 2 * k, top[1]);
+            boundary.set(2 * k + 2, 2 * k, bottom[1]);
+        }
+        if(k < blocks - 1) {
+            boundary.set(2 * k + 1, 2 * k + 3, top[2]);
+            boundary.set(2 * k + 2, 2 * k + 3, bottom[2]);
+        }
+        ends[2 * k] = top[0];
+        ends[2 * k + 1] = bottom[0];
+    }
+    boundary.fp = fp;
+    boundary.solveInPlace(1, ends);
+    // Correct every block with the boundary values of its neighbours
+    std::vector<double> x(n);
+    parallelFor(0, blocks, 1, [&](int lo, int hi) {
+        for(int k = lo; k < hi; k++) {
+            int first = (long long) n * k / blocks, last = (long long) n * (k + 1) / blocks;
+            double before = k > 0 ? ends[2 * k - 1] : 0, after = k < blocks - 1 ? ends[2 * k + 2] : 0;
+            const double *d = local[k].data();
+            for(int i = first; i < last; i++, d += 3) x[i] = d[0] - d[1] * before - d[2] * after;
+        }
+    });
+    return Vector(fp, std::move(x));
+}
+
+std::vector<Vector> TridiagonalMatrix::solveBatch(std::vector<TridiagonalMatrix> &systems, std::vector<Vector> &b) {
+    int count = systems.size();
+    if(count != b.size()) Logger::logInvalidSolve(count > 0 ? systems[0].fp : "batch");
+    if(count == 0) return std::vector<Vector>();
+    int n = systems[0].n;
+    for(int s = 0; s < count; s++)
+        if(systems[s].n != n || b[s].size() != n) Logger::logInvalidSolve(systems[s].fp);
+    std::vector<std::vector<double>> x(count);
+    std::vector<int> failed(count, 0);
+    parallelFor(0, (count + BATCH_GROUP - 1) / BATCH_GROUP, std::max(1, PARALLEL_VALUES / (n * BATCH_GROUP)), [&](int lo, int hi) {
+        std::vector<double> a((long long) n * BATCH_GROUP), c((long long) n * BATCH_GROUP), d((long long) n * BATCH_GROUP);
+        for(int group = lo; group < hi; group++) {
+            int base = group * BATCH_GROUP, width = std::min(BATCH_GROUP, count - base);
+            // Interleave the group so value i of every system sits together
+            for(int i = 0; i < n; i++)
+                for(int s = 0; s < width; s++) {
+                    TridiagonalMatrix &system = systems[base + s];
+                    a[(long long) i * width + s] = i > 0 ? system.lower[i - 1] : 0;
+                    c[(long long) i * width + s] = i < n - 1 ? system.upper[i] : 0;
+                    d[(long long) i * width + s] = b[base + s].values[i];
+                }
+            // Forward sweep across the group, c receives the scaled upper diagonal
+            std::vector<double> pivot(width);
+            for(int i = 0; i < n; i++) {
+                double *ai = a.data() + (long long) i * width, *ci = c.data() + (long long) i * width, *di = d.data() + (long long) i * width;
+                for(int s = 0; s < width; s++) {
+                    double diagonal = systems[base + s].diagonal[i];
+                    pivot[s] = i > 0 ? diagonal - ai[s] * ci[s - width] : diagonal;
+                    if(pivot[s] == 0) {
+                        failed[base + s] = 1;
+                        pivot[s] = 1;
+                    }
+                    di[s] = ((i > 0 ? di[s] - ai[s] * di[s - width] : di[s])) / pivot[s];
+                    ci[s] /= pivot[s];
+                }
+            }
+            // Back substitution across the group
+            for(int i = n - 2; i >= 0; i--) {
+                double *ci = c.data() + (long long) i * width, *di = d.data() + (long long) i * width;
+                for(int s = 0; s < width; s++) di[s] -= ci[s] * di[s + width];
+            }
+            for(int s = 0; s < width; s++) {
+                x[base + s].resize(n);
+                for(int i = 0; i < n; i++) x[base + s][i] = d[(long long) i * width + s];
+            }
+        }
+    });
+    std::vector<Vector> results;
+    for(int s = 0; s < count; s++) {
+        if(failed[s]) Logger::logInvalidSolve(systems[s].fp);
+        results.push_back(Vector(systems[s].fp, std::move(x[s])));
+    }
+    return results;
+}
@@ -0,0 +1,454 @@
+#include<string>
+#include<vector>
+#include"matrix.hpp"
+#include"vector.hpp"
+#ifndef STRUCTURED_HPP
+#define STRUCTURED_HPP
+
+/**
+ * @brief An NxN lower or upper triangular matrix holding only its triangle,
+ * packed row by row in n * (n + 1) / 2 values. Products and solves skip the
+ * known zeros of the other triangle
+ *
+ */
+class TriangularMatrix {
+    friend class SymmetricMatrix;
+
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int n;
+    /** Whether the values sit on and below the diagonal, rather than on and above */
+    bool lower;
+    /** Rows of the triangle one after another */
+    std::vector<double> packed;
+
+    /**
+     * @brief Special constructor for building a triangle from packed values
+     *
+     * @param filepath filepath identifer for the matrix
+     * @param size number of rows and columns
+     * @param isLower whether the triangle is the lower one
+     * @param vals packed rows of the triangle
+     */
+    TriangularMatrix(std::string filepath, int size, bool isLower, std::vector<double> vals);
+
+    /**
+     * @brief Returns the offset of a value of the triangle within the packed rows, indexed from 0
+     */
+    long long offset(int row, int column);
+
+    public:
+    /**
+     * @brief Takes the lower or upper triangle of an NxN matrix, ignoring the other values
+     *
+     * @param matrix matrix to copy the triangle from
+     * @param isLower whether to take the lower triangle
+     */
+    TriangularMatrix(Matrix &matrix, bool isLower);
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int columns();
+
+    /**
+     * @brief Returns whether the matrix is lower triangular
+     *
+     * @return true if the values sit on and below the diagonal
+     */
+    bool isLower();
+
+    /**
+     * @brief Returns the value at a given row and column, 0 outside the triangle
+     *
+     * @param row row to access value from
+     * @param column column to access value from
+     * @return double value at the indices in the matrix
+     */
+    double access(int row, int column);
+
+    /**
+     * @brief Returns the filepath identifer of the matrix
+     *
+     * @return std::string containing the filepath
+     */
+    std::string getFilePath();
+
+    /**
+     * @brief Returns the matrix as a dense Matrix, zeros included
+     *
+     * @return Matrix the NxN matrix
+     */
+    Matrix toMatrix();
+
+    /**
+     * @brief Returns the transpose, which is triangular on the other side
+     *
+     * @return TriangularMatrix the transposed triangle
+     */
+    TriangularMatrix transpose();
+
+    /**
+     * @brief Multiplies with the triangle on the left, T * B (TRMM)
+     *
+     * @param other matrix with N rows
+     * @return Matrix the product
+     */
+    Matrix operator*(Matrix &other);
+
+    /**
+     * @brief Solves T * X = B by substitution (TRSM), running blocks of the right
+     * hand sides in parallel
+     *
+     * @param b right hand sides with N rows
+     * @return Matrix the solution X
+     */
+    Matrix solve(Matrix &b);
+
+    /**
+     * @brief Decomposes an NxN matrix into packed L and U factors
+     *
+     * @param matrix matrix to decompose
+     * @return std::vector<TriangularMatrix> Vector containing the Lower(index0) and Upper(index1) factors
+     */
+    static std::vector<TriangularMatrix> decomposeLU(Matrix &matrix);
+};
+
+/**
+ * @brief An NxN symmetric matrix holding only its lower triangle, packed row by
+ * row in n * (n + 1) / 2 values, half the memory of a dense covariance matrix
+ *
+ */
+class SymmetricMatrix {
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int n;
+    /** Rows of the lower triangle one after another */
+    std::vector<double> packed;
+
+    public:
+    /**
+     * @brief Packs an NxN matrix that equals its transpose
+     *
+     * @param matrix symmetric matrix to copy
+     */
+    SymmetricMatrix(Matrix &matrix);
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int columns();
+
+    /**
+     * @brief Returns the value at a given row and column
+     *
+     * @param row row to access value from
+     * @param column column to access value from
+     * @return double value at the indices in the matrix
+     */
+    double access(int row, int column);
+
+    /**
+     * @brief Returns the filepath identifer of the matrix
+     *
+     * @return std::string containing the filepath
+     */
+    std::string getFilePath();
+
+    /**
+     * @brief Returns the matrix as a dense Matrix with both triangles filled in
+     *
+     * @return Matrix the NxN matrix
+     */
+    Matrix toMatrix();
+
+    /**
+     * @brief Multiplies with the symmetric matrix on the left, S * B (SYMM)
+     *
+     * @param other matrix with N rows
+     * @return Matrix the product
+     */
+    Matrix operator*(Matrix &other);
+
+    /**
+     * @brief Decomposes a positive definite matrix into L * L^T, working on the packed values
+     *
+     * @return TriangularMatrix the packed lower factor L
+     */
+    TriangularMatrix decomposeCholesky();
+
+    /**
+     * @brief Solves S * X = B for a positive definite matrix with its Cholesky factor
+     *
+     * @param b right hand sides with N rows
+     * @return Matrix the solution X
+     */
+    Matrix solve(Matrix &b);
+};
+
+/**
+ * @brief An NxN matrix whose values lie within kl diagonals below and ku
+ * diagonals above the main one, stored row by row as the kl + ku + 1 values
+ * of each row's band
+ *
+ */
+class BandedMatrix {
+    friend class TridiagonalMatrix;
+
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int n;
+    /** Number of diagonals below and above the main one */
+    int kl, ku;
+    /** Band of each row, value (i, j) at i * (kl + ku + 1) + j - i + kl */
+    std::vector<double> band;
+
+    /**
+     * @brief Solves A * X = B in place for r right hand sides stored row by row
+     */
+    void solveInPlace(int r, std::vector<double> &x);
+
+    public:
+    /**
+     * @brief Constructs a banded matrix of zeros without any dense storage
+     *
+     * @param size number of rows and columns
+     * @param lowerBandwidth number of diagonals below the main one
+     * @param upperBandwidth number of diagonals above the main one
+     */
+    BandedMatrix(int size, int lowerBandwidth, int upperBandwidth);
+
+    /**
+     * @brief Packs the band of an NxN matrix whose values outside it are zero
+     *
+     * @param matrix banded matrix to copy
+     * @param lowerBandwidth number of diagonals below the main one
+     * @param upperBandwidth number of diagonals above the main one
+     */
+    BandedMatrix(Matrix &matrix, int lowerBandwidth, int upperBandwidth);
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int columns();
+
+    /**
+     * @brief Returns the number of diagonals below the main one
+     *
+     * @return int lower bandwidth
+     */
+    int lowerBandwidth();
+
+    /**
+     * @brief Returns the number of diagonals above the main one
+     *
+     * @return int upper bandwidth
+     */
+    int upperBandwidth();
+
+    /**
+     * @brief Returns the value at a given row and column, 0 outside the band
+     *
+     * @param row row to access value from
+     * @param column column to access value from
+     * @return double value at the indices in the matrix
+     */
+    double access(int row, int column);
+
+    /**
+     * @brief Sets a value inside the band
+     *
+     * @param row row to set value in
+     * @param column column to set value in, within the band of the row
+     * @param value value to store at the indices
+     */
+    void set(int row, int column, double value);
+
+    /**
+     * @brief Returns the filepath identifer of the matrix
+     *
+     * @return std::string containing the filepath
+     */
+    std::string getFilePath();
+
+    /**
+     * @brief Returns the matrix as a dense Matrix, zeros included
+     *
+     * @return Matrix the NxN matrix
+     */
+    Matrix toMatrix();
+
+    /**
+     * @brief Multiplies with the banded matrix on the left, A * B
+     *
+     * @param other matrix with N rows
+     * @return Matrix the product
+     */
+    Matrix operator*(Matrix &other);
+
+    /**
+     * @brief Solves A * X = B with a banded LU decomposition with partial pivoting,
+     * whose upper factor widens to kl + ku diagonals
+     *
+     * @param b right hand sides with N rows
+     * @return Matrix the solution X
+     */
+    Matrix solve(Matrix &b);
+
+    /**
+     * @brief Solves A * x = b with a banded LU decomposition with partial pivoting
+     *
+     * @param b right hand side with N values
+     * @return Vector the solution x
+     */
+    Vector solve(Vector &b);
+};
+
+/**
+ * @brief An NxN tridiagonal matrix stored as its three diagonals, for systems
+ * with millions of unknowns that dense storage could never hold
+ *
+ */
+class TridiagonalMatrix {
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int n;
+    /** Diagonal below the main one, lower[i] at row i + 2 column i + 1 */
+    std::vector<double> lower;
+    /** Main diagonal */
+    std::vector<double> diagonal;
+    /** Diagonal above the main one, upper[i] at row i + 1 column i + 2 */
+    std::vector<double> upper;
+
+    public:
+    /**
+     * @brief Constructs a tridiagonal matrix from its three diagonals
+     *
+     * @param below the N - 1 values below the main diagonal
+     * @param main the N values of the main diagonal
+     * @param above the N - 1 values above the main diagonal
+     */
+    TridiagonalMatrix(Vector &below, Vector &main, Vector &above);
+
+    /**
+     * @brief Packs the diagonals of an NxN matrix whose other values are zero
+     *
+     * @param matrix tridiagonal matrix to copy
+     */
+    TridiagonalMatrix(Matrix &matrix);
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of rows and columns
+     *
+     * @return int size of the matrix
+     */
+    int columns();
+
+    /**
+     * @brief Returns the value at a given row and column, 0 off the three diagonals
+     *
+     * @param row row to access value from
+     * @param column column to access value from
+     * @return double value at the indices in the matrix
+     */
+    double access(int row, int column);
+
+    /**
+     * @brief Returns the filepath identifer of the matrix
+     *
+     * @return std::string containing the filepath
+     */
+    std::string getFilePath();
+
+    /**
+     * @brief Returns the matrix as a dense Matrix, zeros included
+     *
+     * @return Matrix the NxN matrix
+     */
+    Matrix toMatrix();
+
+    /**
+     * @brief Multiplies the matrix with a vector
+     *
+     * @param other vector with N values
+     * @return Vector the product
+     */
+    Vector operator*(Vector &other);
+
+    /**
+     * @brief Solves A * x = b in O(N) with the Thomas algorithm. There is no
+     * pivoting, which suits the diagonally dominant systems of PDEs and splines;
+     * other systems can use BandedMatrix with one diagonal on each side
+     *
+     * @param b right hand side with N values
+     * @return Vector the solution x
+     */
+    Vector solve(Vector &b);
+
+    /**
+     * @brief Solves A * x = b by splitting the rows into one block per thread
+     * (SPIKE). Each block is solved on its own along with the spikes coupling it
+     * to its neighbours, a small system over the block boundaries ties them
+     * together, and the blocks are then corrected in parallel. Small systems fall
+     * back to the Thomas algorithm
+     *
+     * @param b right hand side with N values
+     * @return Vector the solution x
+     */
+    Vector solveParallel(Vector &b);
+
+    /**
+     * @brief Solves many independent systems of the same size. The systems are
+     * interleaved so each step of the Thomas algorithm runs across a group of
+     * systems at once, and groups run in parallel
+     *
+     * @param systems tridiagonal matrices that all have the same size
+     * @param b one right hand side per system
+     * @return std::vector<Vector> one solution per system
+     */
+    static std::vector<Vector> solveBatch(std::vector<TridiagonalMatrix> &systems, std::vector<Vector> &b);
+};
+
+#endif
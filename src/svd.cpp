@@ -0,0 +1,168 @@
+#include<cmath>
+#include<limits>
+#include<random>
+#include<vector>
+#include<algorithm>
+#include"svd.hpp"
+#include"factorizations.hpp"
+#include"kernels.hpp"
+
+// Rows of the input read and multiplied together in each streamed block
+static const int STREAM_BLOCK = 256;
+// Sweeps of one-sided Jacobi allowed before accepting the result
+static const int JACOBI_SWEEPS = 60;
+// Seed of the Gaussian sketch, fixed so repeated runs agree
+static const unsigned int SKETCH_SEED = 5489u;
+
+//////////////////////////////////////////
+//  One-sided Jacobi
+//////////////////////////////////////////
+
+void jacobiSVD(int n, double *a, double *sigma, double *v) {
+    const double epsilon = std::numeric_limits<double>::epsilon();
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++) v[(long long) i * n + j] = i == j;
+    // Rotate pairs of columns until every pair is orthogonal
+    for(int sweep = 0; sweep < JACOBI_SWEEPS; sweep++) {
+        bool rotated = false;
+        for(int p = 0; p < n - 1; p++)
+            for(int q = p + 1; q < n; q++) {
+                double alpha = 0, beta = 0, gamma = 0;
+                for(int i = 0; i < n; i++) {
+                    double x = a[(long long) i * n + p], y = a[(long long) i * n + q];
+                    alpha += x * x;
+                    beta += y * y;
+                    gamma += x * y;
+                }
+                if(!(std::fabs(gamma) > epsilon * std::sqrt(alpha * beta))) continue;
+                rotated = true;
+                double zeta = (beta - alpha) / (2 * gamma);
+                double t = std::copysign(1.0, zeta) / (std::fabs(zeta) + std::sqrt(1 + zeta * zeta));
+                double c = 1 / std::sqrt(1 + t * t), s = c * t;
+                for(int i = 0; i < n; i++) {
+                    double *row = a + (long long) i * n;
+                    double x = row[p], y = row[q];
+                    row[p] = c * x - s * y;
+                    row[q] = s * x + c * y;
+                    row = v + (long long) i * n;
+                    x = row[p];
+                    y = row[q];
+                    row[p] = c * x - s * y;
+                    row[q] = s * x + c * y;
+                }
+            }
+        if(!rotated) break;
+    }
+    // The singular values are the column norms, normalizing leaves U
+    std::vector<double> norms(n), column(n);
+    for(int j = 0; j < n; j++) {
+        for(int i = 0; i < n; i++) column[i] = a[(long long) i * n + j];
+        norms[j] = vectorNorm(n, column.data());
+        if(norms[j] > 0)
+            for(int i = 0; i < n; i++) a[(long long) i * n + j] /= norms[j];
+    }
+    // Order the triplets by decreasing singular value
+    std::vector<int> order(n);
+    for(int j = 0; j < n; j++) order[j] = j;
+    std::stable_sort(order.begin(), order.end(), [&norms](int x, int y) { return norms[x] > norms[y]; });
+    std::vector<double> row(n);
+    for(int j = 0; j < n; j++) sigma[j] = norms[order[j]];
+    for(int i = 0; i < n; i++) {
+        for(int j = 0; j < n; j++) row[j] = a[(long long) i * n + order[j]];
+        std::copy(row.begin(), row.end(), a + (long long) i * n);
+        for(int j = 0; j < n; j++) row[j] = v[(long long) i * n + order[j]];
+        std::copy(row.begin(), row.end(), v + (long long) i * n);
+    }
+}
+
+//////////////////////////////////////////
+//  Randomized range finder
+//////////////////////////////////////////
+
+/**
+ * @brief Computes Y = A * X for the m x l matrix Y in one pass over the stream,
+ * adding the squared Frobenius norm of A to frobenius when it is given
+ */
+static void streamMultiply(MatrixStream &a, int l, const double *x, double *y, std::vector<double> &block, double *frobenius) {
+    int n = a.columns(), row = 0, count;
+    a.rewind();
+    while((count = a.read(STREAM_BLOCK, block.data())) > 0) {
+        if(frobenius) *frobenius += vectorDot(count * n, block.data(), block.data());
+        std::fill(y + (long long) row * l, y + (long long) (row + count) * l, 0.0);
+        gemm(count, l, n, block.data(), n, x, l, y + (long long) row * l, l, true);
+        row += count;
+    }
+}
+
+/**
+ * @brief Computes Z = A^T * Y for the n x l matrix Z in one pass over the stream
+ */
+static void streamMultiplyTranspose(MatrixStream &a, int l, const double *y, double *z, std::vector<double> &block) {
+    int n = a.columns(), row = 0, count;
+    std::vector<double> transposed((long long) n * STREAM_BLOCK);
+    std::fill(z, z + (long long) n * l, 0.0);
+    a.rewind();
+    while((count = a.read(STREAM_BLOCK, block.data())) > 0) {
+        // Each block contributes block^T * Y[rows of the block]
+        for(int i = 0; i < count; i++)
+            for(int j = 0; j < n; j++) transposed[(long long) j * count + i] = block[(long long) i * n + j];
+        gemm(n, l, count, transposed.data(), count, y + (long long) row * l, l, z, l, true);
+        row += count;
+    }
+}
+
+/**
+ * @brief Replaces the columns of a row-major m x l matrix with an orthonormal
+ * basis of their span, the thin Q of its QR factorization
+ */
+static void orthonormalize(int m, int l, double *y) {
+    std::vector<double> tau(l), q((long long) m * l);
+    qrFactor(m, l, y, tau.data());
+    qrFormQ(m, l, y, tau.data(), q.data());
+    std::copy(q.begin(), q.end(), y);
+}
+
+void randomizedSVD(MatrixStream &a, int k, int oversampling, int powerIterations, double *u, double *sigma, double *vt, double &error) {
+    int m = a.rows(), n = a.columns();
+    int l = std::min(k + oversampling, std::min(m, n));
+    // Gaussian test matrix
+    std::mt19937 generator(SKETCH_SEED);
+    std::normal_distribution<double> gaussian(0, 1);
+    std::vector<double> omega((long long) n * l);
+    for(long long i = 0; i < (long long) n * l; i++) omega[i] = gaussian(generator);
+    // Sample the range, Y = A * Omega, recording ||A||_F^2 on the way
+    std::vector<double> block((long long) STREAM_BLOCK * n), y((long long) m * l), z((long long) n * l);
+    double frobenius = 0;
+    streamMultiply(a, l, omega.data(), y.data(), block, &frobenius);
+    // Power iterations, Y = (A * A^T)^q * Y, orthonormalizing between products to keep small singular values
+    for(int iteration = 0; iteration < powerIterations; iteration++) {
+        orthonormalize(m, l, y.data());
+        streamMultiplyTranspose(a, l, y.data(), z.data(), block);
+        orthonormalize(n, l, z.data());
+        streamMultiply(a, l, z.data(), y.data(), block, 0);
+    }
+    // Q spans the sampled range, B^T = A^T * Q is the projected problem
+    orthonormalize(m, l, y.data());
+    streamMultiplyTranspose(a, l, y.data(), z.data(), block);
+    // B^T = Qb * Rb, so B = Rb^T * Qb^T and only the l x l matrix Rb^T needs an SVD
+    std::vector<double> tau(l), qb((long long) n * l), small((long long) l * l), values(l), vr((long long) l * l);
+    qrFactor(n, l, z.data(), tau.data());
+    for(int i = 0; i < l; i++)
+        for(int j = 0; j < l; j++) small[(long long) i * l + j] = i >= j ? z[(long long) j * l + i] : 0;
+    qrFormQ(n, l, z.data(), tau.data(), qb.data());
+    jacobiSVD(l, small.data(), values.data(), vr.data());
+    // U = Q * Ur and V = Qb * Vr, truncated to k columns
+    std::fill(u, u + (long long) m * k, 0.0);
+    gemm(m, k, l, y.data(), l, small.data(), l, u, k, true);
+    std::vector<double> v((long long) n * k, 0);
+    gemm(n, k, l, qb.data(), l, vr.data(), l, v.data(), k, true);
+    for(int i = 0; i < k; i++)
+        for(int j = 0; j < n; j++) vt[(long long) i * n + j] = v[(long long) j * k + i];
+    // U * Sigma * V^T is the projection of A onto span(U), so the residual is what remains of ||A||_F^2
+    double captured = 0;
+    for(int i = 0; i < k; i++) {
+        sigma[i] = values[i];
+        captured += values[i] * values[i];
+    }
+    error = std::sqrt(std::fmax(frobenius - captured, 0.0));
+}
@@ -0,0 +1,36 @@
+#include"matrixstream.hpp"
+#ifndef SVD_HPP
+#define SVD_HPP
+
+/**
+ * @brief Computes the singular value decomposition of a row-major n x n matrix
+ * with one-sided Jacobi rotations, which is accurate but only meant for the
+ * small matrices left over by the randomized method
+ *
+ * @param n order of the matrix
+ * @param a pointer to the matrix, overwritten with the left singular vectors as columns
+ * @param sigma receives the singular values in descending order
+ * @param v pointer to the row-major n x n output whose columns receive the right singular vectors
+ */
+void jacobiSVD(int n, double *a, double *sigma, double *v);
+
+/**
+ * @brief Computes a rank k approximation A ~ U * Sigma * V^T with the randomized
+ * range finder. A Gaussian sketch of k + oversampling columns is multiplied by A,
+ * sharpened by power iterations that alternate with A^T and are re-orthonormalized
+ * by QR, and the small projected problem is solved exactly. The input is read in
+ * exactly 2 * powerIterations + 2 passes, so it may be streamed from a file. The
+ * sketch uses a fixed seed so results are reproducible
+ *
+ * @param a stream over the m x n input
+ * @param k rank of the approximation, between 1 and min(m, n)
+ * @param oversampling extra sketch columns, clamped so the sketch fits the matrix
+ * @param powerIterations number of power iterations
+ * @param u pointer to the row-major m x k output for U
+ * @param sigma receives the k singular values in descending order
+ * @param vt pointer to the row-major k x n output for V^T
+ * @param error receives the Frobenius norm of A - U * Sigma * V^T, from ||A||_F^2 - sum sigma^2
+ */
+void randomizedSVD(MatrixStream &a, int k, int oversampling, int powerIterations, double *u, double *sigma, double *vt, double &error);
+
+#endif
@@ -0,0 +1,263 @@
+#include<string>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<fstream>
+#include<sstream>
+#include<algorithm>
+#include<unistd.h>
+#include"topology.hpp"
+#ifdef __linux__
+#include<sched.h>
+#include<pthread.h>
+#include<dirent.h>
+#include<sys/syscall.h>
+#endif
+
+#ifdef __linux__
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#define MPOL_INTERLEAVE 3
+#endif
+#ifndef MPOL_DEFAULT
+#define MPOL_DEFAULT 0
+#endif
+#ifndef MPOL_F_NODE
+#define MPOL_F_NODE (1 << 0)
+#define MPOL_F_ADDR (1 << 1)
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+#endif
+
+// Nodes a policy's node mask can name, at least as many as the kernel supports
+static const int MASK_NODES = 1024;
+
+namespace {
+    std::once_flag discovered;
+    std::vector<NumaNode> nodes;
+    std::mutex policyLock;
+    MemoryPolicy policy = FIRST_TOUCH;
+    int boundNode = 0;
+    std::once_flag described;
+    std::vector<long long> caches;
+    std::string model = "unknown";
+
+    /**
+     * @brief Reads the active policy, false under FIRST_TOUCH
+     */
+    bool activePolicy(MemoryPolicy &current, int &node) {
+        std::lock_guard<std::mutex> guard(policyLock);
+        current = policy;
+        node = boundNode;
+        return current != FIRST_TOUCH;
+    }
+
+    /**
+     * @brief Parses a list of cores such as "0-3,8,10-11"
+     */
+    std::vector<int> parseList(std::string list) {
+        std::vector<int> cpus;
+        std::stringstream ranges(list);
+        std::string range;
+        while(std::getline(ranges, range, ',')) {
+            if(range.empty() || !isdigit(range[0])) continue;
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for(int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    void discover() {
+        #ifdef __linux__
+        DIR *directory = opendir("/sys/devices/system/node");
+        if(directory != NULL) {
+            while(dirent *entry = readdir(directory)) {
+                std::string name = entry->d_name;
+                if(name.compare(0, 4, "node") != 0 || name.size() == 4 || !isdigit(name[4])) continue;
+                std::ifstream file("/sys/devices/system/node/" + name + "/cpulist");
+                std::string list;
+                if(!std::getline(file, list)) continue;
+                NumaNode node = {std::stoi(name.substr(4)), parseList(list)};
+                // Nodes holding only memory have no cores to schedule on
+                if(!node.cpus.empty()) nodes.push_back(node);
+            }
+            closedir(directory);
+        }
+        #endif
+        std::sort(nodes.begin(), nodes.end(), [](const NumaNode &a, const NumaNode &b) { return a.id < b.id; });
+        if(nodes.empty()) {
+            NumaNode node = {0, std::vector<int>()};
+            int count = std::max(1u, std::thread::hardware_concurrency());
+            for(int cpu = 0; cpu < count; cpu++) node.cpus.push_back(cpu);
+            nodes.push_back(node);
+        }
+    }
+
+    /**
+     * @brief Parses a cache size such as "32K" or "1M" into bytes
+     */
+    long long parseSize(std::string size) {
+        if(size.empty() || !isdigit(size[0])) return 0;
+        long long bytes = std::stoll(size);
+        char unit = size[size.size() - 1];
+        if(unit == 'K') bytes <<= 10;
+        if(unit == 'M') bytes <<= 20;
+        if(unit == 'G') bytes <<= 30;
+        return bytes;
+    }
+
+    void describe() {
+        caches.assign(4, 0);
+        #ifdef __linux__
+        // Each index directory holds one cache of the first core, instruction caches skipped
+        for(int index = 0; index < 8; index++) {
+            std::string path = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+            std::ifstream levelFile(path + "level"), typeFile(path + "type"), sizeFile(path + "size");
+            int level;
+            std::string type, size;
+            if(!(levelFile >> level) || !(typeFile >> type) || !(sizeFile >> size)) continue;
+            if(type == "Instruction" || level < 1 || level > 3) continue;
+            caches[level] = parseSize(size);
+        }
+        std::ifstream info("/proc/cpuinfo");
+        std::string line;
+        while(std::getline(info, line)) {
+            if(line.compare(0, 10, "model name") != 0) continue;
+            size_t colon = line.find(':');
+            if(colon == std::string::npos) continue;
+            size_t start = line.find_first_not_of(" \t", colon + 1);
+            if(start != std::string::npos) model = line.substr(start);
+            break;
+        }
+        #endif
+    }
+}
+
+std::vector<NumaNode> getTopology() {
+    std::call_once(discovered, discover);
+    return nodes;
+}
+
+int currentNode() {
+    std::call_once(discovered, discover);
+    #ifdef __linux__
+    int cpu = sched_getcpu();
+    for(int i = 0; i < nodes.size(); i++)
+        if(std::find(nodes[i].cpus.begin(), nodes[i].cpus.end(), cpu) != nodes[i].cpus.end()) return nodes[i].id;
+    #endif
+    return nodes[0].id;
+}
+
+bool pinThread(int cpu) {
+    #ifdef __linux__
+    if(cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    #else
+    return false;
+    #endif
+}
+
+void unpinThread() {
+    #ifdef __linux__
+    std::call_once(discovered, discover);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int i = 0; i < nodes.size(); i++)
+        for(int j = 0; j < nodes[i].cpus.size(); j++)
+            if(nodes[i].cpus[j] < CPU_SETSIZE) CPU_SET(nodes[i].cpus[j], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    #endif
+}
+
+void setMemoryPolicy(MemoryPolicy memoryPolicy, int node) {
+    std::lock_guard<std::mutex> guard(policyLock);
+    policy = memoryPolicy;
+    boundNode = node;
+}
+
+MemoryPolicy getMemoryPolicy() {
+    std::lock_guard<std::mutex> guard(policyLock);
+    return policy;
+}
+
+#ifdef __linux__
+/**
+ * @brief Returns the mask of nodes a policy places pages on, one bit per node
+ */
+static std::vector<unsigned long> nodeMask(MemoryPolicy current, int node) {
+    std::call_once(discovered, discover);
+    const int BITS = 8 * sizeof(unsigned long);
+    std::vector<int> chosen(1, node);
+    if(current == INTERLEAVE) {
+        chosen.clear();
+        for(int i = 0; i < nodes.size(); i++) chosen.push_back(nodes[i].id);
+    }
+    std::vector<unsigned long> mask(MASK_NODES / BITS, 0);
+    for(int i = 0; i < chosen.size(); i++)
+        if(chosen[i] >= 0 && chosen[i] < MASK_NODES) mask[chosen[i] / BITS] |= 1ul << (chosen[i] % BITS);
+    return mask;
+}
+#endif
+
+void placeMemory(double *data, long long count) {
+    MemoryPolicy current;
+    int node;
+    if(!activePolicy(current, node) || count <= 0) return;
+    #ifdef __linux__
+    // Only pages lying wholly inside the buffer move, neighbouring data keeps its place
+    unsigned long page = sysconf(_SC_PAGESIZE);
+    unsigned long start = ((unsigned long) data + page - 1) / page * page;
+    unsigned long end = ((unsigned long) (data + count)) / page * page;
+    if(start >= end) return;
+    std::vector<unsigned long> mask = nodeMask(current, node);
+    // Placement is a hint, a kernel refusing it leaves the pages where they are
+    syscall(SYS_mbind, start, end - start, current == BIND ? MPOL_BIND : MPOL_INTERLEAVE, mask.data(), (unsigned long) MASK_NODES + 1, MPOL_MF_MOVE);
+    #endif
+}
+
+PlacementScope::PlacementScope() {
+    applied = false;
+    previousMode = 0;
+    MemoryPolicy current;
+    int node;
+    if(!activePolicy(current, node)) return;
+    #ifdef __linux__
+    // Remember the thread's policy, then have its new pages placed by ours
+    previousNodes.assign(MASK_NODES / (8 * sizeof(unsigned long)), 0);
+    if(syscall(SYS_get_mempolicy, &previousMode, previousNodes.data(), (unsigned long) MASK_NODES + 1, NULL, 0) != 0) return;
+    std::vector<unsigned long> mask = nodeMask(current, node);
+    // Placement is a hint, a kernel refusing it leaves pages to first touch
+    applied = syscall(SYS_set_mempolicy, current == BIND ? MPOL_BIND : MPOL_INTERLEAVE, mask.data(), (unsigned long) MASK_NODES + 1) == 0;
+    #endif
+}
+
+PlacementScope::~PlacementScope() {
+    #ifdef __linux__
+    if(applied) syscall(SYS_set_mempolicy, previousMode, previousMode == MPOL_DEFAULT ? NULL : previousNodes.data(), previousMode == MPOL_DEFAULT ? 0ul : (unsigned long) MASK_NODES + 1);
+    #endif
+}
+
+int pageNode(const void *address) {
+    #ifdef __linux__
+    int node = -1;
+    if(syscall(SYS_get_mempolicy, &node, NULL, 0ul, address, MPOL_F_NODE | MPOL_F_ADDR) == 0) return node;
+    #endif
+    return -1;
+}
+
+long long cacheSize(int level) {
+    std::call_once(described, describe);
+    return level >= 1 && level <= 3 ? caches[level] : 0;
+}
+
+std::string cpuModel() {
+    std::call_once(described, describe);
+    return model;
+}
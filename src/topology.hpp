@@ -0,0 +1,133 @@
+#include<vector>
+#include<string>
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+/**
+ * @brief A NUMA node, a group of cores sharing a memory controller
+ *
+ */
+struct NumaNode {
+    /** Number of the node as reported by the system */
+    int id;
+    /** Cores attached to the node */
+    std::vector<int> cpus;
+};
+
+/**
+ * @brief Where the pages of newly built matrices are placed
+ *
+ */
+enum MemoryPolicy {
+    /** Pages land on the node of the thread that first writes them, the system default */
+    FIRST_TOUCH,
+    /** Pages are spread round robin over every node */
+    INTERLEAVE,
+    /** Pages are placed on one chosen node */
+    BIND
+};
+
+/**
+ * @brief Returns the NUMA nodes of the machine with their cores, read once from
+ * the system. Machines without NUMA information report one node holding every core
+ *
+ * @return std::vector<NumaNode> nodes ordered by id
+ */
+std::vector<NumaNode> getTopology();
+
+/**
+ * @brief Returns the NUMA node of the core the calling thread is running on
+ *
+ * @return int id of the node
+ */
+int currentNode();
+
+/**
+ * @brief Restricts the calling thread to one core
+ *
+ * @param cpu core to run on
+ * @return true if the system accepted the restriction
+ */
+bool pinThread(int cpu);
+
+/**
+ * @brief Lets the calling thread run on every core again
+ *
+ */
+void unpinThread();
+
+/**
+ * @brief Sets where the pages of newly built matrices are placed
+ *
+ * @param policy placement policy
+ * @param node node to bind to, used by BIND only
+ */
+void setMemoryPolicy(MemoryPolicy policy, int node = 0);
+
+/**
+ * @brief Returns where the pages of newly built matrices are placed
+ *
+ * @return MemoryPolicy placement policy
+ */
+MemoryPolicy getMemoryPolicy();
+
+/**
+ * @brief Applies the memory policy to a buffer that already exists, moving the
+ * whole pages it spans. Under FIRST_TOUCH nothing moves, since placement follows
+ * whichever thread wrote the buffer first. Buffers being built should be placed
+ * with a PlacementScope instead, which places their pages as they are first touched
+ *
+ * @param data start of the buffer
+ * @param count number of values in the buffer
+ */
+void placeMemory(double *data, long long count);
+
+/**
+ * @brief Gives the calling thread the memory policy while the scope lives, so the
+ * pages it first touches meanwhile are placed by the policy as they are faulted
+ * in, whatever the size of the buffers they hold. The thread's own policy is
+ * restored when the scope ends. Under FIRST_TOUCH it does nothing
+ *
+ */
+class PlacementScope {
+    private:
+    /** Whether the thread's policy was changed and must be restored */
+    bool applied;
+    /** Mode and nodes of the thread's policy before the scope */
+    int previousMode;
+    std::vector<unsigned long> previousNodes;
+
+    public:
+    PlacementScope();
+    ~PlacementScope();
+    PlacementScope(const PlacementScope &other) = delete;
+    PlacementScope &operator=(const PlacementScope &other) = delete;
+};
+
+/**
+ * @brief Returns the NUMA node holding the page of an address, faulting the page
+ * in if no thread has touched it yet
+ *
+ * @param address address inside the page
+ * @return int id of the node, or -1 when the system does not report it
+ */
+int pageNode(const void *address);
+
+/**
+ * @brief Returns the size of the data cache at one level of the first core's
+ * hierarchy, read once from the system
+ *
+ * @param level cache level, 1 for the closest to the core
+ * @return long long size in bytes, or 0 when the system does not report it
+ */
+long long cacheSize(int level);
+
+/**
+ * @brief Returns the model name the processor reports, which identifies machines
+ * that share a tuning
+ *
+ * @return std::string model name, or "unknown" when the system does not report it
+ */
+std::string cpuModel();
+
+#endif
@@ -0,0 +1,139 @@
+#include<string>
+#include<vector>
+#include<cstdlib>
+#include<exception>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/wait.h>
+#include<sys/socket.h>
+#include"transport.hpp"
+#include"logger.hpp"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/**
+ * @brief Writes or reads exactly count bytes, returning false if the peer went away
+ */
+static bool transfer(int socket, char *data, size_t count, bool writing) {
+    for(size_t done = 0; done < count;) {
+        ssize_t moved = writing ? ::send(socket, data + done, count - done, MSG_NOSIGNAL) : recv(socket, data + done, count - done, 0);
+        if(moved <= 0) return false;
+        done += moved;
+    }
+    return true;
+}
+
+SocketTransport::SocketTransport(int rank, std::vector<int> sockets) {
+    me = rank;
+    peers = sockets;
+}
+
+SocketTransport::~SocketTransport() {
+    for(int i = 0; i < peers.size(); i++)
+        if(peers[i] >= 0) close(peers[i]);
+}
+
+int SocketTransport::rank() {
+    return me;
+}
+
+int SocketTransport::size() {
+    return peers.size();
+}
+
+void SocketTransport::send(int destination, const std::vector<double> &values) {
+    // Each message is its length followed by its values
+    unsigned long long count = values.size();
+    if(destination < 0 || destination >= peers.size() || peers[destination] < 0) Logger::logInvalidDistribution("process " + std::to_string(destination));
+    if(!transfer(peers[destination], (char*) &count, sizeof(count), true) || !transfer(peers[destination], (char*) values.data(), count * sizeof(double), true))
+        Logger::logInvalidDistribution("process " + std::to_string(destination));
+}
+
+void SocketTransport::receive(int source, std::vector<double> &values) {
+    unsigned long long count;
+    if(source < 0 || source >= peers.size() || peers[source] < 0) Logger::logInvalidDistribution("process " + std::to_string(source));
+    if(!transfer(peers[source], (char*) &count, sizeof(count), false)) Logger::logInvalidDistribution("process " + std::to_string(source));
+    values.resize(count);
+    if(!transfer(peers[source], (char*) values.data(), count * sizeof(double), false)) Logger::logInvalidDistribution("process " + std::to_string(source));
+}
+
+std::string SocketTransport::workerPath() {
+    const char *path = std::getenv("MATRIX_WORKER");
+    return path != NULL && path[0] != '\0' ? path : "bin/matrixworker";
+}
+
+void SocketTransport::launch(int processes, std::vector<std::string> arguments, std::function<void(Transport&)> body) {
+    if(processes < 1) Logger::logInvalidDistribution("a group of " + std::to_string(processes) + " processes");
+    std::string program = workerPath();
+    if(processes > 1 && access(program.c_str(), X_OK) != 0) Logger::logInvalidDistribution(program);
+    // Connect every two ranks with a socket pair, closed on exec unless a worker keeps it
+    std::vector<std::vector<int>> ends(processes, std::vector<int>(processes, -1));
+    for(int i = 0; i < processes; i++)
+        for(int j = i + 1; j < processes; j++) {
+            int pair[2];
+            if(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) pair[0] = pair[1] = -1;
+            for(int e = 0; e < 2; e++)
+                if(pair[e] >= 0) fcntl(pair[e], F_SETFD, FD_CLOEXEC);
+            ends[i][j] = pair[0];
+            ends[j][i] = pair[1];
+        }
+    std::vector<pid_t> children;
+    for(int rank = 1; rank < processes; rank++) {
+        // Build the command line first, since the child may only make async-signal-safe calls
+        std::vector<std::string> words = {program, std::to_string(rank), std::to_string(processes)};
+        for(int q = 0; q < processes; q++) words.push_back(std::to_string(ends[rank][q]));
+        words.insert(words.end(), arguments.begin(), arguments.end());
+        std::vector<char*> argv;
+        for(int w = 0; w < words.size(); w++) argv.push_back(&words[w][0]);
+        argv.push_back(NULL);
+        const int *kept = ends[rank].data();
+        pid_t child = fork();
+        if(child == 0) {
+            // Keep this rank's sockets open across the exec, which closes every other one
+            for(int q = 0; q < processes; q++)
+                if(kept[q] >= 0) fcntl(kept[q], F_SETFD, 0);
+            execv(argv[0], argv.data());
+            _exit(127);
+        }
+        if(child > 0) children.push_back(child);
+    }
+    // Rank 0 runs in this process, its peers' sockets belong to the children
+    for(int r = 1; r < processes; r++)
+        for(int q = 0; q < processes; q++)
+            if(ends[r][q] >= 0) close(ends[r][q]);
+    std::exception_ptr error;
+    try {
+        SocketTransport transport(0, ends[0]);
+        if(children.size() != processes - 1) Logger::logInvalidDistribution("a group of " + std::to_string(processes) + " processes");
+        body(transport);
+    } catch(...) {
+        error = std::current_exception();
+    }
+    // The sockets of rank 0 are closed by now, so no child waits on it forever
+    bool succeeded = true;
+    for(int i = 0; i < children.size(); i++) {
+        int status;
+        if(waitpid(children[i], &status, 0) != children[i] || !WIFEXITED(status) || WEXITSTATUS(status) != 0) succeeded = false;
+    }
+    if(error) std::rethrow_exception(error);
+    if(!succeeded) Logger::logInvalidDistribution("a group of " + std::to_string(processes) + " processes");
+}
+
+int SocketTransport::work(int argc, char **argv, std::function<void(Transport&, std::vector<std::string>&)> body) {
+    // The command line holds the rank, the group size, a socket per rank and then the arguments
+    if(argc < 3) return 2;
+    int rank = std::atoi(argv[1]), processes = std::atoi(argv[2]);
+    if(processes < 2 || rank < 1 || rank >= processes || argc < 3 + processes) return 2;
+    std::vector<int> sockets;
+    for(int q = 0; q < processes; q++) sockets.push_back(std::atoi(argv[3 + q]));
+    std::vector<std::string> arguments(argv + 3 + processes, argv + argc);
+    try {
+        SocketTransport transport(rank, sockets);
+        body(transport, arguments);
+    } catch(...) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include<string>
+#include<vector>
+#include<functional>
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+/**
+ * @brief Point to point messaging between the processes of a group, numbered
+ * 0 to size() - 1. Messages between two processes arrive in the order they were
+ * sent. Implement this to run distributed operations over another interconnect
+ *
+ */
+class Transport {
+    public:
+    virtual ~Transport() {}
+
+    /**
+     * @brief Returns the number of this process within the group
+     *
+     * @return int rank of this process
+     */
+    virtual int rank() = 0;
+
+    /**
+     * @brief Returns the number of processes in the group
+     *
+     * @return int size of the group
+     */
+    virtual int size() = 0;
+
+    /**
+     * @brief Sends values to another process
+     *
+     * @param destination rank to send to
+     * @param values values to send
+     */
+    virtual void send(int destination, const std::vector<double> &values) = 0;
+
+    /**
+     * @brief Receives the next values sent by another process
+     *
+     * @param source rank to receive from
+     * @param values receives the values
+     */
+    virtual void receive(int source, std::vector<double> &values) = 0;
+};
+
+/**
+ * @brief Transport between processes on one machine, connecting every two
+ * processes of the group with a Unix domain socket pair
+ *
+ */
+class SocketTransport : public Transport {
+    private:
+    /** Rank of this process */
+    int me;
+    /** Socket connected to each rank, -1 for this one */
+    std::vector<int> peers;
+
+    public:
+    /**
+     * @brief Wraps connected sockets, closing them when destroyed
+     *
+     * @param rank rank of this process
+     * @param sockets socket connected to each rank, -1 for this one
+     */
+    SocketTransport(int rank, std::vector<int> sockets);
+
+    /**
+     * @brief Closes the sockets, which ends the receives of every peer still waiting on this process
+     *
+     */
+    ~SocketTransport();
+
+    int rank();
+    int size();
+    void send(int destination, const std::vector<double> &values);
+    void receive(int source, std::vector<double> &values);
+
+    /**
+     * @brief Starts a group of processes. The calling process is rank 0 and runs
+     * body, while every other rank is a fresh process running the worker
+     * executable, which hands the arguments to SocketTransport::work. Workers are
+     * executed rather than forked copies of this process, since locks held by
+     * other threads at the fork would stay locked in the copy. Errors thrown by
+     * rank 0 are thrown again once every other process has exited
+     *
+     * @param processes number of processes in the group
+     * @param arguments arguments telling the workers what to run
+     * @param body function run by rank 0 with its transport
+     */
+    static void launch(int processes, std::vector<std::string> arguments, std::function<void(Transport&)> body);
+
+    /**
+     * @brief Runs one rank of a group started by launch, the entry point of the
+     * worker executable. Connects to the group through the sockets named on the
+     * command line and runs body with the arguments given to launch
+     *
+     * @param argc number of command line arguments
+     * @param argv command line arguments given by launch
+     * @param body function run with the transport and the arguments
+     * @return int exit code, 0 if body returned, 1 if it threw and 2 if the
+     * command line did not come from launch
+     */
+    static int work(int argc, char **argv, std::function<void(Transport&, std::vector<std::string>&)> body);
+
+    /**
+     * @brief Returns the worker executable launch runs, named by the MATRIX_WORKER
+     * environment variable, or bin/matrixworker when it is not set
+     *
+     * @return std::string filepath of the worker executable
+     */
+    static std::string workerPath();
+};
+
+#endif
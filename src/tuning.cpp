@@ -0,0 +1,137 @@
+#include<string>
+#include<mutex>
+#include<fstream>
+#include<cstdlib>
+#include<cmath>
+#include<algorithm>
+#include<cctype>
+#include"tuning.hpp"
+#include"topology.hpp"
+
+namespace {
+    std::once_flag loaded;
+    std::mutex profileLock;
+    TuningProfile active;
+
+    /**
+     * @brief Returns the largest power of two at or below a value, kept within bounds
+     */
+    int powerBelow(double value, int lowest, int highest) {
+        int result = lowest;
+        while(result * 2 <= value && result * 2 <= highest) result *= 2;
+        return result;
+    }
+
+    /**
+     * @brief Raises or lowers each value into the range its kernel can use
+     */
+    TuningProfile clamp(TuningProfile profile) {
+        profile.rowBlock = std::min(std::max(profile.rowBlock, 1), 4096);
+        profile.depthBlock = std::min(std::max(profile.depthBlock, 8), 4096);
+        profile.columnBlock = std::min(std::max(profile.columnBlock, 8), 16384);
+        profile.strassenCrossover = std::max(profile.strassenCrossover, 16);
+        profile.luBlock = std::min(std::max(profile.luBlock, 1), 1024);
+        profile.luTile = std::min(std::max(profile.luTile, 8), 16384);
+        profile.transposeBlock = std::min(std::max(profile.transposeBlock, 4), 1024);
+        profile.parallelValues = std::max(profile.parallelValues, 1);
+        return profile;
+    }
+
+    /**
+     * @brief Reads the parameters a profile file holds into a profile, each line a
+     * parameter name and its value with anything else skipped
+     */
+    bool readProfile(std::string filepath, TuningProfile &profile) {
+        std::ifstream file(filepath);
+        if(!file.good()) return false;
+        std::string key;
+        while(file >> key) {
+            int value;
+            if(key == "model" || !(file >> value)) {
+                file.clear();
+                std::getline(file, key);
+                continue;
+            }
+            if(key == "rowBlock") profile.rowBlock = value;
+            else if(key == "depthBlock") profile.depthBlock = value;
+            else if(key == "columnBlock") profile.columnBlock = value;
+            else if(key == "strassenCrossover") profile.strassenCrossover = value;
+            else if(key == "luBlock") profile.luBlock = value;
+            else if(key == "luTile") profile.luTile = value;
+            else if(key == "transposeBlock") profile.transposeBlock = value;
+            else if(key == "parallelValues") profile.parallelValues = value;
+        }
+        return true;
+    }
+
+    void load() {
+        // The machine's profile file overrides whatever the cache sizes suggest
+        active = defaultTuningProfile();
+        readProfile(tuningProfilePath(), active);
+        active = clamp(active);
+    }
+}
+
+TuningProfile defaultTuningProfile() {
+    // The constants the kernels were first written with
+    TuningProfile profile = {64, 256, 512, 512, 64, 256, 32, 1 << 15};
+    long long l1 = cacheSize(1), l2 = cacheSize(2);
+    // A depth x width panel of B with width twice the depth fills half of L2
+    if(l2 > 0) {
+        profile.depthBlock = powerBelow(std::sqrt(l2 / 2.0 / sizeof(double) / 2), 64, 512);
+        profile.columnBlock = 2 * profile.depthBlock;
+        profile.luTile = profile.depthBlock;
+    }
+    // A tile being read and a tile being written fill L1 between them
+    if(l1 > 0) profile.transposeBlock = powerBelow(std::sqrt(l1 / 2.0 / sizeof(double)), 8, 128);
+    return profile;
+}
+
+TuningProfile getTuningProfile() {
+    std::call_once(loaded, load);
+    std::lock_guard<std::mutex> guard(profileLock);
+    return active;
+}
+
+void setTuningProfile(TuningProfile profile) {
+    std::call_once(loaded, load);
+    std::lock_guard<std::mutex> guard(profileLock);
+    active = clamp(profile);
+}
+
+std::string tuningProfilePath() {
+    const char *directory = std::getenv("MATRIX_TUNING_DIR");
+    std::string path = directory != NULL && directory[0] != '\0' ? directory : "tuning";
+    if(path[path.size() - 1] != '/') path += '/';
+    // Keep letters and digits of the model name, joining the rest with underscores
+    std::string name;
+    for(char c : cpuModel()) {
+        if(isalnum((unsigned char) c)) name += c;
+        else if(!name.empty() && name[name.size() - 1] != '_') name += '_';
+    }
+    while(!name.empty() && name[name.size() - 1] == '_') name.erase(name.size() - 1);
+    return path + (name.empty() ? "unknown" : name) + ".profile";
+}
+
+bool loadTuningProfile(std::string filepath) {
+    TuningProfile profile = getTuningProfile();
+    if(!readProfile(filepath, profile)) return false;
+    setTuningProfile(profile);
+    return true;
+}
+
+bool saveTuningProfile(std::string filepath) {
+    TuningProfile profile = getTuningProfile();
+    std::ofstream file(filepath);
+    if(!file.good()) return false;
+    file << "model " << cpuModel() << "\n";
+    file << "rowBlock " << profile.rowBlock << "\n";
+    file << "depthBlock " << profile.depthBlock << "\n";
+    file << "columnBlock " << profile.columnBlock << "\n";
+    file << "strassenCrossover " << profile.strassenCrossover << "\n";
+    file << "luBlock " << profile.luBlock << "\n";
+    file << "luTile " << profile.luTile << "\n";
+    file << "transposeBlock " << profile.transposeBlock << "\n";
+    file << "parallelValues " << profile.parallelValues << "\n";
+    return file.good();
+}
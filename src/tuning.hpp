@@ -0,0 +1,80 @@
+#include<string>
+#ifndef TUNING_HPP
+#define TUNING_HPP
+
+/**
+ * @brief Machine dependent parameters of the dense kernels. The active profile is
+ * read from the machine's profile file the first time a kernel asks for it, and
+ * derived from the cache sizes when no such file exists
+ *
+ */
+struct TuningProfile {
+    /** Rows of C handed to one thread by the blocked multiply */
+    int rowBlock;
+    /** Depth of the shared dimension the blocked multiply keeps in cache at once */
+    int depthBlock;
+    /** Columns of C the blocked multiply updates from one row of B */
+    int columnBlock;
+    /** Size at or below which Strassen-Winograd hands products to the blocked multiply */
+    int strassenCrossover;
+    /** Columns factored together in each panel of the blocked LU decomposition */
+    int luBlock;
+    /** Columns of the trailing matrix the LU decomposition updates together */
+    int luTile;
+    /** Rows and columns of the square tiles a transpose copies at once */
+    int transposeBlock;
+    /** Fewest values an elementwise operation hands to another thread */
+    int parallelValues;
+};
+
+/**
+ * @brief Returns the active profile, loading the machine's profile file or
+ * deriving one from the cache sizes on first use
+ *
+ * @return TuningProfile the active profile
+ */
+TuningProfile getTuningProfile();
+
+/**
+ * @brief Makes a profile the active one. Values outside the range a kernel can use
+ * are raised or lowered into it
+ *
+ * @param profile profile to use
+ */
+void setTuningProfile(TuningProfile profile);
+
+/**
+ * @brief Derives a profile from the cache sizes the system reports, falling back to
+ * fixed values for caches it does not report
+ *
+ * @return TuningProfile the derived profile
+ */
+TuningProfile defaultTuningProfile();
+
+/**
+ * @brief Returns where the profile of this machine's processor model is kept, the
+ * model name made safe for a filename inside the directory named by the
+ * MATRIX_TUNING_DIR environment variable, or tuning/ when it is not set
+ *
+ * @return std::string path of the profile file
+ */
+std::string tuningProfilePath();
+
+/**
+ * @brief Reads a profile file and makes it the active profile. Parameters missing
+ * from the file keep their active values
+ *
+ * @param filepath path of the profile file
+ * @return true if the file was read, false if it could not be opened
+ */
+bool loadTuningProfile(std::string filepath);
+
+/**
+ * @brief Writes the active profile to a file along with the processor model
+ *
+ * @param filepath path of the profile file, whose directory must exist
+ * @return true if the file was written
+ */
+bool saveTuningProfile(std::string filepath);
+
+#endif
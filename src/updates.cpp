@@ -0,0 +1,460 @@
+#include<cmath>
+#include<string>
+#include<vector>
+#include<utility>
+#include<algorithm>
+#include"updates.hpp"
+#include"kernels.hpp"
+#include"factorizations.hpp"
+
+// Fraction of its scale a pivot or capacitance may shrink to before an update counts as a breakdown
+static const double BREAKDOWN = 1e-8;
+// Largest multiplier an updated LU factor may hold before its pivot order is refreshed
+static const double GROWTH = 1e4;
+
+/**
+ * @brief Returns pointers to the start of each row of a row-major matrix
+ */
+static std::vector<double*> rowsOf(int m, int n, double *a) {
+    std::vector<double*> rows(m);
+    for(int i = 0; i < m; i++) rows[i] = a + (long long) i * n;
+    return rows;
+}
+
+/**
+ * @brief Computes the rotation [c s; -s c] taking (x, y) to (r, 0)
+ */
+static void givens(double x, double y, double &c, double &s) {
+    double r = std::hypot(x, y);
+    c = r == 0 ? 1 : x / r;
+    s = r == 0 ? 0 : y / r;
+}
+
+//////////////////////////////////////////
+//  Sherman-Morrison-Woodbury inverses
+//////////////////////////////////////////
+
+UpdatableInverse::UpdatableInverse(Matrix &matrix) {
+    if(matrix.m != matrix.n) Logger::logInvalidInverse(matrix.fp);
+    fp = matrix.fp;
+    n = matrix.n;
+    a = matrix.flatten();
+    recomputed = 0;
+    if(!invert()) Logger::logInvalidInverse(fp);
+}
+
+bool UpdatableInverse::invert() {
+    std::vector<double> work = a;
+    std::vector<int> perm(n);
+    if(!luFactor(n, work.data(), perm.data())) return false;
+    // Solve against the identity for every column of the inverse
+    std::vector<double> identity((long long) n * n, 0);
+    for(int i = 0; i < n; i++) identity[(long long) i * n + i] = 1;
+    luSolve(n, work.data(), perm.data(), n, identity.data());
+    inverted.swap(identity);
+    return true;
+}
+
+void UpdatableInverse::rankOneUpdate(double alpha, Vector &u, Vector &v) {
+    // If dimensions don't match display error message
+    if(u.size() != n || v.size() != n) Logger::logInvalidDimensions(fp, n, n, u.getFilePath(), u.size(), v.size());
+    std::vector<double*> inverseRows = rowsOf(n, n, inverted.data()), rows = rowsOf(n, n, a.data());
+    // The update divides by 1 + alpha * v^T * A^-1 * u
+    std::vector<double> w(n), z(n);
+    gemv(n, n, inverseRows.data(), u.values.data(), w.data());
+    gemvTranspose(n, n, inverseRows.data(), v.values.data(), z.data());
+    double projection = alpha * vectorDot(n, v.values.data(), w.data());
+    double capacitance = 1 + projection;
+    if(std::fabs(capacitance) > BREAKDOWN * (1 + std::fabs(projection))) {
+        ger(n, n, alpha, u.values.data(), v.values.data(), rows.data());
+        ger(n, n, -alpha / capacitance, w.data(), z.data(), inverseRows.data());
+        return;
+    }
+    // The changed matrix is close to singular, so invert it from scratch
+    std::vector<double> before = a;
+    ger(n, n, alpha, u.values.data(), v.values.data(), rows.data());
+    recomputed++;
+    if(!invert()) {
+        a.swap(before);
+        Logger::logInvalidInverse(fp);
+    }
+}
+
+void UpdatableInverse::rankUpdate(Matrix &u, Matrix &v) {
+    // If dimensions don't match display error message
+    if(u.m != n || v.m != n || u.n != v.n) Logger::logInvalidDimensions(u.fp, u.m, u.n, v.fp, v.m, v.n);
+    int k = u.n;
+    std::vector<double> left = u.flatten(), right = v.transpose().flatten();
+    // W = A^-1 * U and Z = V^T * A^-1
+    std::vector<double> w((long long) n * k, 0), z((long long) k * n, 0);
+    gemm(n, k, n, inverted.data(), n, left.data(), k, w.data(), k, true);
+    gemm(k, n, n, right.data(), n, inverted.data(), n, z.data(), n, true);
+    // Factor the k x k capacitance I + V^T * W
+    std::vector<double> capacitance((long long) k * k, 0);
+    for(int i = 0; i < k; i++) capacitance[(long long) i * k + i] = 1;
+    gemm(k, k, n, right.data(), n, w.data(), k, capacitance.data(), k, false);
+    double scale = 0;
+    for(long long i = 0; i < (long long) k * k; i++) scale = std::fmax(scale, std::fabs(capacitance[i]));
+    std::vector<int> perm(k);
+    bool stable = luFactor(k, capacitance.data(), perm.data());
+    for(int i = 0; stable && i < k; i++) stable = std::fabs(capacitance[(long long) i * k + i]) > BREAKDOWN * scale;
+    std::vector<double> before = a;
+    gemm(n, n, k, left.data(), k, right.data(), n, a.data(), n, true);
+    if(stable) {
+        // A^-1 -= W * (I + V^T * W)^-1 * Z
+        luSolve(k, capacitance.data(), perm.data(), n, z.data());
+        vectorScale(w.size(), -1, w.data());
+        gemm(n, n, k, w.data(), k, z.data(), n, inverted.data(), n, true);
+        return;
+    }
+    // The changed matrix is close to singular, so invert it from scratch
+    recomputed++;
+    if(!invert()) {
+        a.swap(before);
+        Logger::logInvalidInverse(fp);
+    }
+}
+
+void UpdatableInverse::replaceRow(int row, Vector &values) {
+    if(row < 1 || row > n) Logger::logInvalidRow(row, fp);
+    if(values.size() != n) Logger::logInvalidDimensions(fp, n, n, values.getFilePath(), 1, values.size());
+    // Add the difference to the row, e_row * (values - A[row])^T
+    Vector unit(n), difference = values;
+    unit.values[row - 1] = 1;
+    vectorAxpy(n, -1, a.data() + (long long) (row - 1) * n, difference.values.data());
+    rankOneUpdate(1, unit, difference);
+}
+
+void UpdatableInverse::replaceColumn(int column, Vector &values) {
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    if(values.size() != n) Logger::logInvalidDimensions(fp, n, n, values.getFilePath(), values.size(), 1);
+    // Add the difference to the column, (values - A[column]) * e_column^T
+    Vector unit(n), difference = values;
+    unit.values[column - 1] = 1;
+    for(int i = 0; i < n; i++) difference.values[i] -= a[(long long) i * n + column - 1];
+    rankOneUpdate(1, difference, unit);
+}
+
+Matrix UpdatableInverse::matrix() {
+    return Matrix(fp, n, n, a);
+}
+
+Matrix UpdatableInverse::inverse() {
+    return Matrix(fp, n, n, inverted);
+}
+
+int UpdatableInverse::refactorizations() {
+    return recomputed;
+}
+
+//////////////////////////////////////////
+//  Rank one LU updates
+//////////////////////////////////////////
+
+UpdatableLU::UpdatableLU(Matrix &matrix) {
+    if(matrix.m != matrix.n) Logger::logInvalidLUDecomposition(matrix.fp);
+    fp = matrix.fp;
+    n = matrix.n;
+    a = matrix.flatten();
+    perm.resize(n);
+    refactored = 0;
+    if(!refactor()) Logger::logInvalidLUDecomposition(fp);
+}
+
+bool UpdatableLU::refactor() {
+    lu = a;
+    return luFactor(n, lu.data(), perm.data());
+}
+
+void UpdatableLU::rankOneUpdate(double alpha, Vector &x, Vector &y) {
+    // If dimensions don't match display error message
+    if(x.size() != n || y.size() != n) Logger::logInvalidDimensions(fp, n, n, x.getFilePath(), x.size(), y.size());
+    // P * (A + alpha * x * y^T) = L * U + u * v^T with u = alpha * P * x
+    std::vector<double> u(n), v = y.values;
+    for(int i = 0; i < n; i++) u[i] = alpha * x.values[perm[i]];
+    // Bennett's algorithm peels one row of U and one column of L off at a time,
+    // leaving a rank one update of the trailing factors
+    bool stable = true;
+    for(int k = 0; k < n && stable; k++) {
+        double *rowK = lu.data() + (long long) k * n;
+        double change = u[k] * v[k];
+        double pivot = rowK[k] + change;
+        if(!(std::fabs(pivot) > BREAKDOWN * (std::fabs(rowK[k]) + std::fabs(change)))) {
+            stable = false;
+            break;
+        }
+        rowK[k] = pivot;
+        double beta = v[k] / pivot;
+        for(int j = k + 1; j < n; j++) {
+            rowK[j] += u[k] * v[j];
+            v[j] -= beta * rowK[j];
+        }
+        for(int i = k + 1; i < n; i++) {
+            double &multiplier = lu[(long long) i * n + k];
+            u[i] -= u[k] * multiplier;
+            multiplier += beta * u[i];
+            if(!(std::fabs(multiplier) <= GROWTH)) stable = false;
+        }
+    }
+    std::vector<double> before;
+    if(!stable) before = a;
+    std::vector<double*> rows = rowsOf(n, n, a.data());
+    ger(n, n, alpha, x.values.data(), y.values.data(), rows.data());
+    if(stable) return;
+    // A small pivot or large multiplier means the old row order no longer suits the matrix
+    refactored++;
+    if(!refactor()) {
+        a.swap(before);
+        refactor();
+        Logger::logInvalidLUDecomposition(fp);
+    }
+}
+
+void UpdatableLU::replaceRow(int row, Vector &values) {
+    if(row < 1 || row > n) Logger::logInvalidRow(row, fp);
+    if(values.size() != n) Logger::logInvalidDimensions(fp, n, n, values.getFilePath(), 1, values.size());
+    Vector unit(n), difference = values;
+    unit.values[row - 1] = 1;
+    vectorAxpy(n, -1, a.data() + (long long) (row - 1) * n, difference.values.data());
+    rankOneUpdate(1, unit, difference);
+}
+
+void UpdatableLU::replaceColumn(int column, Vector &values) {
+    if(column < 1 || column > n) Logger::logInvalidColumn(column, fp);
+    if(values.size() != n) Logger::logInvalidDimensions(fp, n, n, values.getFilePath(), values.size(), 1);
+    Vector unit(n), difference = values;
+    unit.values[column - 1] = 1;
+    for(int i = 0; i < n; i++) difference.values[i] -= a[(long long) i * n + column - 1];
+    rankOneUpdate(1, difference, unit);
+}
+
+Matrix UpdatableLU::solve(Matrix &b) {
+    if(b.m != n) Logger::logInvalidDimensions(fp, n, n, b.fp, b.m, b.n);
+    std::vector<double> x = b.flatten();
+    luSolve(n, lu.data(), perm.data(), b.n, x.data());
+    return Matrix(fp, n, b.n, x);
+}
+
+Matrix UpdatableLU::matrix() {
+    return Matrix(fp, n, n, a);
+}
+
+std::vector<Matrix> UpdatableLU::factors() {
+    // Split the packed factors into L, U and P
+    std::vector<double> L((long long) n * n, 0), U((long long) n * n, 0), P((long long) n * n, 0);
+    for(int i = 0; i < n; i++) {
+        L[(long long) i * n + i] = 1;
+        P[(long long) i * n + perm[i]] = 1;
+        for(int j = 0; j < n; j++) (j < i ? L : U)[(long long) i * n + j] = lu[(long long) i * n + j];
+    }
+    return {Matrix(fp, n, n, L), Matrix(fp, n, n, U), Matrix(fp, n, n, P)};
+}
+
+int UpdatableLU::refactorizations() {
+    return refactored;
+}
+
+//////////////////////////////////////////
+//  Cholesky updates and downdates
+//////////////////////////////////////////
+
+UpdatableCholesky::UpdatableCholesky(Matrix &matrix) {
+    if(matrix.m != matrix.n) Logger::logInvalidCholesky(matrix.fp);
+    fp = matrix.fp;
+    n = matrix.n;
+    a = matrix.flatten();
+    refactored = 0;
+    if(!isSymmetric(n, a.data()) || !refactor()) Logger::logInvalidCholesky(fp);
+}
+
+bool UpdatableCholesky::refactor() {
+    std::vector<double> lower = a;
+    if(!choleskyFactor(n, lower.data())) return false;
+    upper.assign((long long) n * n, 0);
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j <= i; j++) upper[(long long) j * n + i] = lower[(long long) i * n + j];
+    return true;
+}
+
+bool UpdatableCholesky::rotate(double sign, std::vector<double> x) {
+    // Each rotation folds one value of x into the diagonal and sweeps the rest along the row
+    for(int k = 0; k < n; k++) {
+        double *rowK = upper.data() + (long long) k * n;
+        double diagonal = rowK[k];
+        double squared = diagonal * diagonal + sign * x[k] * x[k];
+        if(!(squared > BREAKDOWN * diagonal * diagonal)) return false;
+        double radius = std::sqrt(squared);
+        double c = radius / diagonal, s = x[k] / diagonal;
+        rowK[k] = radius;
+        for(int j = k + 1; j < n; j++) {
+            rowK[j] = (rowK[j] + sign * s * x[j]) / c;
+            x[j] = c * x[j] - s * rowK[j];
+        }
+    }
+    return true;
+}
+
+void UpdatableCholesky::change(double sign, Vector &x) {
+    // If dimensions don't match display error message
+    if(x.size() != n) Logger::logInvalidDimensions(fp, n, n, x.getFilePath(), x.size(), 1);
+    // Keep the old values to restore if the changed matrix cannot be factored
+    std::vector<double> before = a;
+    std::vector<double*> rows = rowsOf(n, n, a.data());
+    ger(n, n, sign, x.values.data(), x.values.data(), rows.data());
+    if(rotate(sign, x.values)) return;
+    // The rotations lost a pivot, so factor the changed matrix from scratch
+    refactored++;
+    if(!refactor()) {
+        a.swap(before);
+        refactor();
+        Logger::logInvalidCholesky(fp);
+    }
+}
+
+void UpdatableCholesky::update(Vector &x) {
+    change(1, x);
+}
+
+void UpdatableCholesky::downdate(Vector &x) {
+    change(-1, x);
+}
+
+Matrix UpdatableCholesky::solve(Matrix &b) {
+    if(b.m != n) Logger::logInvalidDimensions(fp, n, n, b.fp, b.m, b.n);
+    int r = b.n;
+    std::vector<double> x = b.flatten();
+    // Forward substitute L * Y = B, using each row of L^T as a column of L
+    for(int k = 0; k < n; k++) {
+        const double *rowK = upper.data() + (long long) k * n;
+        double *rowB = x.data() + (long long) k * r;
+        vectorScale(r, 1 / rowK[k], rowB);
+        for(int i = k + 1; i < n; i++) vectorAxpy(r, -rowK[i], rowB, x.data() + (long long) i * r);
+    }
+    // Back substitute L^T * X = Y
+    for(int i = n - 1; i >= 0; i--) {
+        const double *rowI = upper.data() + (long long) i * n;
+        double *rowB = x.data() + (long long) i * r;
+        for(int j = i + 1; j < n; j++) vectorAxpy(r, -rowI[j], x.data() + (long long) j * r, rowB);
+        vectorScale(r, 1 / rowI[i], rowB);
+    }
+    return Matrix(fp, n, r, x);
+}
+
+Matrix UpdatableCholesky::matrix() {
+    return Matrix(fp, n, n, a);
+}
+
+Matrix UpdatableCholesky::factor() {
+    std::vector<double> lower((long long) n * n, 0);
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j <= i; j++) lower[(long long) i * n + j] = upper[(long long) j * n + i];
+    return Matrix(fp, n, n, lower);
+}
+
+int UpdatableCholesky::refactorizations() {
+    return refactored;
+}
+
+//////////////////////////////////////////
+//  QR row insertion and deletion
+//////////////////////////////////////////
+
+UpdatableQR::UpdatableQR(Matrix &matrix) {
+    fp = matrix.fp;
+    m = matrix.m;
+    n = matrix.n;
+    std::vector<double> work = matrix.flatten();
+    std::vector<double> tau(std::min(m, n));
+    qrFactor(m, n, work.data(), tau.data());
+    // Form the full Q by applying the reflectors to the identity
+    q.assign((long long) m * m, 0);
+    for(int i = 0; i < m; i++) q[(long long) i * m + i] = 1;
+    qrApply(m, n, work.data(), tau.data(), m, q.data());
+    // R is the upper triangle of the factored matrix
+    r.assign((long long) m * n, 0);
+    for(int i = 0; i < m; i++)
+        for(int j = i; j < n; j++) r[(long long) i * n + j] = work[(long long) i * n + j];
+}
+
+void UpdatableQR::insertRow(int row, Vector &values) {
+    if(row < 1 || row > m + 1) Logger::logInvalidRow(row, fp);
+    if(values.size() != n) Logger::logInvalidDimensions(fp, m, n, values.getFilePath(), 1, values.size());
+    // Append the row to R and border Q with a one, then rotate the row into R
+    int size = m + 1;
+    r.insert(r.end(), values.values.begin(), values.values.end());
+    std::vector<double> bordered((long long) size * size, 0);
+    for(int i = 0; i < m; i++) std::copy(q.begin() + (long long) i * m, q.begin() + (long long) (i + 1) * m, bordered.begin() + (long long) i * size);
+    bordered[(long long) m * size + m] = 1;
+    for(int j = 0; j < std::min(m, n); j++) {
+        double c, s;
+        double *rowJ = r.data() + (long long) j * n, *last = r.data() + (long long) m * n;
+        givens(rowJ[j], last[j], c, s);
+        for(int col = j; col < n; col++) {
+            double top = rowJ[col], bottom = last[col];
+            rowJ[col] = c * top + s * bottom;
+            last[col] = c * bottom - s * top;
+        }
+        last[j] = 0;
+        for(int i = 0; i < size; i++) {
+            double &left = bordered[(long long) i * size + j], &right = bordered[(long long) i * size + m];
+            double value = left;
+            left = c * value + s * right;
+            right = c * right - s * value;
+        }
+    }
+    // Move the new row of Q from the end to its place
+    std::rotate(bordered.begin() + (long long) (row - 1) * size, bordered.begin() + (long long) m * size, bordered.end());
+    q.swap(bordered);
+    m = size;
+}
+
+void UpdatableQR::deleteRow(int row) {
+    if(row < 1 || row > m || m == 1) Logger::logInvalidRow(row, fp);
+    // Move the row of Q to the top, then rotate that row into a multiple of e1
+    std::rotate(q.begin(), q.begin() + (long long) (row - 1) * m, q.begin() + (long long) row * m);
+    for(int j = m - 2; j >= 0; j--) {
+        double c, s;
+        givens(q[j], q[j + 1], c, s);
+        for(int i = 0; i < m; i++) {
+            double &left = q[(long long) i * m + j], &right = q[(long long) i * m + j + 1];
+            double value = left;
+            left = c * value + s * right;
+            right = c * right - s * value;
+        }
+        double *rowJ = r.data() + (long long) j * n, *next = rowJ + n;
+        for(int col = 0; col < n; col++) {
+            double top = rowJ[col], bottom = next[col];
+            rowJ[col] = c * top + s * bottom;
+            next[col] = c * bottom - s * top;
+        }
+    }
+    // The first row and column of Q are now +-e1, and the rows of R below the first are triangular
+    int size = m - 1;
+    std::vector<double> trimmed((long long) size * size);
+    for(int i = 0; i < size; i++)
+        std::copy(q.begin() + (long long) (i + 1) * m + 1, q.begin() + (long long) (i + 2) * m, trimmed.begin() + (long long) i * size);
+    q.swap(trimmed);
+    r.erase(r.begin(), r.begin() + n);
+    // Clear the rounding left below the diagonal
+    for(int i = 0; i < size; i++)
+        for(int j = 0; j < std::min(i, n); j++) r[(long long) i * n + j] = 0;
+    m = size;
+}
+
+int UpdatableQR::rows() {
+    return m;
+}
+
+int UpdatableQR::columns() {
+    return n;
+}
+
+Matrix UpdatableQR::matrix() {
+    std::vector<double> product((long long) m * n, 0);
+    gemm(m, n, m, q.data(), m, r.data(), n, product.data(), n, true);
+    return Matrix(fp, m, n, product);
+}
+
+std::vector<Matrix> UpdatableQR::factors() {
+    return {Matrix(fp, m, m, q), Matrix(fp, m, n, r)};
+}
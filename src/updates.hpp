@@ -0,0 +1,343 @@
+#include<string>
+#include<vector>
+#include"matrix.hpp"
+#include"vector.hpp"
+#ifndef UPDATES_HPP
+#define UPDATES_HPP
+
+/**
+ * @brief The inverse of an NxN matrix kept current through low rank changes to
+ * the matrix with the Sherman-Morrison-Woodbury formula, in O(N^2) work per
+ * rank instead of the O(N^3) of inverting again. When an update would divide by
+ * a nearly singular capacitance the inverse is recomputed from the changed matrix
+ *
+ */
+class UpdatableInverse {
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int n;
+    /** The matrix and its inverse, row by row */
+    std::vector<double> a, inverted;
+    /** Number of times the inverse was recomputed from scratch */
+    int recomputed;
+
+    /**
+     * @brief Inverts the matrix from scratch, returning false if it is singular
+     */
+    bool invert();
+
+    public:
+    /**
+     * @brief Inverts an NxN matrix with a pivoted LU decomposition
+     *
+     * @param matrix matrix to invert
+     */
+    UpdatableInverse(Matrix &matrix);
+
+    /**
+     * @brief Applies A += alpha * u * v^T and updates the inverse with the
+     * Sherman-Morrison formula
+     *
+     * @param alpha scale applied to the update
+     * @param u vector with N values
+     * @param v vector with N values
+     */
+    void rankOneUpdate(double alpha, Vector &u, Vector &v);
+
+    /**
+     * @brief Applies A += U * V^T and updates the inverse with the Woodbury formula,
+     * which only inverts a k x k matrix
+     *
+     * @param u matrix with N rows and k columns
+     * @param v matrix with N rows and k columns
+     */
+    void rankUpdate(Matrix &u, Matrix &v);
+
+    /**
+     * @brief Replaces one row of the matrix, a rank one update
+     *
+     * @param row row to replace
+     * @param values the N new values of the row
+     */
+    void replaceRow(int row, Vector &values);
+
+    /**
+     * @brief Replaces one column of the matrix, a rank one update
+     *
+     * @param column column to replace
+     * @param values the N new values of the column
+     */
+    void replaceColumn(int column, Vector &values);
+
+    /**
+     * @brief Returns the current matrix
+     *
+     * @return Matrix the NxN matrix with every update applied
+     */
+    Matrix matrix();
+
+    /**
+     * @brief Returns the inverse of the current matrix
+     *
+     * @return Matrix the NxN inverse
+     */
+    Matrix inverse();
+
+    /**
+     * @brief Returns how many updates fell back to inverting from scratch
+     *
+     * @return int number of recomputed inverses
+     */
+    int refactorizations();
+};
+
+/**
+ * @brief The LU decomposition P * A = L * U of an NxN matrix kept current through
+ * rank one changes with Bennett's algorithm in O(N^2) work. The update keeps the
+ * row order of the original pivoting, so when a pivot shrinks to almost nothing
+ * the matrix is factored again from scratch with fresh pivots
+ *
+ */
+class UpdatableLU {
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int n;
+    /** The matrix row by row */
+    std::vector<double> a;
+    /** Unit lower factor below the diagonal and upper factor on and above it */
+    std::vector<double> lu;
+    /** Row i of P * A is row perm[i] of A */
+    std::vector<int> perm;
+    /** Number of times the matrix was factored from scratch */
+    int refactored;
+
+    /**
+     * @brief Factors the matrix from scratch, returning false if it is singular
+     */
+    bool refactor();
+
+    public:
+    /**
+     * @brief Factors an NxN matrix with partial pivoting
+     *
+     * @param matrix matrix to factor
+     */
+    UpdatableLU(Matrix &matrix);
+
+    /**
+     * @brief Applies A += alpha * x * y^T and updates the factors
+     *
+     * @param alpha scale applied to the update
+     * @param x vector with N values
+     * @param y vector with N values
+     */
+    void rankOneUpdate(double alpha, Vector &x, Vector &y);
+
+    /**
+     * @brief Replaces one row of the matrix, a rank one update
+     *
+     * @param row row to replace
+     * @param values the N new values of the row
+     */
+    void replaceRow(int row, Vector &values);
+
+    /**
+     * @brief Replaces one column of the matrix, a rank one update
+     *
+     * @param column column to replace
+     * @param values the N new values of the column
+     */
+    void replaceColumn(int column, Vector &values);
+
+    /**
+     * @brief Solves A * X = B with the current factors
+     *
+     * @param b right hand sides with N rows
+     * @return Matrix the solution X
+     */
+    Matrix solve(Matrix &b);
+
+    /**
+     * @brief Returns the current matrix
+     *
+     * @return Matrix the NxN matrix with every update applied
+     */
+    Matrix matrix();
+
+    /**
+     * @brief Returns the current factors
+     *
+     * @return std::vector<Matrix> Vector containing the Lower(index0), Upper(index1) and Permutation(index2) matrices
+     */
+    std::vector<Matrix> factors();
+
+    /**
+     * @brief Returns how many updates fell back to factoring from scratch
+     *
+     * @return int number of refactorizations
+     */
+    int refactorizations();
+};
+
+/**
+ * @brief The Cholesky decomposition A = L * L^T of a positive definite matrix
+ * kept current through updates A + x * x^T and downdates A - x * x^T, each a
+ * sweep of plane rotations in O(N^2) work. A downdate that loses positive
+ * definiteness in the rotations is retried by factoring from scratch
+ *
+ */
+class UpdatableCholesky {
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int n;
+    /** The matrix row by row */
+    std::vector<double> a;
+    /** The transpose L^T row by row, so each rotation sweeps along a row */
+    std::vector<double> upper;
+    /** Number of times the matrix was factored from scratch */
+    int refactored;
+
+    /**
+     * @brief Factors the matrix from scratch, returning false if it is not positive definite
+     */
+    bool refactor();
+
+    /**
+     * @brief Applies A + sign * x * x^T to the factor, returning false if a pivot is lost
+     */
+    bool rotate(double sign, std::vector<double> x);
+
+    /**
+     * @brief Applies A + sign * x * x^T to the matrix and its factor
+     */
+    void change(double sign, Vector &x);
+
+    public:
+    /**
+     * @brief Factors a symmetric positive definite NxN matrix
+     *
+     * @param matrix matrix to factor
+     */
+    UpdatableCholesky(Matrix &matrix);
+
+    /**
+     * @brief Applies A += x * x^T and updates the factor
+     *
+     * @param x vector with N values
+     */
+    void update(Vector &x);
+
+    /**
+     * @brief Applies A -= x * x^T and updates the factor. The matrix must stay
+     * positive definite, otherwise it is left unchanged
+     *
+     * @param x vector with N values
+     */
+    void downdate(Vector &x);
+
+    /**
+     * @brief Solves A * X = B with the current factor
+     *
+     * @param b right hand sides with N rows
+     * @return Matrix the solution X
+     */
+    Matrix solve(Matrix &b);
+
+    /**
+     * @brief Returns the current matrix
+     *
+     * @return Matrix the NxN matrix with every update applied
+     */
+    Matrix matrix();
+
+    /**
+     * @brief Returns the current lower factor L
+     *
+     * @return Matrix the NxN lower factor
+     */
+    Matrix factor();
+
+    /**
+     * @brief Returns how many downdates fell back to factoring from scratch
+     *
+     * @return int number of refactorizations
+     */
+    int refactorizations();
+};
+
+/**
+ * @brief The full QR decomposition A = Q * R of an MxN matrix kept current as
+ * rows are inserted and deleted, each change a sweep of Givens rotations in
+ * O(M^2 + MN) work. Rotations are orthogonal, so the updates cannot break down
+ *
+ */
+class UpdatableQR {
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Number of rows and columns */
+    int m, n;
+    /** The orthogonal M x M factor row by row */
+    std::vector<double> q;
+    /** The upper triangular M x N factor row by row */
+    std::vector<double> r;
+
+    public:
+    /**
+     * @brief Factors an MxN matrix with Householder reflections
+     *
+     * @param matrix matrix to factor
+     */
+    UpdatableQR(Matrix &matrix);
+
+    /**
+     * @brief Inserts a row so that it becomes the given row of the matrix
+     *
+     * @param row position of the new row, from 1 to M + 1
+     * @param values the N values of the row
+     */
+    void insertRow(int row, Vector &values);
+
+    /**
+     * @brief Deletes a row of the matrix
+     *
+     * @param row row to delete
+     */
+    void deleteRow(int row);
+
+    /**
+     * @brief Returns the number of rows
+     *
+     * @return int number of rows
+     */
+    int rows();
+
+    /**
+     * @brief Returns the number of columns
+     *
+     * @return int number of columns
+     */
+    int columns();
+
+    /**
+     * @brief Returns the current matrix, rebuilt as Q * R
+     *
+     * @return Matrix the MxN matrix
+     */
+    Matrix matrix();
+
+    /**
+     * @brief Returns the current factors
+     *
+     * @return std::vector<Matrix> Vector containing the Orthonormal(index0) M x M and Upper(index1) M x N matrices
+     */
+    std::vector<Matrix> factors();
+};
+
+#endif
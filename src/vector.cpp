@@ -0,0 +1,151 @@
+#include<string>
+#include<vector>
+#include<utility>
+#include"vector.hpp"
+#include"kernels.hpp"
+
+//////////////////////////////////////////
+//  Importing/Exporting Vector objects
+//////////////////////////////////////////
+
+Vector::Vector(std::string filepath, std::vector<double> vals) {
+    // Store the vector's filepath and values
+    fp = filepath;
+    values = vals;
+}
+
+Vector::Vector(std::string filepath) {
+    // Log the creation of the Vector with its filepath identifier
+    Logger::getInstance()->log("Creating a Vector from the filepath: " + filepath);
+    fp = filepath;
+    // Read the file as a matrix and make sure it has a single row or column
+    int m, n;
+    std::vector<std::vector<double>> grid;
+    readMtx(fp, m, n, grid);
+    if(m != 1 && n != 1) Logger::logInvalidVector(fp, m, n);
+    // Copy the values in order
+    for(int i = 0; i < m; i++)
+        for(int j = 0; j < n; j++) values.push_back(grid[i][j]);
+}
+
+Vector::Vector(int size) {
+    // Initialize a vector of zeros
+    fp = "vector";
+    values.assign(size, 0);
+}
+
+Vector::Vector(Matrix &matrix) {
+    // The matrix must have a single row or column
+    fp = matrix.fp;
+    if(matrix.m != 1 && matrix.n != 1) Logger::logInvalidVector(fp, matrix.m, matrix.n);
+    // Copy the values in order
+    for(int i = 0; i < matrix.m; i++)
+        for(int j = 0; j < matrix.n; j++) values.push_back(matrix.matrix[i][j]);
+}
+
+Matrix Vector::toMatrix() {
+    // Build a single column matrix from the values
+    std::vector<std::vector<double>> vals(values.size(), std::vector<double>(1));
+    for(int i = 0; i < values.size(); i++) vals[i][0] = values[i];
+    return Matrix(fp, std::move(vals));
+}
+
+void Vector::save(std::string filename) {
+    // Write the vector as a single column matrix
+    toMatrix().save(filename);
+}
+
+//////////////////////////////////////////
+//  Accessors for Vector objects
+//////////////////////////////////////////
+
+int Vector::size() {
+    // Return the number of values
+    return values.size();
+}
+
+double Vector::access(int index) {
+    // Check the bounds of the index
+    if(index < 1 || index > values.size()) Logger::logInvalidRow(index, fp);
+    // Return the value at the index
+    return values[index - 1];
+}
+
+void Vector::set(int index, double value) {
+    // Check the bounds of the index
+    if(index < 1 || index > values.size()) Logger::logInvalidRow(index, fp);
+    // Store the value at the index
+    values[index - 1] = value;
+}
+
+std::string Vector::getFilePath() {
+    // Returns the file path for the vector
+    return fp;
+}
+
+//////////////////////////////////////////
+//  Operations for Vector objects
+//////////////////////////////////////////
+
+double Vector::dot(Vector &other) {
+    // If sizes don't match display error message
+    if(values.size() != other.values.size()) Logger::logInvalidDimensions(fp, 1, values.size(), other.fp, other.values.size(), 1);
+    return vectorDot(values.size(), values.data(), other.values.data());
+}
+
+void Vector::axpy(double alpha, Vector &x) {
+    // If sizes don't match display error message
+    if(values.size() != x.values.size()) Logger::logInvalidDimensions(fp, values.size(), 1, x.fp, x.values.size(), 1);
+    vectorAxpy(values.size(), alpha, x.values.data(), values.data());
+}
+
+void Vector::scal(double alpha) {
+    vectorScale(values.size(), alpha, values.data());
+}
+
+double Vector::nrm2() {
+    return vectorNorm(values.size(), values.data());
+}
+
+Vector Vector::operator*(Matrix &other) {
+    // If dimensions don't match display error message
+    if(values.size() != other.m) Logger::logInvalidDimensions(fp, 1, values.size(), other.fp, other.m, other.n);
+    // Gather the row pointers of the matrix for the kernel
+    std::vector<const double*> rows(other.m);
+    for(int i = 0; i < other.m; i++) rows[i] = other.matrix[i].data();
+    // Compute A^T * x which is the row vector x^T * A
+    std::vector<double> result(other.n);
+    gemvTranspose(other.m, other.n, rows.data(), values.data(), result.data());
+    return Vector(fp, result);
+}
+
+Vector Vector::operator*(double val) {
+    // Scale a copy of the vector
+    Vector result = *this;
+    result.scal(val);
+    return result;
+}
+
+Vector Vector::operator+(Vector &other) {
+    // Add the other vector into a copy of this one
+    Vector result = *this;
+    result.axpy(1, other);
+    return result;
+}
+
+Vector Vector::operator-(Vector &other) {
+    // Subtract the other vector from a copy of this one
+    Vector result = *this;
+    result.axpy(-1, other);
+    return result;
+}
+
+bool Vector::operator==(Vector &other) {
+    // Vectors are equal when they hold the same values
+    return values == other.values;
+}
+
+bool Vector::operator!=(Vector &other) {
+    // Return the opposite of equal
+    return !(*this == other);
+}
@@ -0,0 +1,184 @@
+#include<string>
+#include<vector>
+#include"matrix.hpp"
+#ifndef VECTOR_HPP
+#define VECTOR_HPP
+
+/**
+ * @brief A class representing a dense vector stored contiguously, with the
+ * BLAS level one operations used by iterative methods
+ *
+ */
+class Vector {
+    friend class Matrix;
+    friend class BandedMatrix;
+    friend class TridiagonalMatrix;
+    friend class SparseMatrix;
+    friend class KrylovSolver;
+    friend class UpdatableInverse;
+    friend class UpdatableLU;
+    friend class UpdatableCholesky;
+    friend class UpdatableQR;
+
+    private:
+    /** Filepointer used as identifier for logging */
+    std::string fp;
+    /** Underlying contiguous values of the vector */
+    std::vector<double> values;
+
+    /**
+     * @brief Special constructor for building a vector from given values
+     *
+     * @param filepath filepath identifer for the vector
+     * @param vals values to populate the vector with
+     */
+    Vector(std::string filepath, std::vector<double> vals);
+
+    public:
+    /**
+     * @brief Constructs a vector from an mtx file holding a single row or column
+     *
+     * @param filepath filepath to the mtx file
+     */
+    Vector(std::string filepath);
+
+    /**
+     * @brief Constructs a vector of zeros
+     *
+     * @param size number of values in the vector
+     */
+    Vector(int size);
+
+    /**
+     * @brief Constructs a vector from a Matrix with a single row or column
+     *
+     * @param matrix matrix to copy values from
+     */
+    Vector(Matrix &matrix);
+
+    /**
+     * @brief Returns the number of values in the vector
+     *
+     * @return int number of values
+     */
+    int size();
+
+    /**
+     * @brief Returns the value at a given index
+     *
+     * @param index index of the value, starting from 1
+     * @return double value at the index
+     */
+    double access(int index);
+
+    /**
+     * @brief Sets the value at a given index
+     *
+     * @param index index of the value, starting from 1
+     * @param value value to store
+     */
+    void set(int index, double value);
+
+    /**
+     * @brief Returns the filepath identifer of the Vector
+     *
+     * @return std::string containing the filepath
+     */
+    std::string getFilePath();
+
+    /**
+     * @brief Returns the vector as a single column Matrix
+     *
+     * @return Matrix an n x 1 matrix of the values
+     */
+    Matrix toMatrix();
+
+    /**
+     * @brief Exports the vector as a single column mtx file
+     *
+     * @param filename filename to save vector as
+     */
+    void save(std::string filename);
+
+    /**
+     * @brief Returns the dot product with another vector
+     *
+     * @param other vector of the same size
+     * @return double sum of the elementwise products
+     */
+    double dot(Vector &other);
+
+    /**
+     * @brief Adds a scaled vector to this one in place, this += alpha * x
+     *
+     * @param alpha scale applied to x
+     * @param x vector of the same size
+     */
+    void axpy(double alpha, Vector &x);
+
+    /**
+     * @brief Scales the vector in place
+     *
+     * @param alpha scale to apply
+     */
+    void scal(double alpha);
+
+    /**
+     * @brief Returns the Euclidean norm of the vector
+     *
+     * @return double the two norm
+     */
+    double nrm2();
+
+    /**
+     * @brief Overload multiplication to multiply a row vector by a Matrix, x^T * A
+     *
+     * @param other matrix with as many rows as the vector has values
+     * @return Vector the product as a vector
+     */
+    Vector operator*(Matrix &other);
+
+    /**
+     * @brief Overload multiplication to scale a Vector
+     *
+     * @param val scalar value to multiply by
+     * @return Vector the scaled vector
+     */
+    Vector operator*(double val);
+
+    /**
+     * @brief Overload addition operator to add Vectors together
+     *
+     * @param other vector being added with
+     * @return Vector containing the result of addition
+     */
+    Vector operator+(Vector &other);
+
+    /**
+     * @brief Overload subtraction operator to subtract Vectors
+     *
+     * @param other vector being subtracted
+     * @return Vector containing the result of subtraction
+     */
+    Vector operator-(Vector &other);
+
+    /**
+     * @brief Overload equals operator to compare Vector contents
+     *
+     * @param other vector being compared with
+     * @return true if vector values are equal
+     * @return false if vector values are not equal
+     */
+    bool operator==(Vector &other);
+
+    /**
+     * @brief Overload not equals operator to compare Vector contents
+     *
+     * @param other vector being compared with
+     * @return true if vector values are not equal
+     * @return false if vector values are equal
+     */
+    bool operator!=(Vector &other);
+};
+
+#endif